@@ -1123,23 +1123,6 @@ static void CG_BuildableStatusDisplay(centity_t * cent)
 	}
 }
 
-static int QDECL CG_SortDistance(const void *a, const void *b)
-{
-	centity_t *aent, *bent;
-	float adist, bdist;
-
-	aent = &cg_entities[*(int *)a];
-	bent = &cg_entities[*(int *)b];
-	adist = Distance(cg.refdef.vieworg, aent->lerpOrigin);
-	bdist = Distance(cg.refdef.vieworg, bent->lerpOrigin);
-	if (adist > bdist)
-		return -1;
-	else if (adist < bdist)
-		return 1;
-	else
-		return 0;
-}
-
 /*
 ==================
 CG_DrawBuildableStatus
@@ -1150,8 +1133,10 @@ void CG_DrawBuildableStatus(void)
 	int i;
 	centity_t *cent;
 	entityState_t *es;
-	int buildableList[MAX_ENTITIES_IN_SNAPSHOT];
+	sortItem_t buildableList[MAX_ENTITIES_IN_SNAPSHOT];
+	sortItem_t temp[MAX_ENTITIES_IN_SNAPSHOT];
 	int buildables = 0;
+	float distance;
 
 	switch (cg.predictedPlayerState.weapon) {
 	case WP_ABUILD:
@@ -1162,17 +1147,26 @@ void CG_DrawBuildableStatus(void)
 			cent = &cg_entities[cg.snap->entities[i].number];
 			es = &cent->currentState;
 
-			if (es->eType == ET_BUILDABLE &&
-			    BG_FindTeamForBuildable(es->modelindex) ==
+			if (es->eType != ET_BUILDABLE ||
+			    BG_FindTeamForBuildable(es->modelindex) !=
 			    BG_FindTeamForWeapon(cg.predictedPlayerState.
 						 weapon))
-				buildableList[buildables++] =
-				    cg.snap->entities[i].number;
+				continue;
+
+			// furthest first, so the nearest are drawn on top.  The
+			// bits of a positive float sort the same as its value,
+			// and ~ reverses them.
+			distance = DistanceSquared(cg.refdef.vieworg,
+						   cent->lerpOrigin);
+			buildableList[buildables].key = ~*(int *)&distance;
+			buildableList[buildables].value =
+			    cg.snap->entities[i].number;
+			buildables++;
 		}
-		qsort(buildableList, buildables, sizeof(int), CG_SortDistance);
+		Q_SortItems(buildableList, temp, buildables);
 		for (i = 0; i < buildables; i++)
 			CG_BuildableStatusDisplay(&cg_entities
-						  [buildableList[i]]);
+						  [buildableList[i].value]);
 		break;
 
 	default:
@@ -181,6 +181,7 @@ vmCvar_t cg_predictItems;
 vmCvar_t cg_deferPlayers;
 vmCvar_t cg_drawTeamOverlay;
 vmCvar_t cg_teamOverlayUserinfo;
+vmCvar_t cg_scoresMoreUserinfo;
 vmCvar_t cg_drawFriend;
 vmCvar_t cg_teamChatsOnly;
 vmCvar_t cg_noVoiceChats;
@@ -321,6 +322,8 @@ static cvarTable_t cvarTable[] = {
 	{ &cg_drawTeamOverlay, "cg_drawTeamOverlay", "0", CVAR_ARCHIVE },
 	{ &cg_teamOverlayUserinfo, "teamoverlay", "0",
 	 CVAR_ROM | CVAR_USERINFO },
+	{ &cg_scoresMoreUserinfo, "cg_scoresMore", "1",
+	 CVAR_ROM | CVAR_USERINFO },
 	{ &cg_stats, "cg_stats", "0", 0 },
 	{ &cg_drawFriend, "cg_drawFriend", "1", CVAR_ARCHIVE },
 	{ &cg_teamChatsOnly, "cg_teamChatsOnly", "0", CVAR_ARCHIVE },
@@ -70,6 +70,45 @@ static void CG_ParseScores(void)
 	}
 }
 
+/*
+=================
+CG_ParseMoreScores
+
+Scoreboards too long for one "scores" command are continued in "scoresmore"
+=================
+*/
+static void CG_ParseMoreScores(void)
+{
+	int i, n, first;
+
+	first = cg.numScores;
+	n = atoi(CG_Argv(1));
+
+	if (first + n > MAX_CLIENTS)
+		n = MAX_CLIENTS - first;
+
+	for (i = 0; i < n; i++) {
+		score_t *sc = &cg.scores[first + i];
+
+		sc->client = atoi(CG_Argv(i * 6 + 2));
+		sc->score = atoi(CG_Argv(i * 6 + 3));
+		sc->ping = atoi(CG_Argv(i * 6 + 4));
+		sc->time = atoi(CG_Argv(i * 6 + 5));
+		sc->weapon = atoi(CG_Argv(i * 6 + 6));
+		sc->upgrade = atoi(CG_Argv(i * 6 + 7));
+
+		if (sc->client < 0 || sc->client >= MAX_CLIENTS)
+			sc->client = 0;
+
+		cgs.clientinfo[sc->client].score = sc->score;
+		cgs.clientinfo[sc->client].powerups = 0;
+
+		sc->team = cgs.clientinfo[sc->client].team;
+	}
+
+	cg.numScores = first + n;
+}
+
 /*
 =================
 CG_ParseTeamInfo
@@ -903,6 +942,11 @@ static void CG_ServerCommand(void)
 		return;
 	}
 
+	if (!strcmp(cmd, "scoresmore")) {
+		CG_ParseMoreScores();
+		return;
+	}
+
 	if (!strcmp(cmd, "tinfo")) {
 		CG_ParseTeamInfo();
 		return;
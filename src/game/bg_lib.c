@@ -130,17 +130,61 @@ med3(a, b, c, cmp)
               :(cmp(b, c) > 0 ? b : (cmp(a, c) < 0 ? a : c ));
 }
 
-void
-qsort(a, n, es, cmp)
+/*
+ * Heapsort, for partitions that introsort has split too many times.
+ */
+static void
+siftdown(a, root, n, es, cmp, swaptype)
+  char *a;
+  size_t root, n, es;
+  cmp_t *cmp;
+  int swaptype;
+{
+  size_t child;
+
+  while ((child = 2 * root + 1) < n) {
+    if (child + 1 < n && cmp(a + child * es, a + (child + 1) * es) < 0)
+      child++;
+    if (cmp(a + root * es, a + child * es) >= 0)
+      return;
+    swap(a + root * es, a + child * es);
+    root = child;
+  }
+}
+
+static void
+qheapsort(a, n, es, cmp, swaptype)
+  char *a;
+  size_t n, es;
+  cmp_t *cmp;
+  int swaptype;
+{
+  size_t i;
+
+  for (i = n / 2; i > 0; i--)
+    siftdown(a, i - 1, n, es, cmp, swaptype);
+  for (i = n - 1; i > 0; i--) {
+    swap(a, a + i * es);
+    siftdown(a, 0, i, es, cmp, swaptype);
+  }
+}
+
+/*
+ * Introsort: quicksort until depth runs out, then heapsort, so that no
+ * input takes more than n log n compares.  Every compare is an indirect
+ * call in the VM, which is what makes that worth bounding.
+ */
+static void
+introsort(a, n, es, cmp, depth)
   void *a;
   size_t n, es;
   cmp_t *cmp;
+  int depth;
 {
   char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-  int d, r, swaptype, swap_cnt;
+  int d, r, swaptype;
 
 loop: SWAPINIT(a, es);
-  swap_cnt = 0;
   if (n < 7) {
     for (pm = (char *)a + es; pm < (char *)a + n * es; pm += es)
       for (pl = pm; pl > (char *)a && cmp(pl - es, pl) > 0;
@@ -148,6 +192,10 @@ loop: SWAPINIT(a, es);
         swap(pl, pl - es);
     return;
   }
+  if (depth-- <= 0) {
+    qheapsort(a, n, es, cmp, swaptype);
+    return;
+  }
   pm = (char *)a + (n / 2) * es;
   if (n > 7) {
     pl = a;
@@ -167,7 +215,6 @@ loop: SWAPINIT(a, es);
   for (;;) {
     while (pb <= pc && (r = cmp(pb, a)) <= 0) {
       if (r == 0) {
-        swap_cnt = 1;
         swap(pa, pb);
         pa += es;
       }
@@ -175,7 +222,6 @@ loop: SWAPINIT(a, es);
     }
     while (pb <= pc && (r = cmp(pc, a)) >= 0) {
       if (r == 0) {
-        swap_cnt = 1;
         swap(pc, pd);
         pd -= es;
       }
@@ -184,17 +230,9 @@ loop: SWAPINIT(a, es);
     if (pb > pc)
       break;
     swap(pb, pc);
-    swap_cnt = 1;
     pb += es;
     pc -= es;
   }
-  if (swap_cnt == 0) {  /* Switch to insertion sort */
-    for (pm = (char *)a + es; pm < (char *)a + n * es; pm += es)
-      for (pl = pm; pl > (char *)a && cmp(pl - es, pl) > 0;
-           pl -= es)
-        swap(pl, pl - es);
-    return;
-  }
 
   pn = (char *)a + n * es;
   r = min(pa - (char *)a, pb - pa);
@@ -202,14 +240,28 @@ loop: SWAPINIT(a, es);
   r = min(pd - pc, pn - pd - es);
   vecswap(pb, pn - r, r);
   if ((r = pb - pa) > es)
-    qsort(a, r / es, es, cmp);
+    introsort(a, r / es, es, cmp, depth);
   if ((r = pd - pc) > es) {
     /* Iterate rather than recurse to save stack space */
     a = pn - r;
     n = r / es;
     goto loop;
   }
-/*    qsort(pn - r, r / es, es, cmp);*/
+}
+
+void
+qsort(a, n, es, cmp)
+  void *a;
+  size_t n, es;
+  cmp_t *cmp;
+{
+  size_t i;
+  int depth = 0;
+
+  for (i = n; i > 1; i >>= 1)
+    depth += 2;
+
+  introsort(a, n, es, cmp, depth);
 }
 
 //==================================================================================
@@ -217,16 +269,31 @@ loop: SWAPINIT(a, es);
 
 // this file is excluded from release builds because of intrinsics
 
+// Strings are scanned and copied a word at a time once they're aligned, as
+// each bytecode op costs far more than the work it does.  A word has a zero
+// byte in it if HASZERO is non-zero.
+#define HASZERO( x )  ( ( ( x ) - 0x01010101U ) & ~( x ) & 0x80808080U )
+#define ALIGNED( p )  ( !( (int)( p ) & 3 ) )
+
 // bk001211 - gcc errors on compiling strcpy:  parse error before `__extension__'
 #if defined ( Q3_VM )
 
 size_t strlen( const char *string )
 {
-  const char  *s;
+  const char          *s;
+  const unsigned int  *w;
+
+  for( s = string; !ALIGNED( s ); s++ )
+  {
+    if( !*s )
+      return s - string;
+  }
 
-  s = string;
-  while( *s )
-    s++;
+  for( w = (const unsigned int *)s; !HASZERO( *w ); w++ )
+    ;
+
+  for( s = (const char *)w; *s; s++ )
+    ;
 
   return s - string;
 }
@@ -234,25 +301,34 @@ size_t strlen( const char *string )
 
 char *strcat( char *strDestination, const char *strSource )
 {
-  char  *s;
-
-  s = strDestination;
-  while( *s )
-    s++;
-
-  while( *strSource )
-    *s++ = *strSource++;
-
-  *s = 0;
+  strcpy( strDestination + strlen( strDestination ), strSource );
   return strDestination;
 }
 
 char *strcpy( char *strDestination, const char *strSource )
 {
-  char *s;
+  char                *s;
+  unsigned int        *d;
+  const unsigned int  *w;
 
   s = strDestination;
 
+  if( ( (int)s & 3 ) == ( (int)strSource & 3 ) )
+  {
+    for( ; !ALIGNED( s ); s++, strSource++ )
+    {
+      if( !( *s = *strSource ) )
+        return strDestination;
+    }
+
+    d = (unsigned int *)s;
+    for( w = (const unsigned int *)strSource; !HASZERO( *w ); w++ )
+      *d++ = *w;
+
+    s = (char *)d;
+    strSource = (const char *)w;
+  }
+
   while( *strSource )
     *s++ = *strSource++;
 
@@ -263,6 +339,28 @@ char *strcpy( char *strDestination, const char *strSource )
 
 int strcmp( const char *string1, const char *string2 )
 {
+  const unsigned int  *w1, *w2;
+
+  if( ( (int)string1 & 3 ) == ( (int)string2 & 3 ) )
+  {
+    for( ; !ALIGNED( string1 ); string1++, string2++ )
+    {
+      if( *string1 != *string2 || !*string1 )
+        return *string1 - *string2;
+    }
+
+    w1 = (const unsigned int *)string1;
+    w2 = (const unsigned int *)string2;
+    while( *w1 == *w2 && !HASZERO( *w1 ) )
+    {
+      w1++;
+      w2++;
+    }
+
+    string1 = (const char *)w1;
+    string2 = (const char *)w2;
+  }
+
   while( *string1 == *string2 && *string1 && *string2 )
   {
     string1++;
@@ -291,14 +389,36 @@ char *strrchr( const char *string, int c )
 
 char *strchr( const char *string, int c )
 {
-  while( *string )
+  const unsigned int  *w;
+  unsigned int        pattern;
+  int                 i;
+
+  for( ; !ALIGNED( string ); string++ )
   {
+    if( !*string )
+      return (char *)0;
+
     if( *string == c )
       return ( char * )string;
+  }
 
-    string++;
+  pattern = ( c & 0xFF ) * 0x01010101U;
+
+  for( w = (const unsigned int *)string; ; w++ )
+  {
+    if( !HASZERO( *w ) && !HASZERO( *w ^ pattern ) )
+      continue;
+
+    string = (const char *)w;
+    for( i = 0; i < 4; i++, string++ )
+    {
+      if( !*string )
+        return (char *)0;
+
+      if( *string == c )
+        return ( char * )string;
+    }
   }
-  return (char *)0;
 }
 
 char *strstr( const char *string, const char *strCharSet )
@@ -344,19 +464,58 @@ int toupper( int c )
 
 #endif
 
+// Copies that don't overlap go to the engine's memcpy, and those that do
+// are done a word at a time when both ends are aligned alike
 void *memmove( void *dest, const void *src, size_t count )
 {
-  int   i;
+  char                *d = (char *)dest;
+  const char          *s = (const char *)src;
+  unsigned int        *dw;
+  const unsigned int  *sw;
+
+  if( d + count <= s || s + count <= d )
+    return memcpy( dest, src, count );
 
-  if( dest > src )
+  if( d > s )
   {
-    for( i = count - 1; i >= 0; i-- )
-      ( (char *)dest )[ i ] = ( (char *)src )[ i ];
+    d += count;
+    s += count;
+
+    if( ( (int)d & 3 ) == ( (int)s & 3 ) )
+    {
+      for( ; count && !ALIGNED( d ); count-- )
+        *--d = *--s;
+
+      dw = (unsigned int *)d;
+      sw = (const unsigned int *)s;
+      for( ; count >= 4; count -= 4 )
+        *--dw = *--sw;
+
+      d = (char *)dw;
+      s = (const char *)sw;
+    }
+
+    while( count-- )
+      *--d = *--s;
   }
   else
   {
-    for( i = 0; i < count; i++ )
-      ( (char *)dest )[ i ] = ( (char *)src )[ i ];
+    if( ( (int)d & 3 ) == ( (int)s & 3 ) )
+    {
+      for( ; count && !ALIGNED( d ); count-- )
+        *d++ = *s++;
+
+      dw = (unsigned int *)d;
+      sw = (const unsigned int *)s;
+      for( ; count >= 4; count -= 4 )
+        *dw++ = *sw++;
+
+      d = (char *)dw;
+      s = (const char *)sw;
+    }
+
+    while( count-- )
+      *d++ = *s++;
   }
 
   return dest;
@@ -1659,249 +1818,625 @@ unsigned int _hextoi( const char **stringPtr )
 
 
 #define ALT       0x00000001    /* alternate form */
-#define HEX       0x00000002    /* hexadecimal  */
 #define LADJUST   0x00000004    /* left adjustment */
-#define LONGDBL   0x00000008    /* long double */
-#define LONGINT   0x00000010    /* long integer */
-#define QUADINT   0x00000020    /* quad integer */
-#define SHORTINT  0x00000040    /* short integer */
 #define ZEROPAD   0x00000080    /* zero (as opposed to blank) pad */
-#define FPT       0x00000100    /* floating point number */
-#define UNSIGNED  0x00000200    /* unsigned integer */    
+#define PLUS      0x00000400    /* always print a sign */
+#define SPACE     0x00000800    /* space where there's no sign */
+#define UPPER     0x00001000    /* upper case hex digits and exponents */
 
 #define to_digit(c)   ((c) - '0')
 #define is_digit(c)   ((unsigned)to_digit(c) <= 9)
 #define to_char(n)    ((n) + '0')
 
-void AddInt( char **buf_p, int val, int width, int flags )
+// copies longer than this go to the engine's memcpy
+#define PRINT_MEMCPY  32
+
+// a float has at most 39 integer and 149 fraction digits
+#define FLOAT_DIGITS  192
+// the exact digits are worked out in base 10^8 limbs
+#define LIMB_BASE     100000000
+#define LIMB_DIGITS   8
+#define FLOAT_LIMBS   ( FLOAT_DIGITS / LIMB_DIGITS + 1 )
+
+typedef struct
+{
+  char  *buffer;      // where the next character goes
+  int   space;        // characters that still fit before the terminator
+  int   length;       // characters produced, whether they fit or not
+} printBuffer_t;
+
+typedef struct
+{
+  int   flags;
+  int   width;
+  int   prec;         // -1 if there isn't one
+} printSpec_t;
+
+static const char digitPairs[ 201 ] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/*
+PrintChars
+
+Stores as much of s as fits, but counts all n characters
+*/
+static void PrintChars( printBuffer_t *pb, const char *s, int n )
 {
-  char  text[ 32 ];
-  int   digits;
+  int   copy;
   char  *buf;
 
-  digits = 0;
+  if( n <= 0 )
+    return;
+
+  pb->length += n;
 
-  if( flags & UNSIGNED )
-    val = (unsigned) val;
+  copy = n < pb->space ? n : pb->space;
+  pb->space -= copy;
 
-  if( flags & HEX )
+  if( copy > PRINT_MEMCPY )
   {
-    char c;
-    int n = 0;
+    memcpy( pb->buffer, s, copy );
+    pb->buffer += copy;
+    return;
+  }
 
-    while( n < 32 )
-    {
-      c = "0123456789abcdef"[ ( val >> n ) & 0xF ];
-      n += 4;
-      if( c == '0' && !digits )
-        continue;    
-      text[ digits++ ] = c;
-    }
-    text[ digits ] = '\0';
+  buf = pb->buffer;
+  while( copy-- )
+    *buf++ = *s++;
+  pb->buffer = buf;
+}
+
+static void PrintPad( printBuffer_t *pb, int c, int n )
+{
+  int   copy;
+  char  *buf;
+
+  if( n <= 0 )
+    return;
+
+  pb->length += n;
+
+  copy = n < pb->space ? n : pb->space;
+  pb->space -= copy;
+
+  buf = pb->buffer;
+  while( copy-- )
+    *buf++ = c;
+  pb->buffer = buf;
+}
+
+/*
+PrintField
+
+prefix, zeros and then body, padded out to the spec's width
+*/
+static void PrintField( printBuffer_t *pb, const printSpec_t *spec,
+                        const char *prefix, int prefixLength, int zeros,
+                        const char *body, int bodyLength )
+{
+  int pad = spec->width - prefixLength - zeros - bodyLength;
+
+  if( pad > 0 && !( spec->flags & LADJUST ) )
+  {
+    if( spec->flags & ZEROPAD )
+      zeros += pad;
+    else
+      PrintPad( pb, ' ', pad );
+  }
+
+  PrintChars( pb, prefix, prefixLength );
+  PrintPad( pb, '0', zeros );
+  PrintChars( pb, body, bodyLength );
+
+  if( pad > 0 && ( spec->flags & LADJUST ) )
+    PrintPad( pb, ' ', pad );
+}
+
+/*
+FormatDecimal
+
+Write value's digits so that they end at end, two at a time from
+digitPairs, and return how many there are
+*/
+static int FormatDecimal( char *end, unsigned int value )
+{
+  char          *p = end;
+  unsigned int  pair;
+
+  while( value >= 100 )
+  {
+    pair = ( value % 100 ) * 2;
+    value /= 100;
+    *--p = digitPairs[ pair + 1 ];
+    *--p = digitPairs[ pair ];
+  }
+
+  if( value >= 10 )
+  {
+    pair = value * 2;
+    *--p = digitPairs[ pair + 1 ];
+    *--p = digitPairs[ pair ];
   }
+  else
+    *--p = to_char( value );
+
+  return end - p;
+}
+
+static void PrintInt( printBuffer_t *pb, printSpec_t *spec, unsigned int value,
+                      qboolean negative, int base )
+{
+  static const char lower[ ] = "0123456789abcdef";
+  static const char upper[ ] = "0123456789ABCDEF";
+  const char  *hexDigits = ( spec->flags & UPPER ) ? upper : lower;
+  char        text[ 32 ];
+  char        prefix[ 3 ];
+  char        *end = text + sizeof( text );
+  int         digits, prefixLength = 0, zeros = 0;
+
+  if( base == 10 )
+    digits = FormatDecimal( end, value );
   else
   {
-    int   signedVal = val;
+    char  *p = end;
+    int   shift = ( base == 16 ) ? 4 : 3;
 
-    if( val < 0 )
-      val = -val;
     do
     {
-      text[ digits++ ] = '0' + val % 10;
-      val /= 10;
-    } while( val );
+      *--p = hexDigits[ value & ( base - 1 ) ];
+      value >>= shift;
+    } while( value );
 
-    if( signedVal < 0 )
-      text[ digits++ ] = '-';
+    digits = end - p;
   }
 
-  buf = *buf_p;
+  // a precision of 0 prints nothing for 0
+  if( spec->prec == 0 && digits == 1 && end[ -1 ] == '0' )
+    digits = 0;
+
+  if( negative )
+    prefix[ prefixLength++ ] = '-';
+  else if( spec->flags & PLUS )
+    prefix[ prefixLength++ ] = '+';
+  else if( spec->flags & SPACE )
+    prefix[ prefixLength++ ] = ' ';
 
-  if( !( flags & LADJUST ) )
+  // the alternate forms lead with a 0, except that 0 gets no 0x
+  if( ( spec->flags & ALT ) && !( digits && end[ -digits ] == '0' ) )
   {
-    while( digits < width )
+    if( base == 8 )
+      zeros = 1;
+    else if( base == 16 && digits )
     {
-      *buf++ = ( flags & ZEROPAD ) ? '0' : ' ';
-      width--;
+      prefix[ prefixLength++ ] = '0';
+      prefix[ prefixLength++ ] = ( spec->flags & UPPER ) ? 'X' : 'x';
     }
   }
 
-  while( digits-- )
+  if( spec->prec >= 0 )
   {
-    *buf++ = text[ digits ];
-    width--;
+    spec->flags &= ~ZEROPAD;
+    if( spec->prec - digits > zeros )
+      zeros = spec->prec - digits;
   }
 
-  if( flags & LADJUST )
-  {
-    while( width-- > 0 )
-      *buf++ = ( flags & ZEROPAD ) ? '0' : ' ';
-  }
-
-  *buf_p = buf;
+  PrintField( pb, spec, prefix, prefixLength, zeros, end - digits, digits );
 }
 
-void AddFloat( char **buf_p, float fval, int width, int prec )
+/*
+FloatDigits
+
+The exact decimal digits of f's magnitude, with *point of them before the
+decimal point, there being at least one.  A float is m * 2^e for an
+integer m of 24 bits, so its integer part is m shifted and its fraction
+is the leftover bits times 5^-e over 10^-e.  Both are worked out exactly
+in base 10^8.  Returns how many digits there are.
+*/
+static int FloatDigits( float f, char *digits, int *point )
 {
-  char  text[ 32 ];
-  int   digits;
-  float signedVal;
-  char  *buf;
-  int   val;
+  unsigned int  limbs[ FLOAT_LIMBS ];
+  unsigned int  bits, m, carry, ipart, fbits;
+  int           e, shift, numLimbs, i, j, n, factor, count;
+  char          *p;
 
-  // get the sign
-  signedVal = fval;
-  if( fval < 0 )
-    fval = -fval;
+  bits = *(unsigned int *)&f;
+  m = bits & 0x7FFFFF;
+  e = ( bits >> 23 ) & 0xFF;
 
-  // write the float number
-  digits = 0;
-  val = (int)fval;
+  if( e )
+    m |= 0x800000;
+  else
+    e = 1;
+  e -= 150;
 
-  do
+  if( e >= 0 )
   {
-    text[ digits++ ] = '0' + val % 10;
-    val /= 10;
-  } while( val );
-
-  if( signedVal < 0 )
-    text[digits++] = '-';
+    ipart = 0;
+    fbits = m;
+    shift = 0;
+    factor = 2;
+    count = e;
+  }
+  else
+  {
+    shift = -e;
+    ipart = ( shift < 24 ) ? m >> shift : 0;
+    fbits = ( shift < 24 ) ? m & ( ( 1 << shift ) - 1 ) : m;
+    factor = 5;
+    count = shift;
+  }
 
-  buf = *buf_p;
+  // fbits times factor^count, which is the integer part when e >= 0
+  limbs[ 0 ] = fbits;
+  numLimbs = 1;
 
-  while( digits < width )
+  for( i = 0; i < count; i++ )
   {
-    *buf++ = ' ';
-    width--;
+    carry = 0;
+    for( j = 0; j < numLimbs; j++ )
+    {
+      limbs[ j ] = limbs[ j ] * factor + carry;
+      carry = limbs[ j ] / LIMB_BASE;
+      limbs[ j ] %= LIMB_BASE;
+    }
+
+    if( carry )
+      limbs[ numLimbs++ ] = carry;
   }
 
-  while( digits-- )
-    *buf++ = text[ digits ];
+  if( e >= 0 )
+  {
+    // the integer part in full, with no fraction
+    n = FormatDecimal( digits + LIMB_DIGITS, limbs[ numLimbs - 1 ] );
+    memmove( digits, digits + LIMB_DIGITS - n, n );
 
-  *buf_p = buf;
+    for( i = numLimbs - 2; i >= 0; i-- )
+    {
+      p = digits + n + LIMB_DIGITS;
+      for( j = 0; j < LIMB_DIGITS; j++ )
+      {
+        *--p = to_char( limbs[ i ] % 10 );
+        limbs[ i ] /= 10;
+      }
+      n += LIMB_DIGITS;
+    }
 
-  if( prec < 0 )
-    prec = 6;
+    *point = n;
+    return n;
+  }
 
-  // write the fraction
-  digits = 0;
+  // the integer part, then the fraction with shift digits
+  n = FormatDecimal( digits + 8, ipart );
+  memmove( digits, digits + 8 - n, n );
+  *point = n;
 
-  while( digits < prec )
+  p = digits + n + shift;
+  for( i = 0; i < numLimbs && p > digits + n; i++ )
   {
-    fval -= (int)fval;
-    fval *= 10.0;
-    val = (int)fval;
-    text[ digits++ ] = '0' + val % 10;
+    for( j = 0; j < LIMB_DIGITS && p > digits + n; j++ )
+    {
+      *--p = to_char( limbs[ i ] % 10 );
+      limbs[ i ] /= 10;
+    }
   }
 
-  if( digits > 0 )
-  {
-    buf = *buf_p;
-    *buf++ = '.';
-    for( prec = 0; prec < digits; prec++ )
-      *buf++ = text[ prec ];
+  while( p > digits + n )
+    *--p = '0';
 
-    *buf_p = buf;
-  }
+  return n + shift;
 }
 
-void AddVec3_t( char **buf_p, vec3_t v, int width, int prec )
+/*
+RoundDigits
+
+Round the n digits to keep of them, half to even.  Returns qtrue if the
+carry ran out of the first digit, which leaves them all '0'.
+*/
+static qboolean RoundDigits( char *digits, int n, int keep )
 {
-  char *buf;
+  qboolean  up;
+  int       i;
 
-  buf = *buf_p;
+  if( keep >= n || keep < 0 )
+    return qfalse;
 
-  *buf++ = '[';
+  if( digits[ keep ] != '5' )
+    up = digits[ keep ] > '5';
+  else
+  {
+    up = qfalse;
+    for( i = keep + 1; i < n; i++ )
+    {
+      if( digits[ i ] != '0' )
+      {
+        up = qtrue;
+        break;
+      }
+    }
 
-  AddFloat( &buf, v[ 0 ], width, prec );
-  buf += width;
-  *buf++ = ' ';
+    if( !up && keep > 0 )
+      up = ( digits[ keep - 1 ] - '0' ) & 1;
+  }
 
-  AddFloat( &buf, v[ 1 ], width, prec );
-  buf += width;
-  *buf++ = ' ';
+  // clear what was cut, so rounding here again changes nothing
+  for( i = keep; i < n; i++ )
+    digits[ i ] = '0';
 
-  AddFloat( &buf, v[ 2 ], width, prec );
-  buf += width;
-  *buf++ = ']';
+  if( !up )
+    return qfalse;
 
-  *buf_p = buf;
+  for( i = keep - 1; i >= 0; i-- )
+  {
+    if( digits[ i ] != '9' )
+    {
+      digits[ i ]++;
+      return qfalse;
+    }
+    digits[ i ] = '0';
+  }
+
+  return qtrue;
 }
 
-void AddString( char **buf_p, char *string, int width, int prec )
+/*
+PrintFloat
+
+%f, %e and %g, from the exact digits rounded to the precision
+*/
+static void PrintFloat( printBuffer_t *pb, printSpec_t *spec, float f,
+                        int conversion )
 {
-  int   size;
-  char  *buf;
+  char      digits[ FLOAT_DIGITS + 2 ];
+  char      body[ FLOAT_DIGITS + 16 ];
+  char      prefix[ 1 ];
+  int       prefixLength = 0, bodyLength = 0;
+  int       n, point, first, prec, keep, exponent, i;
+  unsigned  bits = *(unsigned int *)&f;
+  qboolean  trim = qfalse;
+
+  if( bits & 0x80000000 )
+    prefix[ prefixLength++ ] = '-';
+  else if( spec->flags & PLUS )
+    prefix[ prefixLength++ ] = '+';
+  else if( spec->flags & SPACE )
+    prefix[ prefixLength++ ] = ' ';
+
+  if( ( bits & 0x7F800000 ) == 0x7F800000 )
+  {
+    const char *s;
 
-  buf = *buf_p;
+    if( bits & 0x7FFFFF )
+      s = ( spec->flags & UPPER ) ? "NAN" : "nan";
+    else
+      s = ( spec->flags & UPPER ) ? "INF" : "inf";
 
-  if( string == NULL )
-  {
-    string = "(null)";
-    prec = -1;
+    spec->flags &= ~ZEROPAD;
+    PrintField( pb, spec, prefix, prefixLength, 0, s, 3 );
+    return;
   }
 
-  if( prec >= 0 )
+  prec = spec->prec < 0 ? 6 : spec->prec;
+  n = FloatDigits( f, digits + 1, &point );
+  digits[ 0 ] = '0';
+
+  // digits[ 0 ] is spare room for a carry out of the first digit
+  for( first = 1; first <= n && digits[ first ] == '0'; first++ )
+    ;
+
+  if( conversion == 'g' )
   {
-    for( size = 0; size < prec; size++ )
+    if( prec == 0 )
+      prec = 1;
+
+    // the exponent %e would print decides between the two styles
+    if( first > n )
+      exponent = 0;
+    else
     {
-      if( string[ size ] == '\0' )
-        break;
+      exponent = point - first;
+      if( RoundDigits( digits + first, n + 1 - first, prec ) )
+      {
+        digits[ --first ] = '1';
+        exponent++;
+      }
+    }
+
+    if( exponent < -4 || exponent >= prec )
+    {
+      conversion = 'e';
+      prec--;
     }
+    else
+    {
+      conversion = 'f';
+      prec -= exponent + 1;
+    }
+
+    trim = !( spec->flags & ALT );
+  }
+
+  if( conversion == 'f' )
+  {
+    keep = point + prec;
+    if( RoundDigits( digits + 1, n, keep ) )
+      digits[ 0 ] = '1';
+
+    // no leading zeros before the point, apart from a lone one
+    for( i = 0; i < point && digits[ i ] == '0'; i++ )
+      ;
+
+    bodyLength = point + 1 - i;
+    memcpy( body, digits + i, bodyLength );
+
+    if( prec > 0 || ( spec->flags & ALT ) )
+      body[ bodyLength++ ] = '.';
+
+    for( i = 0; i < prec; i++ )
+      body[ bodyLength++ ] = ( point + 1 + i <= n ) ? digits[ point + 1 + i ] : '0';
   }
   else
-    size = strlen( string );
+  {
+    if( first > n )
+    {
+      // zero
+      first = 1;
+      exponent = 0;
+    }
+    else
+    {
+      exponent = point - first;
+      if( RoundDigits( digits + first, n + 1 - first, prec + 1 ) )
+      {
+        digits[ --first ] = '1';
+        exponent++;
+      }
+    }
 
-  width -= size;
+    body[ bodyLength++ ] = digits[ first ];
+    if( prec > 0 || ( spec->flags & ALT ) )
+      body[ bodyLength++ ] = '.';
 
-  while( size-- )
-    *buf++ = *string++;
+    for( i = 1; i <= prec; i++ )
+      body[ bodyLength++ ] = ( first + i <= n ) ? digits[ first + i ] : '0';
 
-  while( width-- > 0 )
-    *buf++ = ' ';
+    if( trim && prec > 0 )
+    {
+      while( body[ bodyLength - 1 ] == '0' )
+        bodyLength--;
+      if( body[ bodyLength - 1 ] == '.' )
+        bodyLength--;
+    }
+    trim = qfalse;
+
+    body[ bodyLength++ ] = ( spec->flags & UPPER ) ? 'E' : 'e';
+    if( exponent < 0 )
+    {
+      body[ bodyLength++ ] = '-';
+      exponent = -exponent;
+    }
+    else
+      body[ bodyLength++ ] = '+';
 
-  *buf_p = buf;
+    // a float's exponent never needs more than two digits
+    body[ bodyLength++ ] = to_char( exponent / 10 );
+    body[ bodyLength++ ] = to_char( exponent % 10 );
+  }
+
+  if( trim && prec > 0 )
+  {
+    while( body[ bodyLength - 1 ] == '0' )
+      bodyLength--;
+    if( body[ bodyLength - 1 ] == '.' )
+      bodyLength--;
+  }
+
+  PrintField( pb, spec, prefix, prefixLength, 0, body, bodyLength );
+}
+
+static void PrintString( printBuffer_t *pb, printSpec_t *spec, const char *s )
+{
+  int length;
+
+  if( s == NULL )
+    s = "(null)";
+
+  if( !spec->width && spec->prec < 0 )
+  {
+    char  *buf = pb->buffer;
+    int   space = pb->space;
+
+    // the usual case, copied while it's measured
+    for( length = 0; s[ length ] && length < space; length++ )
+      buf[ length ] = s[ length ];
+
+    pb->buffer += length;
+    pb->space -= length;
+
+    if( s[ length ] )
+      length += strlen( s + length );
+
+    pb->length += length;
+    return;
+  }
+
+  if( spec->prec >= 0 )
+  {
+    for( length = 0; length < spec->prec && s[ length ]; length++ )
+      ;
+  }
+  else
+    length = strlen( s );
+
+  spec->flags &= ~ZEROPAD;
+  PrintField( pb, spec, NULL, 0, 0, s, length );
 }
 
 /*
-vsprintf
+vsnprintf
+
+Formats straight into buffer, stopping at size - 1 characters, and returns
+the length the whole output would have had.
 
 I'm not going to support a bunch of the more arcane stuff in here
-just to keep it simpler.  For example, the '*' and '$' are not
-currently supported.  I've tried to make it so that it will just
-parse and ignore formats we don't support.
+just to keep it simpler.  For example, '$' and the 64 bit integer
+sizes are not currently supported.  I've tried to make it so that it
+will just parse and ignore formats we don't support.
 */
-int vsprintf( char *buffer, const char *fmt, va_list argptr )
+int vsnprintf( char *buffer, size_t size, const char *fmt, va_list argptr )
 {
-  int   *arg;
-  char  *buf_p;
-  char  ch;
-  int   flags;
-  int   width;
-  int   prec;
-  int   n;
-  char  sign;
-
-  buf_p = buffer;
-  arg = (int *)argptr;
+  printBuffer_t pb;
+  printSpec_t   spec;
+  const char    *start;
+  char          *buf, *end;
+  char          ch;
+  int           n, i;
+  vec_t         *v;
+
+  pb.buffer = buffer;
+  pb.space = size > 0 ? (int)( size - 1 ) : 0;
+  pb.length = 0;
 
   while( qtrue )
   {
-    // run through the format string until we hit a '%' or '\0'
-    for( ch = *fmt; ( ch = *fmt ) != '\0' && ch != '%'; fmt++ )
-      *buf_p++ = ch;
+    // copy the format string up to the next '%' or '\0' while it fits,
+    // then just count whatever didn't
+    buf = pb.buffer;
+    end = buf + pb.space;
+    while( buf < end && ( ch = *fmt ) != '\0' && ch != '%' )
+    {
+      *buf++ = ch;
+      fmt++;
+    }
+    pb.length += buf - pb.buffer;
+    pb.space -= buf - pb.buffer;
+    pb.buffer = buf;
+
+    if( buf == end )
+    {
+      for( start = fmt; ( ch = *fmt ) != '\0' && ch != '%'; fmt++ )
+        ;
+      pb.length += fmt - start;
+    }
 
     if( ch == '\0' )
-      goto done;
+      break;
 
     // skip over the '%'
     fmt++;
 
     // reset formatting state
-    flags = 0;
-    width = 0;
-    prec = -1;
-    sign = '\0';
+    spec.flags = 0;
+    spec.width = 0;
+    spec.prec = -1;
 
 rflag:
     ch = *fmt++;
@@ -1909,21 +2444,51 @@ reswitch:
     switch( ch )
     {
       case '-':
-        flags |= LADJUST;
+        spec.flags |= LADJUST;
+        goto rflag;
+
+      case '+':
+        spec.flags |= PLUS;
+        goto rflag;
+
+      case ' ':
+        spec.flags |= SPACE;
+        goto rflag;
+
+      case '#':
+        spec.flags |= ALT;
+        goto rflag;
+
+      case '0':
+        spec.flags |= ZEROPAD;
+        goto rflag;
+
+      case '*':
+        n = va_arg( argptr, int );
+        if( n < 0 )
+        {
+          spec.flags |= LADJUST;
+          n = -n;
+        }
+        spec.width = n;
         goto rflag;
 
       case '.':
+        if( *fmt == '*' )
+        {
+          fmt++;
+          n = va_arg( argptr, int );
+          spec.prec = n < 0 ? -1 : n;
+          goto rflag;
+        }
+
         n = 0;
         while( is_digit( ( ch = *fmt++ ) ) )
-          n = 10 * n + ( ch - '0' );
+          n = 10 * n + to_digit( ch );
 
-        prec = n < 0 ? -1 : n;
+        spec.prec = n;
         goto reswitch;
 
-      case '0':
-        flags |= ZEROPAD;
-        goto rflag;
-
       case '1':
       case '2':
       case '3':
@@ -1936,65 +2501,126 @@ reswitch:
         n = 0;
         do
         {
-          n = 10 * n + ( ch - '0' );
+          n = 10 * n + to_digit( ch );
           ch = *fmt++;
         } while( is_digit( ch ) );
 
-        width = n;
+        spec.width = n;
         goto reswitch;
 
+      case 'h':
+      case 'l':
+      case 'L':
+      case 'z':
+        // everything is 32 bit
+        goto rflag;
+
       case 'c':
-        *buf_p++ = (char)*arg;
-        arg++;
+        ch = (char)va_arg( argptr, int );
+        spec.flags &= ~ZEROPAD;
+        PrintField( &pb, &spec, NULL, 0, 0, &ch, 1 );
         break;
 
-      case 'u':
-        flags |= UNSIGNED;
       case 'd':
       case 'i':
-        AddInt( &buf_p, *arg, width, flags );
-        arg++;
+        n = va_arg( argptr, int );
+        if( !spec.flags && !spec.width && spec.prec < 0 )
+        {
+          char  text[ 12 ];
+          int   digits;
+
+          // the usual case, without any of the padding
+          if( n < 0 )
+          {
+            digits = FormatDecimal( text + 12, ~(unsigned int)n + 1 );
+            text[ 12 - ++digits ] = '-';
+          }
+          else
+            digits = FormatDecimal( text + 12, n );
+
+          PrintChars( &pb, text + 12 - digits, digits );
+          break;
+        }
+
+        if( n < 0 )
+          PrintInt( &pb, &spec, ~(unsigned int)n + 1, qtrue, 10 );
+        else
+          PrintInt( &pb, &spec, n, qfalse, 10 );
+        break;
+
+      case 'u':
+        PrintInt( &pb, &spec, va_arg( argptr, unsigned int ), qfalse, 10 );
         break;
 
+      case 'X':
+        spec.flags |= UPPER;
+      case 'x':
+        PrintInt( &pb, &spec, va_arg( argptr, unsigned int ), qfalse, 16 );
+        break;
+
+      case 'o':
+        PrintInt( &pb, &spec, va_arg( argptr, unsigned int ), qfalse, 8 );
+        break;
+
+      case 'p':
+        spec.flags |= ALT;
+        PrintInt( &pb, &spec, va_arg( argptr, unsigned int ), qfalse, 16 );
+        break;
+
+      case 'E':
+      case 'F':
+      case 'G':
+        spec.flags |= UPPER;
+        ch += 'a' - 'A';
+      case 'e':
       case 'f':
-        AddFloat( &buf_p, *(double *)arg, width, prec );
-#ifdef Q3_VM
-        arg += 1; // everything is 32 bit in my compiler
-#else
-        arg += 2;
-#endif
+      case 'g':
+        PrintFloat( &pb, &spec, va_arg( argptr, double ), ch );
         break;
 
       case 's':
-        AddString( &buf_p, (char *)*arg, width, prec );
-        arg++;
+        PrintString( &pb, &spec, va_arg( argptr, char * ) );
         break;
 
       case 'v':
-        AddVec3_t( &buf_p, (vec_t *)*arg, width, prec );
-        arg++;
-        break;
-      
-      case 'x':
-        flags |= HEX;
-        AddInt( &buf_p, *arg, width, prec );
-        arg++;
+        // a vec3_t, each component formatted as %f would
+        v = va_arg( argptr, vec_t * );
+        PrintChars( &pb, "[", 1 );
+        for( i = 0; i < 3; i++ )
+        {
+          if( i )
+            PrintChars( &pb, " ", 1 );
+          PrintFloat( &pb, &spec, v[ i ], 'f' );
+        }
+        PrintChars( &pb, "]", 1 );
         break;
 
       case '%':
-        *buf_p++ = ch;
+        PrintChars( &pb, "%", 1 );
+        break;
+
+      case '\0':
+        // a '%' at the end of the format
+        fmt--;
         break;
 
       default:
-        *buf_p++ = (char)*arg;
-        arg++;
+        // not a conversion we know, so print it as it is
+        PrintChars( &pb, "%", 1 );
+        PrintChars( &pb, &ch, 1 );
         break;
     }
   }
 
-done:
-  *buf_p = 0;
-  return buf_p - buffer;
+  if( size > 0 )
+    *pb.buffer = '\0';
+
+  return pb.length;
+}
+
+int vsprintf( char *buffer, const char *fmt, va_list argptr )
+{
+  return vsnprintf( buffer, INT_MAX, fmt, argptr );
 }
 
 
@@ -96,6 +96,7 @@ int     _atoi( const char **stringPtr );
 
 
 int     vsprintf( char *buffer, const char *fmt, va_list argptr );
+int     vsnprintf( char *buffer, size_t size, const char *fmt, va_list argptr );
 int     sscanf( const char *buffer, const char *fmt, ... );
 
 // Memory functions
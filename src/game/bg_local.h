@@ -77,6 +77,9 @@ extern float pm_flightfriction;
 extern int c_pmove;
 
 void PM_ClipVelocity(vec3_t in, vec3_t normal, vec3_t out, float overbounce);
+void PM_Trace(trace_t * results, const vec3_t start, const vec3_t mins,
+	      const vec3_t maxs, const vec3_t end, int passEntityNum,
+	      int contentMask);
 void PM_AddTouchEnt(int entityNum);
 void PM_AddEvent(int newEvent);
 
@@ -31,6 +31,10 @@ void trap_FS_Read(void *buffer, int len, fileHandle_t f);
 void trap_FS_Write(const void *buffer, int len, fileHandle_t f);
 void trap_FS_FCloseFile(fileHandle_t f);
 void trap_FS_Seek(fileHandle_t f, long offset, fsOrigin_t origin);	// fsOrigin_t
+int trap_FS_GetFileList(const char *path, const char *extension, char *listbuf,
+			int bufsize);
+void trap_Cvar_VariableStringBuffer(const char *var_name, char *buffer,
+				    int bufsize);
 
 buildableAttributes_t bg_buildableList[] = {
 	{
@@ -634,6 +638,122 @@ int bg_numBuildables = sizeof(bg_buildableList) / sizeof(bg_buildableList[0]);
 //separate from bg_buildableList to work around char struct init bug
 buildableAttributeOverrides_t bg_buildableOverrideList[BA_NUM_BUILDABLES];
 
+//bg_buildableList with any overrides applied, indexed by buildNum
+static buildableAttributes_t bg_buildableResolved[BA_NUM_BUILDABLES];
+static buildableAttributes_t *bg_buildableTable[BA_NUM_BUILDABLES];
+static qboolean bg_buildableTableBuilt = qfalse;
+
+//bg_buildableList indices sorted by entityName, for spawning map entities
+static int bg_buildableEntityNames[sizeof(bg_buildableList) /
+				   sizeof(bg_buildableList[0])];
+
+/*
+==============
+BG_CompareBuildableEntityNames
+
+Ties go to the first in bg_buildableList, like a linear search would
+==============
+*/
+static int BG_CompareBuildableEntityNames(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+	int order = Q_stricmp(bg_buildableList[x].entityName,
+			      bg_buildableList[y].entityName);
+
+	return order ? order : x - y;
+}
+
+/*
+==============
+BG_BuildBuildableTable
+
+Index bg_buildableList by buildNum and apply bg_buildableOverrideList, so
+the accessors below don't have to search for a buildable.  bg_buildableList
+isn't in buildable_t order, so only check that every buildable but BA_NONE
+is in it exactly once.
+==============
+*/
+static void BG_BuildBuildableTable(void)
+{
+	int i, j, num;
+	buildableAttributes_t *ba;
+	buildableAttributeOverrides_t *bao;
+
+	memset(bg_buildableTable, 0, sizeof(bg_buildableTable));
+
+	for (i = 0; i < bg_numBuildables; i++) {
+		num = bg_buildableList[i].buildNum;
+
+		if (num <= BA_NONE || num >= BA_NUM_BUILDABLES) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: bg_buildableList[ %d ] has invalid "
+				   "buildNum %d\n", i, num);
+			continue;
+		}
+
+		if (bg_buildableTable[num]) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: buildNum %d is in bg_buildableList "
+				   "twice\n", num);
+			continue;
+		}
+
+		ba = &bg_buildableResolved[num];
+		bao = &bg_buildableOverrideList[num];
+		*ba = bg_buildableList[i];
+
+		for (j = 0; j < MAX_BUILDABLE_MODELS; j++) {
+			if (bao->models[j][0] != 0)
+				ba->models[j] = bao->models[j];
+		}
+
+		if (bao->modelScale != 0.0f)
+			ba->modelScale = bao->modelScale;
+
+		if (VectorLength(bao->mins))
+			VectorCopy(bao->mins, ba->mins);
+
+		if (VectorLength(bao->maxs))
+			VectorCopy(bao->maxs, ba->maxs);
+
+		if (bao->zOffset != 0.0f)
+			ba->zOffset = bao->zOffset;
+
+		bg_buildableTable[num] = ba;
+	}
+
+	for (i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++) {
+		if (!bg_buildableTable[i])
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: buildNum %d is missing from "
+				   "bg_buildableList\n", i);
+	}
+
+	for (i = 0; i < bg_numBuildables; i++)
+		bg_buildableEntityNames[i] = i;
+
+	qsort(bg_buildableEntityNames, bg_numBuildables, sizeof(int),
+	      BG_CompareBuildableEntityNames);
+
+	bg_buildableTableBuilt = qtrue;
+}
+
+/*
+==============
+BG_Buildable
+==============
+*/
+static const buildableAttributes_t *BG_Buildable(int bclass)
+{
+	if (!bg_buildableTableBuilt)
+		BG_BuildBuildableTable();
+
+	if (bclass < 0 || bclass >= BA_NUM_BUILDABLES)
+		return NULL;
+
+	return bg_buildableTable[bclass];
+}
+
 /*
 ==============
 BG_FindBuildNumForName
@@ -659,13 +779,29 @@ BG_FindBuildNumForEntityName
 */
 int BG_FindBuildNumForEntityName(char *name)
 {
-	int i;
+	int low, high, mid;
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (!Q_stricmp(bg_buildableList[i].entityName, name))
-			return bg_buildableList[i].buildNum;
+	if (!bg_buildableTableBuilt)
+		BG_BuildBuildableTable();
+
+	// binary search for the first match
+	low = 0;
+	high = bg_numBuildables;
+	while (low < high) {
+		mid = (low + high) / 2;
+
+		if (Q_stricmp(bg_buildableList[bg_buildableEntityNames[mid]].
+			      entityName, name) < 0)
+			low = mid + 1;
+		else
+			high = mid;
 	}
 
+	if (low < bg_numBuildables &&
+	    !Q_stricmp(bg_buildableList[bg_buildableEntityNames[low]].
+		       entityName, name))
+		return bg_buildableList[bg_buildableEntityNames[low]].buildNum;
+
 	//wimp out
 	return BA_NONE;
 }
@@ -677,12 +813,10 @@ BG_FindNameForBuildNum
 */
 char *BG_FindNameForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass)
-			return bg_buildableList[i].buildName;
-	}
+	if (ba)
+		return ba->buildName;
 
 	//wimp out
 	return 0;
@@ -695,12 +829,10 @@ BG_FindHumanNameForBuildNum
 */
 char *BG_FindHumanNameForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass)
-			return bg_buildableList[i].humanName;
-	}
+	if (ba)
+		return ba->humanName;
 
 	//wimp out
 	return 0;
@@ -713,12 +845,10 @@ BG_FindEntityNameForBuildNum
 */
 char *BG_FindEntityNameForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass)
-			return bg_buildableList[i].entityName;
-	}
+	if (ba)
+		return ba->entityName;
 
 	//wimp out
 	return 0;
@@ -731,15 +861,10 @@ BG_FindModelsForBuildNum
 */
 char *BG_FindModelsForBuildable(int bclass, int modelNum)
 {
-	int i;
-
-	if (bg_buildableOverrideList[bclass].models[modelNum][0] != 0)
-		return bg_buildableOverrideList[bclass].models[modelNum];
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass)
-			return bg_buildableList[i].models[modelNum];
-	}
+	if (ba)
+		return ba->models[modelNum];
 
 	//wimp out
 	return 0;
@@ -752,15 +877,10 @@ BG_FindModelScaleForBuildable
 */
 float BG_FindModelScaleForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	if (bg_buildableOverrideList[bclass].modelScale != 0.0f)
-		return bg_buildableOverrideList[bclass].modelScale;
-
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass)
-			return bg_buildableList[i].modelScale;
-	}
+	if (ba)
+		return ba->modelScale;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindModelScaleForBuildable( %d )\n",
@@ -775,37 +895,16 @@ BG_FindBBoxForBuildable
 */
 void BG_FindBBoxForBuildable(int bclass, vec3_t mins, vec3_t maxs)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			if (mins != NULL) {
-				VectorCopy(bg_buildableList[i].mins, mins);
-
-				if (VectorLength
-				    (bg_buildableOverrideList[bclass].mins))
-					VectorCopy(bg_buildableOverrideList
-						   [bclass].mins, mins);
-			}
-
-			if (maxs != NULL) {
-				VectorCopy(bg_buildableList[i].maxs, maxs);
-
-				if (VectorLength
-				    (bg_buildableOverrideList[bclass].maxs))
-					VectorCopy(bg_buildableOverrideList
-						   [bclass].maxs, maxs);
-			}
-
-			return;
-		}
-	}
+	if (!ba)
+		ba = &bg_buildableList[0];
 
 	if (mins != NULL)
-		VectorCopy(bg_buildableList[0].mins, mins);
+		VectorCopy(ba->mins, mins);
 
 	if (maxs != NULL)
-		VectorCopy(bg_buildableList[0].maxs, maxs);
+		VectorCopy(ba->maxs, maxs);
 }
 
 /*
@@ -815,16 +914,10 @@ BG_FindZOffsetForBuildable
 */
 float BG_FindZOffsetForBuildable(int bclass)
 {
-	int i;
-
-	if (bg_buildableOverrideList[bclass].zOffset != 0.0f)
-		return bg_buildableOverrideList[bclass].zOffset;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].zOffset;
-		}
-	}
+	if (ba)
+		return ba->zOffset;
 
 	return 0.0f;
 }
@@ -836,13 +929,10 @@ BG_FindTrajectoryForBuildable
 */
 trType_t BG_FindTrajectoryForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].traj;
-		}
-	}
+	if (ba)
+		return ba->traj;
 
 	return TR_GRAVITY;
 }
@@ -854,13 +944,10 @@ BG_FindBounceForBuildable
 */
 float BG_FindBounceForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].bounce;
-		}
-	}
+	if (ba)
+		return ba->bounce;
 
 	return 0.0;
 }
@@ -872,13 +959,10 @@ BG_FindBuildPointsForBuildable
 */
 int BG_FindBuildPointsForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].buildPoints;
-		}
-	}
+	if (ba)
+		return ba->buildPoints;
 
 	return 1000;
 }
@@ -890,15 +974,13 @@ BG_FindStagesForBuildable
 */
 qboolean BG_FindStagesForBuildable(int bclass, stage_t stage)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			if (bg_buildableList[i].stages & (1 << stage))
-				return qtrue;
-			else
-				return qfalse;
-		}
+	if (ba) {
+		if (ba->stages & (1 << stage))
+			return qtrue;
+		else
+			return qfalse;
 	}
 
 	return qfalse;
@@ -911,13 +993,10 @@ BG_FindHealthForBuildable
 */
 int BG_FindHealthForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].health;
-		}
-	}
+	if (ba)
+		return ba->health;
 
 	return 1000;
 }
@@ -929,13 +1008,10 @@ BG_FindRegenRateForBuildable
 */
 int BG_FindRegenRateForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].regenRate;
-		}
-	}
+	if (ba)
+		return ba->regenRate;
 
 	return 0;
 }
@@ -947,13 +1023,10 @@ BG_FindSplashDamageForBuildable
 */
 int BG_FindSplashDamageForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].splashDamage;
-		}
-	}
+	if (ba)
+		return ba->splashDamage;
 
 	return 50;
 }
@@ -965,13 +1038,10 @@ BG_FindSplashRadiusForBuildable
 */
 int BG_FindSplashRadiusForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].splashRadius;
-		}
-	}
+	if (ba)
+		return ba->splashRadius;
 
 	return 200;
 }
@@ -983,13 +1053,10 @@ BG_FindMODForBuildable
 */
 int BG_FindMODForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].meansOfDeath;
-		}
-	}
+	if (ba)
+		return ba->meansOfDeath;
 
 	return MOD_UNKNOWN;
 }
@@ -1001,13 +1068,10 @@ BG_FindTeamForBuildable
 */
 int BG_FindTeamForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].team;
-		}
-	}
+	if (ba)
+		return ba->team;
 
 	return BIT_NONE;
 }
@@ -1019,13 +1083,10 @@ BG_FindBuildWeaponForBuildable
 */
 weapon_t BG_FindBuildWeaponForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].buildWeapon;
-		}
-	}
+	if (ba)
+		return ba->buildWeapon;
 
 	return WP_NONE;
 }
@@ -1037,13 +1098,10 @@ BG_FindAnimForBuildable
 */
 int BG_FindAnimForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].idleAnim;
-		}
-	}
+	if (ba)
+		return ba->idleAnim;
 
 	return BANIM_IDLE1;
 }
@@ -1055,13 +1113,10 @@ BG_FindNextThinkForBuildable
 */
 int BG_FindNextThinkForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].nextthink;
-		}
-	}
+	if (ba)
+		return ba->nextthink;
 
 	return 100;
 }
@@ -1073,13 +1128,10 @@ BG_FindBuildTimeForBuildable
 */
 int BG_FindBuildTimeForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].buildTime;
-		}
-	}
+	if (ba)
+		return ba->buildTime;
 
 	return 10000;
 }
@@ -1091,13 +1143,10 @@ BG_FindUsableForBuildable
 */
 qboolean BG_FindUsableForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].usable;
-		}
-	}
+	if (ba)
+		return ba->usable;
 
 	return qfalse;
 }
@@ -1109,13 +1158,10 @@ BG_FindFireSpeedForBuildable
 */
 int BG_FindFireSpeedForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].turretFireSpeed;
-		}
-	}
+	if (ba)
+		return ba->turretFireSpeed;
 
 	return 1000;
 }
@@ -1127,13 +1173,10 @@ BG_FindRangeForBuildable
 */
 int BG_FindRangeForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].turretRange;
-		}
-	}
+	if (ba)
+		return ba->turretRange;
 
 	return 1000;
 }
@@ -1145,13 +1188,10 @@ BG_FindProjTypeForBuildable
 */
 weapon_t BG_FindProjTypeForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].turretProjType;
-		}
-	}
+	if (ba)
+		return ba->turretProjType;
 
 	return WP_NONE;
 }
@@ -1163,13 +1203,10 @@ BG_FindMinNormalForBuildable
 */
 float BG_FindMinNormalForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].minNormal;
-		}
-	}
+	if (ba)
+		return ba->minNormal;
 
 	return 0.707f;
 }
@@ -1181,13 +1218,10 @@ BG_FindInvertNormalForBuildable
 */
 qboolean BG_FindInvertNormalForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].invertNormal;
-		}
-	}
+	if (ba)
+		return ba->invertNormal;
 
 	return qfalse;
 }
@@ -1199,13 +1233,10 @@ BG_FindCreepTestForBuildable
 */
 int BG_FindCreepTestForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].creepTest;
-		}
-	}
+	if (ba)
+		return ba->creepTest;
 
 	return qfalse;
 }
@@ -1217,13 +1248,10 @@ BG_FindCreepSizeForBuildable
 */
 int BG_FindCreepSizeForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].creepSize;
-		}
-	}
+	if (ba)
+		return ba->creepSize;
 
 	return CREEP_BASESIZE;
 }
@@ -1235,13 +1263,10 @@ BG_FindDCCTestForBuildable
 */
 int BG_FindDCCTestForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].dccTest;
-		}
-	}
+	if (ba)
+		return ba->dccTest;
 
 	return qfalse;
 }
@@ -1253,13 +1278,10 @@ BG_FindUniqueTestForBuildable
 */
 int BG_FindUniqueTestForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].reactorTest;
-		}
-	}
+	if (ba)
+		return ba->reactorTest;
 
 	return qfalse;
 }
@@ -1271,13 +1293,10 @@ BG_FindReplaceableTestForBuildable
 */
 qboolean BG_FindReplaceableTestForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].replaceable;
-		}
-	}
+	if (ba)
+		return ba->replaceable;
 	return qfalse;
 }
 
@@ -1298,13 +1317,10 @@ BG_FindTransparentTestForBuildable
 */
 qboolean BG_FindTransparentTestForBuildable(int bclass)
 {
-	int i;
+	const buildableAttributes_t *ba = BG_Buildable(bclass);
 
-	for (i = 0; i < bg_numBuildables; i++) {
-		if (bg_buildableList[i].buildNum == bclass) {
-			return bg_buildableList[i].transparentTest;
-		}
-	}
+	if (ba)
+		return ba->transparentTest;
 	return qfalse;
 }
 
@@ -1431,25 +1447,214 @@ static qboolean BG_ParseBuildableFile(const char *filename,
 	return qtrue;
 }
 
+/*
+===============
+Override bundles
+
+Parsing every class and buildable cfg on each game, cgame and ui init is
+replaced by reading one binary file per kind holding the parsed override
+structs.  A bundle is tagged with a hash of the names and contents of the
+cfgs it was made from, and is thrown away and rebuilt if that no longer
+matches, so the cfgs stay the source of truth.  A bundle can also be
+shipped in a pk3 alongside the cfgs.
+===============
+*/
+
+#define OVERRIDE_BUNDLE_IDENT   (('B'<<24)+('R'<<16)+('V'<<8)+'O')
+#define OVERRIDE_BUNDLE_VERSION 1
+
+typedef struct {
+	int ident;
+	int version;
+	int size;		// of one override struct
+	int count;
+	unsigned int hash;
+} overrideBundleHeader_t;
+
+static char bg_overrideFileList[4096];
+static char bg_overrideHashBuffer[4096];
+
+/*
+===============
+BG_HashOverrideFiles
+
+Hash the override files in dir for entries first to count - 1, which are
+named by nameFunc.  Only files the file list says exist are opened.
+===============
+*/
+static unsigned int BG_HashOverrideFiles(const char *dir, int first,
+					 int count, char *(*nameFunc)(int))
+{
+	unsigned int hash = 2166136261U;
+	int numFiles, i, j, len, chunk;
+	char *entry, *name;
+	fileHandle_t f;
+
+	numFiles = trap_FS_GetFileList(dir, ".cfg", bg_overrideFileList,
+				       sizeof(bg_overrideFileList));
+
+	for (i = first; i < count; i++) {
+		name = nameFunc(i);
+		if (!name)
+			continue;
+
+		entry = bg_overrideFileList;
+		for (j = 0; j < numFiles; j++) {
+			if (!Q_stricmp(entry, va("%s.cfg", name)))
+				break;
+
+			entry += strlen(entry) + 1;
+		}
+
+		if (j == numFiles)
+			continue;
+
+		len = trap_FS_FOpenFile(va("%s/%s", dir, entry), &f, FS_READ);
+		if (len < 0)
+			continue;
+
+		hash = (hash ^ i) * 16777619U;
+		hash = (hash ^ len) * 16777619U;
+
+		while (len > 0) {
+			chunk = len;
+			if (chunk > sizeof(bg_overrideHashBuffer))
+				chunk = sizeof(bg_overrideHashBuffer);
+
+			trap_FS_Read(bg_overrideHashBuffer, chunk, f);
+			len -= chunk;
+
+			for (j = 0; j < chunk; j++) {
+				hash = (hash ^ (unsigned char)
+					bg_overrideHashBuffer[j]) * 16777619U;
+			}
+		}
+
+		trap_FS_FCloseFile(f);
+	}
+
+	return hash;
+}
+
+/*
+===============
+BG_ReadOverrideBundle
+
+Load count override structs of size bytes from filename if it was made
+from files with the given hash.  overrides is undefined if this fails.
+===============
+*/
+static qboolean BG_ReadOverrideBundle(const char *filename, unsigned int hash,
+				      void *overrides, int size, int count)
+{
+	overrideBundleHeader_t header;
+	fileHandle_t f;
+	int len;
+
+	len = trap_FS_FOpenFile(filename, &f, FS_READ);
+	if (len < 0)
+		return qfalse;
+
+	if (len != sizeof(header) + size * count) {
+		trap_FS_FCloseFile(f);
+		return qfalse;
+	}
+
+	trap_FS_Read(&header, sizeof(header), f);
+
+	if (header.ident != OVERRIDE_BUNDLE_IDENT ||
+	    header.version != OVERRIDE_BUNDLE_VERSION ||
+	    header.size != size || header.count != count ||
+	    header.hash != hash) {
+		trap_FS_FCloseFile(f);
+		return qfalse;
+	}
+
+	trap_FS_Read(overrides, size * count, f);
+	trap_FS_FCloseFile(f);
+
+	return qtrue;
+}
+
+/*
+===============
+BG_WriteOverrideBundle
+
+Not on pure clients, which only read from the server's pk3s and so would
+never see the bundle again
+===============
+*/
+static void BG_WriteOverrideBundle(const char *filename, unsigned int hash,
+				   const void *overrides, int size, int count)
+{
+	overrideBundleHeader_t header;
+	fileHandle_t f;
+#ifndef GAME
+	char pure[16];
+
+	trap_Cvar_VariableStringBuffer("sv_pure", pure, sizeof(pure));
+	if (atoi(pure))
+		return;
+#endif
+
+	if (trap_FS_FOpenFile(filename, &f, FS_WRITE) < 0)
+		return;
+
+	header.ident = OVERRIDE_BUNDLE_IDENT;
+	header.version = OVERRIDE_BUNDLE_VERSION;
+	header.size = size;
+	header.count = count;
+	header.hash = hash;
+
+	trap_FS_Write(&header, sizeof(header), f);
+	trap_FS_Write(overrides, size * count, f);
+	trap_FS_FCloseFile(f);
+}
+
 /*
 ===============
 BG_InitBuildableOverrides
 
-Set any overrides specfied by file
+Set any overrides specfied by file, from the bundle if it's up to date,
+then rebuild the table the accessors use
 ===============
 */
 void BG_InitBuildableOverrides(void)
 {
 	int i;
+	char *name;
+	unsigned int hash;
 	buildableAttributeOverrides_t *bao;
 
-	for (i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++) {
-		bao = BG_FindOverrideForBuildable(i);
+	hash = BG_HashOverrideFiles("overrides/buildables", BA_NONE + 1,
+				    BA_NUM_BUILDABLES, BG_FindNameForBuildable);
+
+	if (!BG_ReadOverrideBundle("overrides/buildables.bundle", hash,
+				   bg_buildableOverrideList,
+				   sizeof(bg_buildableOverrideList[0]),
+				   BA_NUM_BUILDABLES)) {
+		memset(bg_buildableOverrideList, 0,
+		       sizeof(bg_buildableOverrideList));
+
+		for (i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++) {
+			bao = BG_FindOverrideForBuildable(i);
+			name = BG_FindNameForBuildable(i);
 
-		BG_ParseBuildableFile(va
-				      ("overrides/buildables/%s.cfg",
-				       BG_FindNameForBuildable(i)), bao);
+			if (!name)
+				continue;
+
+			BG_ParseBuildableFile(va
+					      ("overrides/buildables/%s.cfg",
+					       name), bao);
+		}
+
+		BG_WriteOverrideBundle("overrides/buildables.bundle", hash,
+				       bg_buildableOverrideList,
+				       sizeof(bg_buildableOverrideList[0]),
+				       BA_NUM_BUILDABLES);
 	}
+
+	BG_BuildBuildableTable();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1956,6 +2161,124 @@ int bg_numPclasses = sizeof(bg_classList) / sizeof(bg_classList[0]);
 //separate from bg_classList to work around char struct init bug
 classAttributeOverrides_t bg_classOverrideList[PCL_NUM_CLASSES];
 
+//bg_classList with any overrides applied, indexed by classNum
+static classAttributes_t bg_classResolved[PCL_NUM_CLASSES];
+static classAttributes_t *bg_classTable[PCL_NUM_CLASSES];
+static qboolean bg_classTableBuilt = qfalse;
+
+/*
+==============
+BG_BuildClassTable
+
+Index bg_classList by classNum and apply bg_classOverrideList, complaining
+if the list has drifted from the order of pClass_t
+==============
+*/
+static void BG_BuildClassTable(void)
+{
+	int i, num;
+	classAttributes_t *ca;
+	classAttributeOverrides_t *cao;
+
+	memset(bg_classTable, 0, sizeof(bg_classTable));
+
+	for (i = 0; i < bg_numPclasses; i++) {
+		num = bg_classList[i].classNum;
+
+		if (num < 0 || num >= PCL_NUM_CLASSES) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: bg_classList[ %d ] has invalid "
+				   "classNum %d\n", i, num);
+			continue;
+		}
+
+		if (bg_classTable[num]) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: classNum %d is in bg_classList "
+				   "twice\n", num);
+			continue;
+		}
+
+		if (num != i)
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: bg_classList[ %d ] is out of order "
+				   "(classNum %d)\n", i, num);
+
+		ca = &bg_classResolved[num];
+		cao = &bg_classOverrideList[num];
+		*ca = bg_classList[i];
+
+		if (cao->humanName[0] != 0)
+			ca->humanName = cao->humanName;
+
+		if (cao->modelName[0] != 0)
+			ca->modelName = cao->modelName;
+
+		if (cao->modelScale != 0.0f)
+			ca->modelScale = cao->modelScale;
+
+		if (cao->skinName[0] != 0)
+			ca->skinName = cao->skinName;
+
+		if (cao->shadowScale != 0.0f)
+			ca->shadowScale = cao->shadowScale;
+
+		if (cao->hudName[0] != 0)
+			ca->hudName = cao->hudName;
+
+		if (VectorLength(cao->mins))
+			VectorCopy(cao->mins, ca->mins);
+
+		if (VectorLength(cao->maxs))
+			VectorCopy(cao->maxs, ca->maxs);
+
+		if (VectorLength(cao->crouchMaxs))
+			VectorCopy(cao->crouchMaxs, ca->crouchMaxs);
+
+		if (VectorLength(cao->deadMins))
+			VectorCopy(cao->deadMins, ca->deadMins);
+
+		if (VectorLength(cao->deadMaxs))
+			VectorCopy(cao->deadMaxs, ca->deadMaxs);
+
+		if (cao->viewheight != 0)
+			ca->viewheight = cao->viewheight;
+
+		if (cao->crouchViewheight != 0)
+			ca->crouchViewheight = cao->crouchViewheight;
+
+		if (cao->zOffset != 0.0f)
+			ca->zOffset = cao->zOffset;
+
+		bg_classTable[num] = ca;
+	}
+
+	for (i = 0; i < PCL_NUM_CLASSES; i++) {
+		if (!bg_classTable[i])
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: classNum %d is missing from "
+				   "bg_classList\n", i);
+	}
+
+	bg_classTableBuilt = qtrue;
+}
+
+/*
+==============
+BG_Class
+==============
+*/
+static const classAttributes_t *BG_Class(int pclass)
+{
+	if (!bg_classTableBuilt)
+		BG_BuildClassTable();
+
+	if (pclass < 0 || pclass >= PCL_NUM_CLASSES)
+		return NULL;
+
+	return bg_classTable[pclass];
+}
+
 /*
 ==============
 BG_FindClassNumForName
@@ -1981,12 +2304,10 @@ BG_FindNameForClassNum
 */
 char *BG_FindNameForClassNum(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass)
-			return bg_classList[i].className;
-	}
+	if (ca)
+		return ca->className;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindNameForClassNum\n");
@@ -2001,15 +2322,10 @@ BG_FindHumanNameForClassNum
 */
 char *BG_FindHumanNameForClassNum(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	if (bg_classOverrideList[pclass].humanName[0] != 0)
-		return bg_classOverrideList[pclass].humanName;
-
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass)
-			return bg_classList[i].humanName;
-	}
+	if (ca)
+		return ca->humanName;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindHumanNameForClassNum\n");
@@ -2024,15 +2340,10 @@ BG_FindModelNameForClass
 */
 char *BG_FindModelNameForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	if (bg_classOverrideList[pclass].modelName[0] != 0)
-		return bg_classOverrideList[pclass].modelName;
-
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass)
-			return bg_classList[i].modelName;
-	}
+	if (ca)
+		return ca->modelName;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindModelNameForClass\n");
@@ -2047,16 +2358,10 @@ BG_FindModelScaleForClass
 */
 float BG_FindModelScaleForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	if (bg_classOverrideList[pclass].modelScale != 0.0f)
-		return bg_classOverrideList[pclass].modelScale;
-
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].modelScale;
-		}
-	}
+	if (ca)
+		return ca->modelScale;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindModelScaleForClass( %d )\n",
@@ -2071,15 +2376,10 @@ BG_FindSkinNameForClass
 */
 char *BG_FindSkinNameForClass(int pclass)
 {
-	int i;
-
-	if (bg_classOverrideList[pclass].skinName[0] != 0)
-		return bg_classOverrideList[pclass].skinName;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass)
-			return bg_classList[i].skinName;
-	}
+	if (ca)
+		return ca->skinName;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindSkinNameForClass\n");
@@ -2094,16 +2394,10 @@ BG_FindShadowScaleForClass
 */
 float BG_FindShadowScaleForClass(int pclass)
 {
-	int i;
-
-	if (bg_classOverrideList[pclass].shadowScale != 0.0f)
-		return bg_classOverrideList[pclass].shadowScale;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].shadowScale;
-		}
-	}
+	if (ca)
+		return ca->shadowScale;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindShadowScaleForClass( %d )\n",
@@ -2118,15 +2412,10 @@ BG_FindHudNameForClass
 */
 char *BG_FindHudNameForClass(int pclass)
 {
-	int i;
-
-	if (bg_classOverrideList[pclass].hudName[0] != 0)
-		return bg_classOverrideList[pclass].hudName;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass)
-			return bg_classList[i].hudName;
-	}
+	if (ca)
+		return ca->hudName;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindHudNameForClass\n");
@@ -2141,15 +2430,13 @@ BG_FindStagesForClass
 */
 qboolean BG_FindStagesForClass(int pclass, stage_t stage)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			if (bg_classList[i].stages & (1 << stage))
-				return qtrue;
-			else
-				return qfalse;
-		}
+	if (ca) {
+		if (ca->stages & (1 << stage))
+			return qtrue;
+		else
+			return qfalse;
 	}
 
 	Com_Printf(S_COLOR_YELLOW
@@ -2165,73 +2452,25 @@ BG_FindBBoxForClass
 void BG_FindBBoxForClass(int pclass, vec3_t mins, vec3_t maxs, vec3_t cmaxs,
 			 vec3_t dmins, vec3_t dmaxs)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			if (mins != NULL) {
-				VectorCopy(bg_classList[i].mins, mins);
-
-				if (VectorLength
-				    (bg_classOverrideList[pclass].mins))
-					VectorCopy(bg_classOverrideList[pclass].
-						   mins, mins);
-			}
-
-			if (maxs != NULL) {
-				VectorCopy(bg_classList[i].maxs, maxs);
-
-				if (VectorLength
-				    (bg_classOverrideList[pclass].maxs))
-					VectorCopy(bg_classOverrideList[pclass].
-						   maxs, maxs);
-			}
-
-			if (cmaxs != NULL) {
-				VectorCopy(bg_classList[i].crouchMaxs, cmaxs);
-
-				if (VectorLength
-				    (bg_classOverrideList[pclass].crouchMaxs))
-					VectorCopy(bg_classOverrideList[pclass].
-						   crouchMaxs, cmaxs);
-			}
-
-			if (dmins != NULL) {
-				VectorCopy(bg_classList[i].deadMins, dmins);
-
-				if (VectorLength
-				    (bg_classOverrideList[pclass].deadMins))
-					VectorCopy(bg_classOverrideList[pclass].
-						   deadMins, dmins);
-			}
-
-			if (dmaxs != NULL) {
-				VectorCopy(bg_classList[i].deadMaxs, dmaxs);
-
-				if (VectorLength
-				    (bg_classOverrideList[pclass].deadMaxs))
-					VectorCopy(bg_classOverrideList[pclass].
-						   deadMaxs, dmaxs);
-			}
-
-			return;
-		}
-	}
+	if (!ca)
+		ca = &bg_classList[0];
 
 	if (mins != NULL)
-		VectorCopy(bg_classList[0].mins, mins);
+		VectorCopy(ca->mins, mins);
 
 	if (maxs != NULL)
-		VectorCopy(bg_classList[0].maxs, maxs);
+		VectorCopy(ca->maxs, maxs);
 
 	if (cmaxs != NULL)
-		VectorCopy(bg_classList[0].crouchMaxs, cmaxs);
+		VectorCopy(ca->crouchMaxs, cmaxs);
 
 	if (dmins != NULL)
-		VectorCopy(bg_classList[0].deadMins, dmins);
+		VectorCopy(ca->deadMins, dmins);
 
 	if (dmaxs != NULL)
-		VectorCopy(bg_classList[0].deadMaxs, dmaxs);
+		VectorCopy(ca->deadMaxs, dmaxs);
 }
 
 /*
@@ -2241,16 +2480,10 @@ BG_FindZOffsetForClass
 */
 float BG_FindZOffsetForClass(int pclass)
 {
-	int i;
-
-	if (bg_classOverrideList[pclass].zOffset != 0.0f)
-		return bg_classOverrideList[pclass].zOffset;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].zOffset;
-		}
-	}
+	if (ca)
+		return ca->zOffset;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindZOffsetForClass\n");
@@ -2264,23 +2497,15 @@ BG_FindViewheightForClass
 */
 void BG_FindViewheightForClass(int pclass, int *viewheight, int *cViewheight)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 	int vh = 0;
 	int cvh = 0;
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			vh = bg_classList[i].viewheight;
-			cvh = bg_classList[i].crouchViewheight;
-			break;
-		}
+	if (ca) {
+		vh = ca->viewheight;
+		cvh = ca->crouchViewheight;
 	}
 
-	if (bg_classOverrideList[pclass].viewheight != 0)
-		vh = bg_classOverrideList[pclass].viewheight;
-	if (bg_classOverrideList[pclass].crouchViewheight != 0)
-		cvh = bg_classOverrideList[pclass].crouchViewheight;
-
 	if (vh == 0)
 		vh = bg_classList[0].viewheight;
 	if (cvh == 0)
@@ -2299,13 +2524,10 @@ BG_FindHealthForClass
 */
 int BG_FindHealthForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].health;
-		}
-	}
+	if (ca)
+		return ca->health;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindHealthForClass\n");
@@ -2319,13 +2541,10 @@ BG_FindFallDamageForClass
 */
 float BG_FindFallDamageForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].fallDamage;
-		}
-	}
+	if (ca)
+		return ca->fallDamage;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindFallDamageForClass\n");
@@ -2339,13 +2558,10 @@ BG_FindRegenRateForClass
 */
 int BG_FindRegenRateForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].regenRate;
-		}
-	}
+	if (ca)
+		return ca->regenRate;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindRegenRateForClass\n");
@@ -2359,13 +2575,10 @@ BG_FindFovForClass
 */
 int BG_FindFovForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].fov;
-		}
-	}
+	if (ca)
+		return ca->fov;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindFovForClass\n");
@@ -2379,13 +2592,10 @@ BG_FindBobForClass
 */
 float BG_FindBobForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].bob;
-		}
-	}
+	if (ca)
+		return ca->bob;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindBobForClass\n");
@@ -2399,13 +2609,10 @@ BG_FindBobCycleForClass
 */
 float BG_FindBobCycleForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].bobCycle;
-		}
-	}
+	if (ca)
+		return ca->bobCycle;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindBobCycleForClass\n");
@@ -2419,13 +2626,10 @@ BG_FindSpeedForClass
 */
 float BG_FindSpeedForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].speed;
-		}
-	}
+	if (ca)
+		return ca->speed;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindSpeedForClass\n");
@@ -2439,13 +2643,10 @@ BG_FindAccelerationForClass
 */
 float BG_FindAccelerationForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].acceleration;
-		}
-	}
+	if (ca)
+		return ca->acceleration;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindAccelerationForClass\n");
@@ -2459,13 +2660,10 @@ BG_FindAirAccelerationForClass
 */
 float BG_FindAirAccelerationForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].airAcceleration;
-		}
-	}
+	if (ca)
+		return ca->airAcceleration;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindAirAccelerationForClass\n");
@@ -2479,13 +2677,10 @@ BG_FindFrictionForClass
 */
 float BG_FindFrictionForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].friction;
-		}
-	}
+	if (ca)
+		return ca->friction;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindFrictionForClass\n");
@@ -2499,13 +2694,10 @@ BG_FindStopSpeedForClass
 */
 float BG_FindStopSpeedForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].stopSpeed;
-		}
-	}
+	if (ca)
+		return ca->stopSpeed;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindStopSpeedForClass\n");
@@ -2519,13 +2711,10 @@ BG_FindJumpMagnitudeForClass
 */
 float BG_FindJumpMagnitudeForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].jumpMagnitude;
-		}
-	}
+	if (ca)
+		return ca->jumpMagnitude;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindJumpMagnitudeForClass\n");
@@ -2539,13 +2728,10 @@ BG_FindKnockbackScaleForClass
 */
 float BG_FindKnockbackScaleForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].knockbackScale;
-		}
-	}
+	if (ca)
+		return ca->knockbackScale;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindKnockbackScaleForClass\n");
@@ -2559,13 +2745,10 @@ BG_FindSteptimeForClass
 */
 int BG_FindSteptimeForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].steptime;
-		}
-	}
+	if (ca)
+		return ca->steptime;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindSteptimeForClass\n");
@@ -2579,13 +2762,10 @@ BG_ClassHasAbility
 */
 qboolean BG_ClassHasAbility(int pclass, int ability)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return (bg_classList[i].abilities & ability);
-		}
-	}
+	if (ca)
+		return (ca->abilities & ability);
 
 	return qfalse;
 }
@@ -2597,13 +2777,10 @@ BG_FindStartWeaponForClass
 */
 weapon_t BG_FindStartWeaponForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].startWeapon;
-		}
-	}
+	if (ca)
+		return ca->startWeapon;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindStartWeaponForClass\n");
@@ -2617,13 +2794,10 @@ BG_FindBuildDistForClass
 */
 float BG_FindBuildDistForClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].buildDist;
-		}
-	}
+	if (ca)
+		return ca->buildDist;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindBuildDistForClass\n");
@@ -2637,7 +2811,8 @@ BG_ClassCanEvolveFromTo
 */
 int BG_ClassCanEvolveFromTo(int fclass, int tclass, int credits, int num)
 {
-	int i, j, cost;
+	const classAttributes_t *ca;
+	int j, cost;
 
 	cost = BG_FindCostOfClass(tclass);
 
@@ -2648,29 +2823,22 @@ int BG_ClassCanEvolveFromTo(int fclass, int tclass, int credits, int num)
 	if (fclass == PCL_NONE || tclass == PCL_NONE)
 		return -1;
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == fclass) {
-			for (j = 0; j < 3; j++)
-				if (bg_classList[i].children[j] == tclass)
-					return num + cost;
-
-			for (j = 0; j < 3; j++) {
-				int sub;
-
-				cost =
-				    BG_FindCostOfClass(bg_classList[i].
-						       children[j]);
-				sub =
-				    BG_ClassCanEvolveFromTo(bg_classList[i].
-							    children[j], tclass,
-							    credits - cost,
-							    num + cost);
-				if (sub >= 0)
-					return sub;
-			}
+	ca = BG_Class(fclass);
+	if (!ca)
+		return -1;
 
-			return -1;	//may as well return by this point
-		}
+	for (j = 0; j < 3; j++)
+		if (ca->children[j] == tclass)
+			return num + cost;
+
+	for (j = 0; j < 3; j++) {
+		int sub;
+
+		cost = BG_FindCostOfClass(ca->children[j]);
+		sub = BG_ClassCanEvolveFromTo(ca->children[j], tclass,
+					      credits - cost, num + cost);
+		if (sub >= 0)
+			return sub;
 	}
 
 	return -1;
@@ -2683,13 +2851,10 @@ BG_FindValueOfClass
 */
 int BG_FindValueOfClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].value;
-		}
-	}
+	if (ca)
+		return ca->value;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindValueOfClass\n");
@@ -2703,13 +2868,10 @@ BG_FindCostOfClass
 */
 int BG_FindCostOfClass(int pclass)
 {
-	int i;
+	const classAttributes_t *ca = BG_Class(pclass);
 
-	for (i = 0; i < bg_numPclasses; i++) {
-		if (bg_classList[i].classNum == pclass) {
-			return bg_classList[i].cost;
-		}
-	}
+	if (ca)
+		return ca->cost;
 
 	Com_Printf(S_COLOR_YELLOW
 		   "WARNING: fallthrough in BG_FindCostOfClass\n");
@@ -2916,21 +3078,44 @@ static qboolean BG_ParseClassFile(const char *filename,
 ===============
 BG_InitClassOverrides
 
-Set any overrides specfied by file
+Set any overrides specfied by file, from the bundle if it's up to date,
+then rebuild the table the accessors use
 ===============
 */
 void BG_InitClassOverrides(void)
 {
 	int i;
+	char *name;
+	unsigned int hash;
 	classAttributeOverrides_t *cao;
 
-	for (i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++) {
-		cao = BG_FindOverrideForClass(i);
+	hash = BG_HashOverrideFiles("overrides/classes", PCL_NONE + 1,
+				    PCL_NUM_CLASSES, BG_FindNameForClassNum);
+
+	if (!BG_ReadOverrideBundle("overrides/classes.bundle", hash,
+				   bg_classOverrideList,
+				   sizeof(bg_classOverrideList[0]),
+				   PCL_NUM_CLASSES)) {
+		memset(bg_classOverrideList, 0, sizeof(bg_classOverrideList));
 
-		BG_ParseClassFile(va
-				  ("overrides/classes/%s.cfg",
-				   BG_FindNameForClassNum(i)), cao);
+		for (i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++) {
+			cao = BG_FindOverrideForClass(i);
+			name = BG_FindNameForClassNum(i);
+
+			if (!name)
+				continue;
+
+			BG_ParseClassFile(va("overrides/classes/%s.cfg", name),
+					  cao);
+		}
+
+		BG_WriteOverrideBundle("overrides/classes.bundle", hash,
+				       bg_classOverrideList,
+				       sizeof(bg_classOverrideList[0]),
+				       PCL_NUM_CLASSES);
 	}
+
+	BG_BuildClassTable();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3615,21 +3800,82 @@ weaponAttributes_t bg_weapons[] = {
 
 int bg_numWeapons = sizeof(bg_weapons) / sizeof(bg_weapons[0]);
 
+//bg_weapons indexed by weaponNum
+static weaponAttributes_t *bg_weaponTable[WP_NUM_WEAPONS];
+static qboolean bg_weaponTableBuilt = qfalse;
+
 /*
 ==============
-BG_FindPriceForWeapon
+BG_BuildWeaponTable
+
+Index bg_weapons by weaponNum.  bg_weapons isn't in weapon_t order, so only
+check that every weapon but WP_NONE is in it exactly once.
 ==============
 */
-int BG_FindPriceForWeapon(int weapon)
+static void BG_BuildWeaponTable(void)
 {
-	int i;
+	int i, num;
+
+	memset(bg_weaponTable, 0, sizeof(bg_weaponTable));
 
 	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].price;
+		num = bg_weapons[i].weaponNum;
+
+		if (num <= WP_NONE || num >= WP_NUM_WEAPONS) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: bg_weapons[ %d ] has invalid "
+				   "weaponNum %d\n", i, num);
+			continue;
+		}
+
+		if (bg_weaponTable[num]) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: weaponNum %d is in bg_weapons "
+				   "twice\n", num);
+			continue;
 		}
+
+		bg_weaponTable[num] = &bg_weapons[i];
+	}
+
+	for (i = WP_NONE + 1; i < WP_NUM_WEAPONS; i++) {
+		if (!bg_weaponTable[i])
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: weaponNum %d is missing from "
+				   "bg_weapons\n", i);
 	}
 
+	bg_weaponTableBuilt = qtrue;
+}
+
+/*
+==============
+BG_Weapon
+==============
+*/
+static const weaponAttributes_t *BG_Weapon(int weapon)
+{
+	if (!bg_weaponTableBuilt)
+		BG_BuildWeaponTable();
+
+	if (weapon < 0 || weapon >= WP_NUM_WEAPONS)
+		return NULL;
+
+	return bg_weaponTable[weapon];
+}
+
+/*
+==============
+BG_FindPriceForWeapon
+==============
+*/
+int BG_FindPriceForWeapon(int weapon)
+{
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
+
+	if (wa)
+		return wa->price;
+
 	return 100;
 }
 
@@ -3640,15 +3886,13 @@ BG_FindStagesForWeapon
 */
 qboolean BG_FindStagesForWeapon(int weapon, stage_t stage)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			if (bg_weapons[i].stages & (1 << stage))
-				return qtrue;
-			else
-				return qfalse;
-		}
+	if (wa) {
+		if (wa->stages & (1 << stage))
+			return qtrue;
+		else
+			return qfalse;
 	}
 
 	return qfalse;
@@ -3661,13 +3905,10 @@ BG_FindSlotsForWeapon
 */
 int BG_FindSlotsForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].slots;
-		}
-	}
+	if (wa)
+		return wa->slots;
 
 	return SLOT_WEAPON;
 }
@@ -3679,12 +3920,10 @@ BG_FindNameForWeapon
 */
 char *BG_FindNameForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon)
-			return bg_weapons[i].weaponName;
-	}
+	if (wa)
+		return wa->weaponName;
 
 	//wimp out
 	return 0;
@@ -3715,12 +3954,10 @@ BG_FindHumanNameForWeapon
 */
 char *BG_FindHumanNameForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon)
-			return bg_weapons[i].weaponHumanName;
-	}
+	if (wa)
+		return wa->weaponHumanName;
 
 	//wimp out
 	return 0;
@@ -3755,13 +3992,10 @@ BG_FindInfinteAmmoForWeapon
 */
 qboolean BG_FindInfinteAmmoForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].infiniteAmmo;
-		}
-	}
+	if (wa)
+		return wa->infiniteAmmo;
 
 	return qfalse;
 }
@@ -3773,13 +4007,10 @@ BG_FindUsesEnergyForWeapon
 */
 qboolean BG_FindUsesEnergyForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].usesEnergy;
-		}
-	}
+	if (wa)
+		return wa->usesEnergy;
 
 	return qfalse;
 }
@@ -3791,12 +4022,10 @@ BG_FindRepeatRate1ForWeapon
 */
 int BG_FindRepeatRate1ForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon)
-			return bg_weapons[i].repeatRate1;
-	}
+	if (wa)
+		return wa->repeatRate1;
 
 	return 1000;
 }
@@ -3808,12 +4037,10 @@ BG_FindRepeatRate2ForWeapon
 */
 int BG_FindRepeatRate2ForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon)
-			return bg_weapons[i].repeatRate2;
-	}
+	if (wa)
+		return wa->repeatRate2;
 
 	return 1000;
 }
@@ -3825,12 +4052,10 @@ BG_FindRepeatRate3ForWeapon
 */
 int BG_FindRepeatRate3ForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon)
-			return bg_weapons[i].repeatRate3;
-	}
+	if (wa)
+		return wa->repeatRate3;
 
 	return 1000;
 }
@@ -3842,13 +4067,10 @@ BG_FindReloadTimeForWeapon
 */
 int BG_FindReloadTimeForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].reloadTime;
-		}
-	}
+	if (wa)
+		return wa->reloadTime;
 
 	return 1000;
 }
@@ -3860,13 +4082,10 @@ BG_FindKnockbackScaleForWeapon
 */
 float BG_FindKnockbackScaleForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].knockbackScale;
-		}
-	}
+	if (wa)
+		return wa->knockbackScale;
 
 	return 1.0f;
 }
@@ -3878,13 +4097,10 @@ BG_WeaponHasAltMode
 */
 qboolean BG_WeaponHasAltMode(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].hasAltMode;
-		}
-	}
+	if (wa)
+		return wa->hasAltMode;
 
 	return qfalse;
 }
@@ -3896,13 +4112,10 @@ BG_WeaponHasThirdMode
 */
 qboolean BG_WeaponHasThirdMode(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].hasThirdMode;
-		}
-	}
+	if (wa)
+		return wa->hasThirdMode;
 
 	return qfalse;
 }
@@ -3914,13 +4127,10 @@ BG_WeaponCanZoom
 */
 qboolean BG_WeaponCanZoom(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].canZoom;
-		}
-	}
+	if (wa)
+		return wa->canZoom;
 
 	return qfalse;
 }
@@ -3932,13 +4142,10 @@ BG_FindZoomFovForWeapon
 */
 float BG_FindZoomFovForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].zoomFov;
-		}
-	}
+	if (wa)
+		return wa->zoomFov;
 
 	return qfalse;
 }
@@ -3950,13 +4157,10 @@ BG_FindPurchasableForWeapon
 */
 qboolean BG_FindPurchasableForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].purchasable;
-		}
-	}
+	if (wa)
+		return wa->purchasable;
 
 	return qfalse;
 }
@@ -3968,13 +4172,10 @@ BG_FindLongRangeForWeapon
 */
 qboolean BG_FindLongRangedForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].longRanged;
-		}
-	}
+	if (wa)
+		return wa->longRanged;
 
 	return qfalse;
 }
@@ -3986,13 +4187,10 @@ BG_FindBuildDelayForWeapon
 */
 int BG_FindBuildDelayForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].buildDelay;
-		}
-	}
+	if (wa)
+		return wa->buildDelay;
 
 	return 0;
 }
@@ -4004,13 +4202,10 @@ BG_FindTeamForWeapon
 */
 WUTeam_t BG_FindTeamForWeapon(int weapon)
 {
-	int i;
+	const weaponAttributes_t *wa = BG_Weapon(weapon);
 
-	for (i = 0; i < bg_numWeapons; i++) {
-		if (bg_weapons[i].weaponNum == weapon) {
-			return bg_weapons[i].team;
-		}
-	}
+	if (wa)
+		return wa->team;
 
 	return WUT_NONE;
 }
@@ -4118,21 +4313,87 @@ upgradeAttributes_t bg_upgrades[] = {
 
 int bg_numUpgrades = sizeof(bg_upgrades) / sizeof(bg_upgrades[0]);
 
+//bg_upgrades indexed by upgradeNum
+static upgradeAttributes_t *bg_upgradeTable[UP_NUM_UPGRADES];
+static qboolean bg_upgradeTableBuilt = qfalse;
+
 /*
 ==============
-BG_FindPriceForUpgrade
+BG_BuildUpgradeTable
+
+Index bg_upgrades by upgradeNum, complaining if it has drifted from the
+order of upgrade_t
 ==============
 */
-int BG_FindPriceForUpgrade(int upgrade)
+static void BG_BuildUpgradeTable(void)
 {
-	int i;
+	int i, num;
+
+	memset(bg_upgradeTable, 0, sizeof(bg_upgradeTable));
 
 	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade) {
-			return bg_upgrades[i].price;
+		num = bg_upgrades[i].upgradeNum;
+
+		if (num <= UP_NONE || num >= UP_NUM_UPGRADES) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: bg_upgrades[ %d ] has invalid "
+				   "upgradeNum %d\n", i, num);
+			continue;
+		}
+
+		if (bg_upgradeTable[num]) {
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: upgradeNum %d is in bg_upgrades "
+				   "twice\n", num);
+			continue;
 		}
+
+		if (num != i + 1)
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: bg_upgrades[ %d ] is out of order "
+				   "(upgradeNum %d)\n", i, num);
+
+		bg_upgradeTable[num] = &bg_upgrades[i];
+	}
+
+	for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
+		if (!bg_upgradeTable[i])
+			Com_Printf(S_COLOR_YELLOW
+				   "WARNING: upgradeNum %d is missing from "
+				   "bg_upgrades\n", i);
 	}
 
+	bg_upgradeTableBuilt = qtrue;
+}
+
+/*
+==============
+BG_Upgrade
+==============
+*/
+static const upgradeAttributes_t *BG_Upgrade(int upgrade)
+{
+	if (!bg_upgradeTableBuilt)
+		BG_BuildUpgradeTable();
+
+	if (upgrade < 0 || upgrade >= UP_NUM_UPGRADES)
+		return NULL;
+
+	return bg_upgradeTable[upgrade];
+}
+
+/*
+==============
+BG_FindPriceForUpgrade
+==============
+*/
+int BG_FindPriceForUpgrade(int upgrade)
+{
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
+
+	if (ua)
+		return ua->price;
+
 	return 100;
 }
 
@@ -4143,15 +4404,13 @@ BG_FindStagesForUpgrade
 */
 qboolean BG_FindStagesForUpgrade(int upgrade, stage_t stage)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade) {
-			if (bg_upgrades[i].stages & (1 << stage))
-				return qtrue;
-			else
-				return qfalse;
-		}
+	if (ua) {
+		if (ua->stages & (1 << stage))
+			return qtrue;
+		else
+			return qfalse;
 	}
 
 	return qfalse;
@@ -4164,13 +4423,10 @@ BG_FindSlotsForUpgrade
 */
 int BG_FindSlotsForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade) {
-			return bg_upgrades[i].slots;
-		}
-	}
+	if (ua)
+		return ua->slots;
 
 	return SLOT_NONE;
 }
@@ -4182,12 +4438,10 @@ BG_FindNameForUpgrade
 */
 char *BG_FindNameForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade)
-			return bg_upgrades[i].upgradeName;
-	}
+	if (ua)
+		return ua->upgradeName;
 
 	//wimp out
 	return 0;
@@ -4218,12 +4472,10 @@ BG_FindHumanNameForUpgrade
 */
 char *BG_FindHumanNameForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade)
-			return bg_upgrades[i].upgradeHumanName;
-	}
+	if (ua)
+		return ua->upgradeHumanName;
 
 	//wimp out
 	return 0;
@@ -4236,12 +4488,10 @@ BG_FindIconForUpgrade
 */
 char *BG_FindIconForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade)
-			return bg_upgrades[i].icon;
-	}
+	if (ua)
+		return ua->icon;
 
 	//wimp out
 	return 0;
@@ -4254,12 +4504,10 @@ BG_FindPurchasableForUpgrade
 */
 qboolean BG_FindPurchasableForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade)
-			return bg_upgrades[i].purchasable;
-	}
+	if (ua)
+		return ua->purchasable;
 
 	return qfalse;
 }
@@ -4271,12 +4519,10 @@ BG_FindUsableForUpgrade
 */
 qboolean BG_FindUsableForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade)
-			return bg_upgrades[i].usable;
-	}
+	if (ua)
+		return ua->usable;
 
 	return qfalse;
 }
@@ -4288,13 +4534,10 @@ BG_FindTeamForUpgrade
 */
 WUTeam_t BG_FindTeamForUpgrade(int upgrade)
 {
-	int i;
+	const upgradeAttributes_t *ua = BG_Upgrade(upgrade);
 
-	for (i = 0; i < bg_numUpgrades; i++) {
-		if (bg_upgrades[i].upgradeNum == upgrade) {
-			return bg_upgrades[i].team;
-		}
-	}
+	if (ua)
+		return ua->team;
 
 	return WUT_NONE;
 }
@@ -60,6 +60,75 @@ void PM_AddEvent(int newEvent)
 	BG_AddPredictableEventToPlayerstate(newEvent, 0, pm->ps);
 }
 
+// traces already made by this PmoveSingle.  Nothing in the world moves
+// during a pmove, so the same query always gets the same answer.
+#define PM_TRACE_CACHE_SIZE 16
+
+typedef struct {
+	vec3_t start, end;
+	vec3_t mins, maxs;
+	int passEntityNum;
+	int contentMask;
+	trace_t trace;
+} pmTraceCache_t;
+
+static pmTraceCache_t pm_traceCache[PM_TRACE_CACHE_SIZE];
+static int pm_traceCacheUsed;
+static int pm_traceCacheNext;
+
+/*
+===============
+PM_Trace
+
+pm->trace, answered from the cache when the same trace has already been
+made this PmoveSingle
+===============
+*/
+void PM_Trace(trace_t * results, const vec3_t start, const vec3_t mins,
+	      const vec3_t maxs, const vec3_t end, int passEntityNum,
+	      int contentMask)
+{
+	pmTraceCache_t *cache;
+	int i;
+
+	// the engine treats missing bounds as a point
+	if (!mins)
+		mins = vec3_origin;
+	if (!maxs)
+		maxs = vec3_origin;
+
+	for (i = 0; i < pm_traceCacheUsed; i++) {
+		cache = &pm_traceCache[i];
+
+		if (VectorCompare(cache->start, start) &&
+		    VectorCompare(cache->end, end) &&
+		    VectorCompare(cache->mins, mins) &&
+		    VectorCompare(cache->maxs, maxs) &&
+		    cache->passEntityNum == passEntityNum &&
+		    cache->contentMask == contentMask) {
+			*results = cache->trace;
+			pm->traceCacheHits++;
+			return;
+		}
+	}
+
+	pm->trace(results, start, mins, maxs, end, passEntityNum, contentMask);
+	pm->traceCount++;
+
+	cache = &pm_traceCache[pm_traceCacheNext];
+	pm_traceCacheNext = (pm_traceCacheNext + 1) % PM_TRACE_CACHE_SIZE;
+	if (pm_traceCacheUsed < PM_TRACE_CACHE_SIZE)
+		pm_traceCacheUsed++;
+
+	VectorCopy(start, cache->start);
+	VectorCopy(end, cache->end);
+	VectorCopy(mins, cache->mins);
+	VectorCopy(maxs, cache->maxs);
+	cache->passEntityNum = passEntityNum;
+	cache->contentMask = contentMask;
+	cache->trace = *results;
+}
+
 /*
 ===============
 PM_AddTouchEnt
@@ -1349,8 +1418,8 @@ static void PM_CheckLadder(void)
 
 	VectorMA(pm->ps->origin, 1.0f, forward, end);
 
-	pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs, end,
-		  pm->ps->clientNum, MASK_PLAYERSOLID);
+	PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs, end,
+		 pm->ps->clientNum, MASK_PLAYERSOLID);
 
 	if ((trace.fraction < 1.0f) && (trace.surfaceFlags & SURF_LADDER))
 		pml.ladder = qtrue;
@@ -1584,19 +1653,19 @@ static int PM_CorrectAllSolid(trace_t * trace)
 				point[0] += (float)i;
 				point[1] += (float)j;
 				point[2] += (float)k;
-				pm->trace(trace, point, pm->mins, pm->maxs,
-					  point, pm->ps->clientNum,
-					  pm->tracemask);
+				PM_Trace(trace, point, pm->mins, pm->maxs,
+					 point, pm->ps->clientNum,
+					 pm->tracemask);
 
 				if (!trace->allsolid) {
 					point[0] = pm->ps->origin[0];
 					point[1] = pm->ps->origin[1];
 					point[2] = pm->ps->origin[2] - 0.25;
 
-					pm->trace(trace, pm->ps->origin,
-						  pm->mins, pm->maxs, point,
-						  pm->ps->clientNum,
-						  pm->tracemask);
+					PM_Trace(trace, pm->ps->origin,
+						 pm->mins, pm->maxs, point,
+						 pm->ps->clientNum,
+						 pm->tracemask);
 					pml.groundTrace = *trace;
 					return qtrue;
 				}
@@ -1633,8 +1702,8 @@ static void PM_GroundTraceMissed(void)
 		VectorCopy(pm->ps->origin, point);
 		point[2] -= 64.0f;
 
-		pm->trace(&trace, pm->ps->origin, NULL, NULL, point,
-			  pm->ps->clientNum, pm->tracemask);
+		PM_Trace(&trace, pm->ps->origin, NULL, NULL, point,
+			 pm->ps->clientNum, pm->tracemask);
 		if (trace.fraction == 1.0f) {
 			if (pm->cmd.forwardmove >= 0) {
 				if (!
@@ -1693,6 +1762,7 @@ static void PM_GroundClimbTrace(void)
 	float ldDOTtCs, d;
 	vec3_t abc;
 	vec3_t normalDelta;
+	int predictedStep = -1;
 
 	//TA: If we're on the ceiling then grapplePoint is a rotation normal.. otherwise its a surface normal.
 	//    would have been nice if Carmack had left a few random variables in the ps struct for mod makers
@@ -1721,31 +1791,39 @@ static void PM_GroundClimbTrace(void)
 	for (i = 0; i <= 4; i++) {
 		switch (i) {
 		case 0:
+			//the origin doesn't change until something is hit, so
+			//cases 0 and 2 can share one prediction
+			if (predictedStep < 0)
+				predictedStep = PM_PredictStepMove();
+
 			//we are going to step this frame so skip the transition test
-			if (PM_PredictStepMove())
+			if (predictedStep)
 				continue;
 
 			//trace into direction we are moving
 			VectorMA(pm->ps->origin, 0.25f, movedir, point);
-			pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
-				  point, pm->ps->clientNum, pm->tracemask);
+			PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
+				 point, pm->ps->clientNum, pm->tracemask);
 			break;
 
 		case 1:
 			//trace straight down anto "ground" surface
 			VectorMA(pm->ps->origin, -0.25f, surfNormal, point);
-			pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
-				  point, pm->ps->clientNum, pm->tracemask);
+			PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
+				 point, pm->ps->clientNum, pm->tracemask);
 			break;
 
 		case 2:
-			if (pml.groundPlane != qfalse && PM_PredictStepMove()) {
+			if (pml.groundPlane != qfalse && predictedStep < 0)
+				predictedStep = PM_PredictStepMove();
+
+			if (pml.groundPlane != qfalse && predictedStep) {
 				//step down
 				VectorMA(pm->ps->origin, -STEPSIZE, surfNormal,
 					 point);
-				pm->trace(&trace, pm->ps->origin, pm->mins,
-					  pm->maxs, point, pm->ps->clientNum,
-					  pm->tracemask);
+				PM_Trace(&trace, pm->ps->origin, pm->mins,
+					 pm->maxs, point, pm->ps->clientNum,
+					 pm->tracemask);
 			} else
 				continue;
 			break;
@@ -1756,9 +1834,9 @@ static void PM_GroundClimbTrace(void)
 				VectorMA(pm->ps->origin, -16.0f, surfNormal,
 					 point);
 				VectorMA(point, -16.0f, movedir, point);
-				pm->trace(&trace, pm->ps->origin, pm->mins,
-					  pm->maxs, point, pm->ps->clientNum,
-					  pm->tracemask);
+				PM_Trace(&trace, pm->ps->origin, pm->mins,
+					 pm->maxs, point, pm->ps->clientNum,
+					 pm->tracemask);
 			} else
 				continue;
 			break;
@@ -1767,8 +1845,8 @@ static void PM_GroundClimbTrace(void)
 			//fall back so we don't have to modify PM_GroundTrace too much
 			VectorCopy(pm->ps->origin, point);
 			point[2] = pm->ps->origin[2] - 0.25f;
-			pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
-				  point, pm->ps->clientNum, pm->tracemask);
+			PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
+				 point, pm->ps->clientNum, pm->tracemask);
 			break;
 		}
 
@@ -1792,43 +1870,43 @@ static void PM_GroundClimbTrace(void)
 
 				VectorCopy(trace.endpos, pm->ps->origin);
 			}
-			//calculate a bunch of stuff...
-			CrossProduct(trace.plane.normal, surfNormal,
-				     traceCROSSsurf);
-			VectorNormalize(traceCROSSsurf);
+			//if the trace result and old surface normal are different then we must have transided to a new
+			//surface... do some stuff...
+			if (!VectorCompare(trace.plane.normal, surfNormal)) {
+				//calculate a bunch of stuff... only needed for a transition
+				CrossProduct(trace.plane.normal, surfNormal,
+					     traceCROSSsurf);
+				VectorNormalize(traceCROSSsurf);
 
-			CrossProduct(trace.plane.normal, refNormal,
-				     traceCROSSref);
-			VectorNormalize(traceCROSSref);
+				CrossProduct(trace.plane.normal, refNormal,
+					     traceCROSSref);
+				VectorNormalize(traceCROSSref);
 
-			CrossProduct(surfNormal, refNormal, surfCROSSref);
-			VectorNormalize(surfCROSSref);
+				CrossProduct(surfNormal, refNormal, surfCROSSref);
+				VectorNormalize(surfCROSSref);
 
-			//calculate angle between surf and trace
-			traceDOTsurf =
-			    DotProduct(trace.plane.normal, surfNormal);
-			traceANGsurf = RAD2DEG(acos(traceDOTsurf));
+				//calculate angle between surf and trace
+				traceDOTsurf =
+				    DotProduct(trace.plane.normal, surfNormal);
+				traceANGsurf = RAD2DEG(acos(traceDOTsurf));
 
-			if (traceANGsurf > 180.0f)
-				traceANGsurf -= 180.0f;
+				if (traceANGsurf > 180.0f)
+					traceANGsurf -= 180.0f;
 
-			//calculate angle between trace and ref
-			traceDOTref = DotProduct(trace.plane.normal, refNormal);
-			traceANGref = RAD2DEG(acos(traceDOTref));
+				//calculate angle between trace and ref
+				traceDOTref = DotProduct(trace.plane.normal, refNormal);
+				traceANGref = RAD2DEG(acos(traceDOTref));
 
-			if (traceANGref > 180.0f)
-				traceANGref -= 180.0f;
+				if (traceANGref > 180.0f)
+					traceANGref -= 180.0f;
 
-			//calculate angle between surf and ref
-			surfDOTref = DotProduct(surfNormal, refNormal);
-			surfANGref = RAD2DEG(acos(surfDOTref));
+				//calculate angle between surf and ref
+				surfDOTref = DotProduct(surfNormal, refNormal);
+				surfANGref = RAD2DEG(acos(surfDOTref));
 
-			if (surfANGref > 180.0f)
-				surfANGref -= 180.0f;
+				if (surfANGref > 180.0f)
+					surfANGref -= 180.0f;
 
-			//if the trace result and old surface normal are different then we must have transided to a new
-			//surface... do some stuff...
-			if (!VectorCompare(trace.plane.normal, surfNormal)) {
 				//if the trace result or the old vector is not the floor or ceiling correct the YAW angle
 				if (!VectorCompare
 				    (trace.plane.normal, refNormal)
@@ -1955,6 +2033,9 @@ static void PM_GroundClimbTrace(void)
 			// do something corrective if the trace starts in a solid...
 			if (!PM_CorrectAllSolid(&trace))
 				return;
+
+			// that changed the ground the prediction started from
+			predictedStep = -1;
 		}
 	}
 
@@ -2070,8 +2151,8 @@ static void PM_GroundTrace(void)
 	point[1] = pm->ps->origin[1];
 	point[2] = pm->ps->origin[2] - 0.25f;
 
-	pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs, point,
-		  pm->ps->clientNum, pm->tracemask);
+	PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs, point,
+		 pm->ps->clientNum, pm->tracemask);
 
 	pml.groundTrace = trace;
 
@@ -2094,8 +2175,8 @@ static void PM_GroundTrace(void)
 			point[0] = pm->ps->origin[0];
 			point[1] = pm->ps->origin[1];
 			point[2] = pm->ps->origin[2] - STEPSIZE;
-			pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
-				  point, pm->ps->clientNum, pm->tracemask);
+			PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
+				 point, pm->ps->clientNum, pm->tracemask);
 
 			//if we hit something
 			if (trace.fraction < 1.0f) {
@@ -2129,9 +2210,9 @@ static void PM_GroundTrace(void)
 				}
 				//trace into direction we are moving
 				VectorMA(pm->ps->origin, 0.25f, movedir, point);
-				pm->trace(&trace, pm->ps->origin, pm->mins,
-					  pm->maxs, point, pm->ps->clientNum,
-					  pm->tracemask);
+				PM_Trace(&trace, pm->ps->origin, pm->mins,
+					 pm->maxs, point, pm->ps->clientNum,
+					 pm->tracemask);
 
 				if (trace.fraction < 1.0f
 				    && !(trace.
@@ -2314,9 +2395,9 @@ static void PM_CheckDuck(void)
 		if (pm->ps->pm_flags & PMF_DUCKED) {
 			// try to stand up
 			pm->maxs[2] = PCmaxs[2];
-			pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
-				  pm->ps->origin, pm->ps->clientNum,
-				  pm->tracemask);
+			PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs,
+				 pm->ps->origin, pm->ps->clientNum,
+				 pm->tracemask);
 			if (!trace.allsolid)
 				pm->ps->pm_flags &= ~PMF_DUCKED;
 		}
@@ -3287,6 +3368,8 @@ void PmoveSingle(pmove_t * pmove)
 	}
 	// clear all pmove local vars
 	memset(&pml, 0, sizeof(pml));
+	pm_traceCacheUsed = 0;
+	pm_traceCacheNext = 0;
 
 	// determine the time
 	pml.msec = pmove->cmd.serverTime - pm->ps->commandTime;
@@ -3435,6 +3518,9 @@ void Pmove(pmove_t * pmove)
 	    (pmove->ps->pmove_framecount + 1) & ((1 << PS_PMOVEFRAMECOUNTBITS) -
 						 1);
 
+	pmove->traceCount = 0;
+	pmove->traceCacheHits = 0;
+
 	// chop the move up if it is too long, to prevent framerate
 	// dependent behavior
 	while (pmove->ps->commandTime != finalTime) {
@@ -174,6 +174,9 @@ typedef struct {
 
 	float xyspeed;
 
+	int traceCount;		// traces passed on to the trace callback
+	int traceCacheHits;	// traces answered from the pmove trace cache
+
 	// for fixed msec Pmove
 	int pmove_fixed;
 	int pmove_msec;
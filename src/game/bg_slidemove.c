@@ -97,8 +97,8 @@ qboolean PM_SlideMove(qboolean gravity)
 		VectorMA(pm->ps->origin, time_left, pm->ps->velocity, end);
 
 		// see if we can make it there
-		pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs, end,
-			  pm->ps->clientNum, pm->tracemask);
+		PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs, end,
+			 pm->ps->clientNum, pm->tracemask);
 
 		if (trace.allsolid) {
 			// entity is completely trapped in another solid
@@ -301,8 +301,8 @@ qboolean PM_StepSlideMove(qboolean gravity, qboolean predictive)
 	if (PM_SlideMove(gravity) == 0) {
 		VectorCopy(start_o, down);
 		VectorMA(down, -STEPSIZE, normal, down);
-		pm->trace(&trace, start_o, pm->mins, pm->maxs, down,
-			  pm->ps->clientNum, pm->tracemask);
+		PM_Trace(&trace, start_o, pm->mins, pm->maxs, down,
+			 pm->ps->clientNum, pm->tracemask);
 
 		//we can step down
 		if (trace.fraction > 0.01f && trace.fraction < 1.0f &&
@@ -315,8 +315,8 @@ qboolean PM_StepSlideMove(qboolean gravity, qboolean predictive)
 	} else {
 		VectorCopy(start_o, down);
 		VectorMA(down, -STEPSIZE, normal, down);
-		pm->trace(&trace, start_o, pm->mins, pm->maxs, down,
-			  pm->ps->clientNum, pm->tracemask);
+		PM_Trace(&trace, start_o, pm->mins, pm->maxs, down,
+			 pm->ps->clientNum, pm->tracemask);
 		// never step up when you still have up velocity
 		if (DotProduct(trace.plane.normal, pm->ps->velocity) > 0.0f &&
 		    (trace.fraction == 1.0f
@@ -328,8 +328,8 @@ qboolean PM_StepSlideMove(qboolean gravity, qboolean predictive)
 		VectorMA(up, STEPSIZE, normal, up);
 
 		// test the player position if they were a stepheight higher
-		pm->trace(&trace, start_o, pm->mins, pm->maxs, up,
-			  pm->ps->clientNum, pm->tracemask);
+		PM_Trace(&trace, start_o, pm->mins, pm->maxs, up,
+			 pm->ps->clientNum, pm->tracemask);
 		if (trace.allsolid) {
 			if (pm->debugLevel)
 				Com_Printf("%i:bend can't step\n", c_pmove);
@@ -356,8 +356,8 @@ qboolean PM_StepSlideMove(qboolean gravity, qboolean predictive)
 		// push down the final amount
 		VectorCopy(pm->ps->origin, down);
 		VectorMA(down, -stepSize, normal, down);
-		pm->trace(&trace, pm->ps->origin, pm->mins, pm->maxs, down,
-			  pm->ps->clientNum, pm->tracemask);
+		PM_Trace(&trace, pm->ps->origin, pm->mins, pm->maxs, down,
+			 pm->ps->clientNum, pm->tracemask);
 
 		if (!trace.allsolid)
 			VectorCopy(trace.endpos, pm->ps->origin);
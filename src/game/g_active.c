@@ -1892,6 +1892,7 @@ void ClientThink_real(gentity_t * ent)
 				G_SetBuildableAnim(hovel, BANIM_ATTACK2,
 						   qfalse);
 				hovel->active = qfalse;
+				level.buildGeneration++;
 			} else {
 				//exit is blocked
 				G_TriggerMenu(ent->client->ps.clientNum,
@@ -2016,6 +2017,7 @@ void ClientThink(int clientNum)
 
 	ent = g_entities + clientNum;
 	trap_GetUsercmd(clientNum, &ent->client->pers.cmd);
+	G_CmdRecordThink(clientNum, &ent->client->pers.cmd);
 
 	// mark the time we got info, so we can display the
 	// phone jack if they don't get any for a while
@@ -2123,6 +2125,9 @@ void ClientEndFrame(gentity_t * ent)
 {
 	clientPersistant_t *pers;
 
+	// send off everything queued for this client during the frame
+	G_FlushServerCommands(ent - g_entities);
+
 	if (ent->client->sess.sessionTeam == TEAM_SPECTATOR) {
 		SpectatorClientEndFrame(ent);
 		return;
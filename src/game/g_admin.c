@@ -536,7 +536,42 @@ g_admin_level_t *g_admin_levels[MAX_ADMIN_LEVELS];
 g_admin_admin_t *g_admin_admins[MAX_ADMIN_ADMINS];
 g_admin_ban_t *g_admin_bans[MAX_ADMIN_BANS];
 g_admin_command_t *g_admin_commands[MAX_ADMIN_COMMANDS];
-g_admin_namelog_t *g_admin_namelog[MAX_ADMIN_NAMELOGS];
+
+// trigram indexes of sanitised admin and namelog names, with room for
+// every trigram of every name they can hold
+static nameIndexNode_t admin_adminIndexNodes[MAX_ADMIN_ADMINS *
+					     NAMEINDEX_MAX_TRIGRAMS];
+static nameIndexNode_t admin_namelogIndexNodes[MAX_ADMIN_NAMELOGS *
+					       MAX_ADMIN_NAMELOG_NAMES *
+					       NAMEINDEX_MAX_TRIGRAMS];
+static nameIndex_t admin_adminIndex = {
+	admin_adminIndexNodes,
+	sizeof(admin_adminIndexNodes) / sizeof(admin_adminIndexNodes[0])
+};
+static nameIndex_t admin_namelogIndex = {
+	admin_namelogIndexNodes,
+	sizeof(admin_namelogIndexNodes) / sizeof(admin_namelogIndexNodes[0])
+};
+
+static int admin_match_admin(int id, const char *search)
+{
+	if (id < 0 || id >= MAX_ADMIN_ADMINS || !g_admin_admins[id])
+		return 0;
+
+	return G_NameMatchRank(g_admin_admins[id]->sanitised, search);
+}
+
+static void admin_index_admin(int id, g_admin_admin_t * a)
+{
+	G_SanitiseString(a->name, a->sanitised, sizeof(a->sanitised));
+	G_NameIndexAdd(&admin_adminIndex, id, a->sanitised);
+}
+
+static void admin_unindex_admin(int id, g_admin_admin_t * a)
+{
+	G_NameIndexRemove(&admin_adminIndex, id, a->sanitised);
+}
+
 
 static int admin_adminlog_index = 0;
 g_admin_adminlog_t *g_admin_adminlog[MAX_ADMIN_ADMINLOGS];
@@ -616,7 +651,6 @@ qboolean G_admin_name_check(gentity_t * ent, char *name, char *err, int len)
 {
 	int i;
 	gclient_t *client;
-	char testName[MAX_NAME_LENGTH] = { "" };
 	char name2[MAX_NAME_LENGTH] = { "" };
 	int alphaCount = 0;
 
@@ -641,9 +675,7 @@ qboolean G_admin_name_check(gentity_t * ent, char *name, char *err, int len)
 		if (i == (ent - g_entities))
 			continue;
 
-		G_SanitiseString(client->pers.netname, testName,
-				 sizeof(testName));
-		if (!Q_stricmp(name2, testName)) {
+		if (!Q_stricmp(name2, client->pers.sanitisedName)) {
 			Q_strncpyz(err,
 				   va("The name '%s^7' is already in use",
 				      name), len);
@@ -686,9 +718,7 @@ qboolean G_admin_name_check(gentity_t * ent, char *name, char *err, int len)
 	for (i = 0; i < MAX_ADMIN_ADMINS && g_admin_admins[i]; i++) {
 		if (g_admin_admins[i]->level < 1)
 			continue;
-		G_SanitiseString(g_admin_admins[i]->name, testName,
-				 sizeof(testName));
-		if (!Q_stricmp(name2, testName)
+		if (!Q_stricmp(name2, g_admin_admins[i]->sanitised)
 		    && Q_stricmp(ent->client->pers.guid,
 				 g_admin_admins[i]->guid)) {
 			Q_strncpyz(err,
@@ -875,44 +905,51 @@ void admin_writeconfig(void)
 
 static void admin_readconfig_string(char **cnf, char *s, int size)
 {
-	char *t;
+	tokenSpan_t t;
+	int len = 0;
 
 	//COM_MatchToken(cnf, "=");
-	t = COM_ParseExt(cnf, qfalse);
-	if (!strcmp(t, "=")) {
-		t = COM_ParseExt(cnf, qfalse);
+	COM_ParseSpan(cnf, qfalse, &t);
+	if (t.length == 1 && t.text[0] == '=') {
+		COM_ParseSpan(cnf, qfalse, &t);
 	} else {
 		G_Printf("readconfig: warning missing = before "
-			 "\"%s\" on line %d\n", t, COM_GetCurrentParseLine());
+			 "\"%s\" on line %d\n", COM_SpanToken(&t),
+			 COM_GetCurrentParseLine());
 	}
 	s[0] = '\0';
-	while (t[0]) {
-		if ((s[0] == '\0' && strlen(t) <= size)
-		    || (strlen(t) + strlen(s) < size)) {
-
-			Q_strcat(s, size, t);
-			Q_strcat(s, size, " ");
+	while (t.length) {
+		if ((len == 0 && t.length <= size) || (t.length + len < size)) {
+			COM_SpanCopy(&t, s + len, size - len);
+			len += strlen(s + len);
+			if (len < size - 1) {
+				s[len++] = ' ';
+				s[len] = '\0';
+			}
 		}
-		t = COM_ParseExt(cnf, qfalse);
+		COM_ParseSpan(cnf, qfalse, &t);
 	}
 	// trim the trailing space
-	if (strlen(s) > 0 && s[strlen(s) - 1] == ' ')
-		s[strlen(s) - 1] = '\0';
+	if (len > 0 && s[len - 1] == ' ')
+		s[len - 1] = '\0';
 }
 
 static void admin_readconfig_int(char **cnf, int *v)
 {
-	char *t;
+	tokenSpan_t t;
+	char number[16];
 
 	//COM_MatchToken(cnf, "=");
-	t = COM_ParseExt(cnf, qfalse);
-	if (!strcmp(t, "=")) {
-		t = COM_ParseExt(cnf, qfalse);
+	COM_ParseSpan(cnf, qfalse, &t);
+	if (t.length == 1 && t.text[0] == '=') {
+		COM_ParseSpan(cnf, qfalse, &t);
 	} else {
 		G_Printf("readconfig: warning missing = before "
-			 "\"%s\" on line %d\n", t, COM_GetCurrentParseLine());
+			 "\"%s\" on line %d\n", COM_SpanToken(&t),
+			 COM_GetCurrentParseLine());
 	}
-	*v = atoi(t);
+	COM_SpanCopy(&t, number, sizeof(number));
+	*v = atoi(number);
 }
 
 // if we can't parse any levels from readconfig, set up default
@@ -1077,6 +1114,7 @@ static void admin_log(gentity_t * admin, char *cmd, int skiparg)
 	gentity_t *victim = NULL;
 	int pids[MAX_CLIENTS];
 	char name[MAX_NAME_LENGTH];
+	logEvent_t ev;
 
 	if (!g_adminLog.string[0])
 		return;
@@ -1177,18 +1215,36 @@ static void admin_log(gentity_t * admin, char *cmd, int skiparg)
 		    (admin) ? admin->client->pers.netname : "console",
 		    (admin) ? admin->client->pers.adminName : "console", cmd,
 		    G_SayConcatArgs(1 + skiparg));
+
+	if (G_LogEventBegin(&ev, "admin")) {
+		G_LogEventInt(&ev, "client", (admin) ? admin->s.clientNum : -1);
+		G_LogEventString(&ev, "name",
+				 (admin) ? admin->client->pers.
+				 netname : "console");
+		G_LogEventString(&ev, "adminName",
+				 (admin) ? admin->client->pers.
+				 adminName : "console");
+		G_LogEventInt(&ev, "level", G_admin_level(admin));
+		G_LogEventString(&ev, "command", cmd);
+		if (victim) {
+			G_LogEventInt(&ev, "victim", victim - g_entities);
+			G_LogEventString(&ev, "victimName",
+					 victim->client->pers.netname);
+		}
+		G_LogEventString(&ev, "args", G_SayConcatArgs(1 + skiparg));
+		G_LogEventEnd(&ev);
+	}
 }
 
 static int admin_listadmins(gentity_t * ent, int start, char *search,
 			    int minlevel)
 {
+	static int matches[MAX_ADMIN_ADMINS];
 	int drawn = 0;
 	char guid_stub[9];
-	char name[MAX_NAME_LENGTH] = { "" };
-	char name2[MAX_NAME_LENGTH] = { "" };
 	char lname[MAX_NAME_LENGTH] = { "" };
 	char lname_fmt[5];
-	int i, j;
+	int i, j, k, numMatches;
 	gentity_t *vic;
 	int l = 0;
 	qboolean dup = qfalse;
@@ -1204,8 +1260,7 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 
 		l = vic->client->pers.adminLevel;
 
-		G_SanitiseString(vic->client->pers.netname, name, sizeof(name));
-		if (!strstr(name, search))
+		if (!strstr(vic->client->pers.sanitisedName, search))
 			continue;
 
 		for (j = 0; j < 8; j++)
@@ -1218,7 +1273,7 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 			if (g_admin_levels[j]->level == l) {
 				G_DecolorString(g_admin_levels[j]->name, lname);
 				Com_sprintf(lname_fmt, sizeof(lname_fmt),
-					    "%%%is",
+					    "%%-%is",
 					    (int)(admin_level_maxname +
 						  strlen(g_admin_levels[j]->
 							 name)
@@ -1233,8 +1288,21 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 		drawn++;
 	}
 
-	for (i = 0; i < MAX_ADMIN_ADMINS && g_admin_admins[i]
-	     && drawn < MAX_ADMIN_LISTITEMS; i++)
+	// when searching, go through the matching admins best match first
+	if (search[0]) {
+		numMatches = G_NameIndexSearch(&admin_adminIndex, search,
+					       admin_match_admin, matches,
+					       MAX_ADMIN_ADMINS);
+		if (numMatches > MAX_ADMIN_ADMINS)
+			numMatches = MAX_ADMIN_ADMINS;
+	} else {
+		for (numMatches = 0; numMatches < MAX_ADMIN_ADMINS &&
+		     g_admin_admins[numMatches]; numMatches++)
+			matches[numMatches] = numMatches;
+	}
+
+	for (k = 0; k < numMatches && drawn < MAX_ADMIN_LISTITEMS; k++) {
+		i = matches[k];
 		if (g_admin_admins[i]->level >= minlevel) {
 
 			if (start) {
@@ -1243,11 +1311,6 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 			}
 
 			if (search[0]) {
-				G_SanitiseString(g_admin_admins[i]->name, name,
-						 sizeof(name));
-				if (!strstr(name, search))
-					continue;
-
 				// verify we don't have the same guid/name pair in connected players
 				// since we don't want to draw the same player twice
 				dup = qfalse;
@@ -1257,13 +1320,11 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 					    || vic->client->pers.connected !=
 					    CON_CONNECTED)
 						continue;
-					G_SanitiseString(vic->client->pers.
-							 netname, name2,
-							 sizeof(name2));
 					if (!Q_stricmp
 					    (vic->client->pers.guid,
 					     g_admin_admins[i]->guid)
-					    && strstr(name2, search)) {
+					    && strstr(vic->client->pers.
+						      sanitisedName, search)) {
 						dup = qtrue;
 						break;
 					}
@@ -1284,7 +1345,7 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 					G_DecolorString(g_admin_levels[j]->name,
 							lname);
 					Com_sprintf(lname_fmt,
-						    sizeof(lname_fmt), "%%%is",
+						    sizeof(lname_fmt), "%%-%is",
 						    (int)(admin_level_maxname +
 							  strlen(g_admin_levels
 								 [j]->name)
@@ -1301,6 +1362,7 @@ static int admin_listadmins(gentity_t * ent, int start, char *search,
 				 lname, guid_stub, g_admin_admins[i]->name));
 			drawn++;
 		}
+	}
 	ADMBP_end();
 	return drawn;
 }
@@ -1578,59 +1640,771 @@ qboolean G_admin_cmd_check(gentity_t * ent, qboolean say)
 	return qfalse;
 }
 
-void G_admin_namelog_cleanup()
+/*
+================
+Namelog storage
+
+Namelogs live in a fixed pool.  They are kept on a list ordered from least
+to most recently seen, so that when the pool is full the oldest
+disconnected player is the one forgotten, and are hashed by IP and by GUID
+so that connecting players don't need a walk over every namelog.
+================
+*/
+
+static void schachtmeisterUnschedule(g_admin_namelog_t * namelog);
+
+static g_admin_namelog_t admin_namelogPool[MAX_ADMIN_NAMELOGS];
+static int admin_namelogPoolUsed;
+
+g_admin_namelog_t *g_admin_namelogs;
+static g_admin_namelog_t *admin_namelogTail;
+
+static g_admin_namelog_t *admin_namelogIP[ADMIN_NAMELOG_HASH_SIZE];
+static g_admin_namelog_t *admin_namelogGUID[ADMIN_NAMELOG_HASH_SIZE];
+static g_admin_namelog_t *admin_namelogSlot[MAX_CLIENTS];
+
+static void admin_namelog_index(g_admin_namelog_t * namelog)
 {
-	int i;
+	int j;
+
+	for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES && namelog->name[j][0]; j++)
+		G_NameIndexAdd(&admin_namelogIndex, namelog - admin_namelogPool,
+			       namelog->sanitised[j]);
+}
 
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
-		if (g_admin_namelog[i]->smj.comment)
-			G_Free(g_admin_namelog[i]->smj.comment);
-		G_Free(g_admin_namelog[i]);
-		g_admin_namelog[i] = NULL;
+static void admin_namelog_unindex(g_admin_namelog_t * namelog)
+{
+	int j;
+
+	for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES && namelog->name[j][0]; j++)
+		G_NameIndexRemove(&admin_namelogIndex,
+				  namelog - admin_namelogPool,
+				  namelog->sanitised[j]);
+}
+
+static int admin_match_namelog(int id, const char *search)
+{
+	g_admin_namelog_t *namelog;
+	int j, rank, best = 0;
+
+	if (id < 0 || id >= admin_namelogPoolUsed)
+		return 0;
+
+	namelog = &admin_namelogPool[id];
+	for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES && namelog->name[j][0]; j++) {
+		rank = G_NameMatchRank(namelog->sanitised[j], search);
+		if (rank > best)
+			best = rank;
 	}
+
+	return best;
+}
+
+static int admin_match_unbanned_namelog(int id, const char *search)
+{
+	if (id < 0 || id >= admin_namelogPoolUsed ||
+	    admin_namelogPool[id].banned)
+		return 0;
+
+	return admin_match_namelog(id, search);
+}
+
+static int admin_namelog_hash(const char *s)
+{
+	unsigned hash = 0;
+
+	while (*s)
+		hash = hash * 31 + tolower(*s++);
+
+	return hash & (ADMIN_NAMELOG_HASH_SIZE - 1);
+}
+
+static void admin_namelog_unlink(g_admin_namelog_t * namelog)
+{
+	g_admin_namelog_t **p;
+
+	for (p = &admin_namelogIP[admin_namelog_hash(namelog->ip)]; *p;
+	     p = &(*p)->ipNext) {
+		if (*p == namelog) {
+			*p = namelog->ipNext;
+			break;
+		}
+	}
+
+	for (p = &admin_namelogGUID[admin_namelog_hash(namelog->guid)]; *p;
+	     p = &(*p)->guidNext) {
+		if (*p == namelog) {
+			*p = namelog->guidNext;
+			break;
+		}
+	}
+
+	if (namelog->prev)
+		namelog->prev->next = namelog->next;
+	else
+		g_admin_namelogs = namelog->next;
+
+	if (namelog->next)
+		namelog->next->prev = namelog->prev;
+	else
+		admin_namelogTail = namelog->prev;
+
+	if (namelog->slot >= 0 && namelog->slot < MAX_CLIENTS &&
+	    admin_namelogSlot[namelog->slot] == namelog)
+		admin_namelogSlot[namelog->slot] = NULL;
+}
+
+// move a namelog to the most recently seen end of the list
+static void admin_namelog_touch(g_admin_namelog_t * namelog)
+{
+	namelog->seen = trap_RealTime(NULL);
+
+	if (namelog == admin_namelogTail)
+		return;
+
+	if (namelog->prev)
+		namelog->prev->next = namelog->next;
+	else
+		g_admin_namelogs = namelog->next;
+	namelog->next->prev = namelog->prev;
+
+	namelog->prev = admin_namelogTail;
+	namelog->next = NULL;
+	admin_namelogTail->next = namelog;
+	admin_namelogTail = namelog;
+}
+
+static void admin_namelog_set_slot(g_admin_namelog_t * namelog, int slot)
+{
+	if (namelog->slot >= 0 && namelog->slot < MAX_CLIENTS &&
+	    admin_namelogSlot[namelog->slot] == namelog)
+		admin_namelogSlot[namelog->slot] = NULL;
+
+	namelog->slot = slot;
+
+	if (slot >= 0 && slot < MAX_CLIENTS) {
+		// only one client can be in a slot, anything else is stale
+		if (admin_namelogSlot[slot] && admin_namelogSlot[slot] != namelog)
+			admin_namelogSlot[slot]->slot = -1;
+		admin_namelogSlot[slot] = namelog;
+	}
+}
+
+static g_admin_namelog_t *admin_namelog_new(const char *ip, const char *guid)
+{
+	g_admin_namelog_t *namelog = NULL;
+	int hash;
+
+	if (admin_namelogPoolUsed < MAX_ADMIN_NAMELOGS)
+		namelog = &admin_namelogPool[admin_namelogPoolUsed++];
+	else {
+		// forget whoever was seen longest ago and isn't connected
+		for (namelog = g_admin_namelogs; namelog; namelog = namelog->next) {
+			if (namelog->slot == -1)
+				break;
+		}
+
+		if (!namelog) {
+			G_Printf("admin_namelog_new: warning, no namelog to "
+				 "replace\n");
+			return NULL;
+		}
+
+		admin_namelog_unlink(namelog);
+		admin_namelog_unindex(namelog);
+		schachtmeisterUnschedule(namelog);
+		if (namelog->smj.comment)
+			G_Free(namelog->smj.comment);
+	}
+
+	memset(namelog, 0, sizeof(*namelog));
+	Q_strncpyz(namelog->ip, ip, sizeof(namelog->ip));
+	Q_strncpyz(namelog->guid, guid, sizeof(namelog->guid));
+	namelog->slot = -1;
+	namelog->seen = trap_RealTime(NULL);
+
+	hash = admin_namelog_hash(namelog->ip);
+	namelog->ipNext = admin_namelogIP[hash];
+	admin_namelogIP[hash] = namelog;
+
+	hash = admin_namelog_hash(namelog->guid);
+	namelog->guidNext = admin_namelogGUID[hash];
+	admin_namelogGUID[hash] = namelog;
+
+	namelog->prev = admin_namelogTail;
+	if (admin_namelogTail)
+		admin_namelogTail->next = namelog;
+	else
+		g_admin_namelogs = namelog;
+	admin_namelogTail = namelog;
+
+	return namelog;
+}
+
+// store a name, replacing the same name in other colours if it's known
+static void admin_namelog_add_name(g_admin_namelog_t * namelog,
+				   const char *name, const char *sanitised)
+{
+	int j;
+	qboolean reindex;
+
+	for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES && namelog->name[j][0]; j++) {
+		if (!Q_stricmp(sanitised, namelog->sanitised[j]))
+			break;
+	}
+	if (j == MAX_ADMIN_NAMELOG_NAMES)
+		j = MAX_ADMIN_NAMELOG_NAMES - 1;
+
+	reindex = !namelog->name[j][0] || strcmp(sanitised,
+						 namelog->sanitised[j]);
+	if (reindex)
+		admin_namelog_unindex(namelog);
+
+	Q_strncpyz(namelog->name[j], name, sizeof(namelog->name[j]));
+	Q_strncpyz(namelog->sanitised[j], sanitised,
+		   sizeof(namelog->sanitised[j]));
+
+	if (reindex)
+		admin_namelog_index(namelog);
+}
+
+/*
+================
+G_admin_namelog_find
+
+The namelog for an IP, or failing that for a GUID
+================
+*/
+g_admin_namelog_t *G_admin_namelog_find(const char *ip, const char *guid)
+{
+	g_admin_namelog_t *namelog;
+
+	for (namelog = admin_namelogIP[admin_namelog_hash(ip)]; namelog;
+	     namelog = namelog->ipNext) {
+		if (!Q_stricmp(namelog->ip, ip))
+			return namelog;
+	}
+
+	for (namelog = admin_namelogGUID[admin_namelog_hash(guid)]; namelog;
+	     namelog = namelog->guidNext) {
+		if (!Q_stricmp(namelog->guid, guid))
+			return namelog;
+	}
+
+	return NULL;
+}
+
+/*
+================
+G_admin_namelog_slot
+
+The namelog of the client in a slot
+================
+*/
+g_admin_namelog_t *G_admin_namelog_slot(int slot)
+{
+	if (slot < 0 || slot >= MAX_CLIENTS)
+		return NULL;
+
+	return admin_namelogSlot[slot];
+}
+
+/*
+================
+G_admin_namelog_readfile
+
+Load the namelogs saved in g_adminNamelogFile at the end of the last map.
+Each line is guid, ip, seen, banned and then the names, separated by tabs,
+which ClientCleanName never lets into a name.
+================
+*/
+static void admin_namelog_parse(char *line)
+{
+	char *field[4 + MAX_ADMIN_NAMELOG_NAMES];
+	char sanitised[MAX_NAME_LENGTH];
+	g_admin_namelog_t *namelog;
+	int i, n = 1;
+
+	field[0] = line;
+	for (; *line && n < sizeof(field) / sizeof(field[0]); line++) {
+		if (*line == '\t') {
+			*line = '\0';
+			field[n++] = line + 1;
+		}
+	}
+	if (n < 5 || !field[0][0] || !field[1][0])
+		return;
+
+	namelog = admin_namelog_new(field[1], field[0]);
+	if (!namelog)
+		return;
+
+	namelog->seen = atoi(field[2]);
+	namelog->banned = atoi(field[3]);
+
+	for (i = 4; i < n; i++) {
+		if (!field[i][0])
+			continue;
+		G_SanitiseString(field[i], sanitised, sizeof(sanitised));
+		admin_namelog_add_name(namelog, field[i], sanitised);
+	}
+}
+
+void G_admin_namelog_readfile(void)
+{
+	fileHandle_t f;
+	char buf[4096];
+	int len, chunk, used = 0, count = 0;
+	char *line, *end;
+
+	if (!g_adminNamelogFile.string[0])
+		return;
+
+	len = trap_FS_FOpenFile(g_adminNamelogFile.string, &f, FS_READ);
+	if (len < 0)
+		return;
+
+	while (len > 0 || used > 0) {
+		chunk = sizeof(buf) - 1 - used;
+		if (chunk > len)
+			chunk = len;
+		if (chunk > 0) {
+			trap_FS_Read(buf + used, chunk, f);
+			used += chunk;
+			len -= chunk;
+		}
+		buf[used] = '\0';
+
+		line = buf;
+		while ((end = strchr(line, '\n')) || (!len && *line)) {
+			if (end)
+				*end = '\0';
+			if (line[0] && Q_strncmp(line, "namelog ", 8)) {
+				admin_namelog_parse(line);
+				count++;
+			}
+			line = end ? end + 1 : line + strlen(line);
+		}
+
+		used -= line - buf;
+		if (used >= sizeof(buf) - 1)
+			used = 0;	// no newline in a full buffer, drop it
+		memmove(buf, line, used);
+		if (!len)
+			break;
+	}
+
+	trap_FS_FCloseFile(f);
+	G_Printf("namelog: loaded %d entries from %s\n", count,
+		 g_adminNamelogFile.string);
+}
+
+static void admin_namelog_writefile(void)
+{
+	fileHandle_t f;
+	g_admin_namelog_t *namelog;
+	char buf[4096];
+	char line[MAX_STRING_CHARS];
+	int i, used = 0, length;
+
+	if (!g_adminNamelogFile.string[0])
+		return;
+
+	if (trap_FS_FOpenFile(g_adminNamelogFile.string, &f, FS_WRITE) < 0) {
+		G_Printf("admin_namelog_writefile: could not open \"%s\"\n",
+			 g_adminNamelogFile.string);
+		return;
+	}
+
+	trap_FS_Write("namelog 1\n", 10, f);
+
+	for (namelog = g_admin_namelogs; namelog; namelog = namelog->next) {
+		Com_sprintf(line, sizeof(line), "%s\t%s\t%d\t%d", namelog->guid,
+			    namelog->ip, namelog->seen, namelog->banned);
+
+		for (i = 0; i < MAX_ADMIN_NAMELOG_NAMES && namelog->name[i][0];
+		     i++)
+			Q_strcat(line, sizeof(line), va("\t%s", namelog->name[i]));
+		Q_strcat(line, sizeof(line), "\n");
+
+		length = strlen(line);
+		if (used + length > sizeof(buf)) {
+			trap_FS_Write(buf, used, f);
+			used = 0;
+		}
+		memcpy(buf + used, line, length);
+		used += length;
+	}
+
+	if (used)
+		trap_FS_Write(buf, used, f);
+	trap_FS_FCloseFile(f);
+}
+
+/*
+================
+Schachtmeister
+
+Each namelog is woken from a timer queue (a binary heap on wakeTime) only
+when it has something to do: start a query, retry one that hasn't been
+answered, give up on it, or refresh a stale rating.  The IPs due in a frame
+are collected and sent together at the end of it, at most
+g_schachtmeisterBatch per smq command.  Answers are also remembered per /24
+so neighbouring addresses don't each need a query.
+
+g_schachtmeisterResponder picks where queries go: empty for the smq
+command, "print" to print them for something watching the console to answer
+with smr, or the name of a file of "<ip or prefix> <rating> [comment]"
+lines to answer them locally.
+================
+*/
+
+#define SM_RATING_LIFE    600000	// re-rate connected players this often
+#define SM_QUERY_TIMEOUT  60000	// give up on a query after this long
+#define SM_QUERY_RETRY    5000	// re-send an unanswered query this often
+
+#define SM_CACHE_SIZE     256	// power of two
+#define SM_BATCH_IPS      32
+
+typedef struct {
+	int prefix;		// first three octets
+	int time;
+	int rating;
+	char comment[MAX_STRING_CHARS / 4];
+	qboolean hasComment;
+} schachtmeisterCache_t;
+
+static g_admin_namelog_t *schachtmeisterHeap[MAX_ADMIN_NAMELOGS];
+static int schachtmeisterHeapSize;
+
+static schachtmeisterCache_t schachtmeisterCache[SM_CACHE_SIZE];
+
+static char schachtmeisterBatch[SM_BATCH_IPS][16];
+static int schachtmeisterBatchSize;
+
+static void schachtmeisterHeapSwap(int a, int b)
+{
+	g_admin_namelog_t *t = schachtmeisterHeap[a];
+
+	schachtmeisterHeap[a] = schachtmeisterHeap[b];
+	schachtmeisterHeap[b] = t;
+	schachtmeisterHeap[a]->smj.heapIndex = a + 1;
+	schachtmeisterHeap[b]->smj.heapIndex = b + 1;
+}
+
+static void schachtmeisterHeapFix(int i)
+{
+	int child;
+
+	while (i > 0 && schachtmeisterHeap[i]->smj.wakeTime <
+	       schachtmeisterHeap[(i - 1) / 2]->smj.wakeTime) {
+		schachtmeisterHeapSwap(i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+
+	while ((child = 2 * i + 1) < schachtmeisterHeapSize) {
+		if (child + 1 < schachtmeisterHeapSize &&
+		    schachtmeisterHeap[child + 1]->smj.wakeTime <
+		    schachtmeisterHeap[child]->smj.wakeTime)
+			child++;
+
+		if (schachtmeisterHeap[i]->smj.wakeTime <=
+		    schachtmeisterHeap[child]->smj.wakeTime)
+			break;
+
+		schachtmeisterHeapSwap(i, child);
+		i = child;
+	}
+}
+
+static void schachtmeisterUnschedule(g_admin_namelog_t * namelog)
+{
+	int i = namelog->smj.heapIndex - 1;
+
+	if (i < 0)
+		return;
+
+	namelog->smj.heapIndex = 0;
+	if (i == --schachtmeisterHeapSize)
+		return;
+
+	schachtmeisterHeap[i] = schachtmeisterHeap[schachtmeisterHeapSize];
+	schachtmeisterHeap[i]->smj.heapIndex = i + 1;
+	schachtmeisterHeapFix(i);
+}
+
+static void schachtmeisterSchedule(g_admin_namelog_t * namelog, int time)
+{
+	int i = namelog->smj.heapIndex - 1;
+
+	namelog->smj.wakeTime = time;
+
+	if (i < 0) {
+		i = schachtmeisterHeapSize++;
+		schachtmeisterHeap[i] = namelog;
+		namelog->smj.heapIndex = i + 1;
+	}
+
+	schachtmeisterHeapFix(i);
+}
+
+static int schachtmeisterPrefix(const char *ipa)
+{
+	int parts[4];
+
+	if (sscanf(ipa, "%i.%i.%i.%i", &parts[0], &parts[1], &parts[2],
+		   &parts[3]) != 4)
+		return -1;
+
+	return ((parts[0] & 255) << 16) | ((parts[1] & 255) << 8) |
+	    (parts[2] & 255);
+}
+
+static schachtmeisterCache_t *schachtmeisterCacheFind(const char *ipa)
+{
+	schachtmeisterCache_t *c;
+	int prefix = schachtmeisterPrefix(ipa);
+
+	if (prefix < 0)
+		return NULL;
+
+	c = &schachtmeisterCache[(prefix ^ (prefix >> 8)) & (SM_CACHE_SIZE - 1)];
+	if (c->prefix != prefix || !c->time ||
+	    level.time - c->time >= SM_RATING_LIFE)
+		return NULL;
+
+	return c;
+}
+
+static void schachtmeisterCacheStore(const char *ipa, int rating,
+				     const char *comment)
+{
+	schachtmeisterCache_t *c;
+	int prefix = schachtmeisterPrefix(ipa);
+
+	if (prefix < 0)
+		return;
+
+	c = &schachtmeisterCache[(prefix ^ (prefix >> 8)) & (SM_CACHE_SIZE - 1)];
+	c->prefix = prefix;
+	c->time = level.time;
+	c->rating = rating;
+	c->hasComment = (comment != NULL);
+	Q_strncpyz(c->comment, comment ? comment : "", sizeof(c->comment));
+}
+
+/*
+================
+schachtmeisterRespondFromFile
+
+Answer the queued IPs from a file instead of the real service, by way of
+smr console commands so the rest of the path is the same
+================
+*/
+static void schachtmeisterRespondFromFile(const char *filename)
+{
+	static char buf[16384];
+	fileHandle_t f;
+	char *line, *next, *p;
+	char pattern[32];
+	int i, len, rating;
+	qboolean answered[SM_BATCH_IPS];
+
+	len = trap_FS_FOpenFile(filename, &f, FS_READ);
+	if (len < 0) {
+		G_Printf("schachtmeister: could not open responder file %s\n",
+			 filename);
+		return;
+	}
+	if (len >= sizeof(buf))
+		len = sizeof(buf) - 1;
+	trap_FS_Read(buf, len, f);
+	buf[len] = '\0';
+	trap_FS_FCloseFile(f);
+
+	memset(answered, 0, sizeof(answered));
+
+	// the first line matching an address answers it
+	for (line = buf; line; line = next) {
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = '\0';
+		if ((p = strchr(line, '\r')))
+			*p = '\0';
+
+		for (i = 0, p = line; *p && *p != ' ' && *p != '\t' &&
+		     i < sizeof(pattern) - 1; i++)
+			pattern[i] = *p++;
+		pattern[i] = '\0';
+
+		while (*p == ' ' || *p == '\t')
+			p++;
+		if (!pattern[0] || pattern[0] == '#' || !*p)
+			continue;
+
+		rating = atoi(p);
+		while (*p && *p != ' ' && *p != '\t')
+			p++;
+		while (*p == ' ' || *p == '\t')
+			p++;
+
+		for (i = 0; i < schachtmeisterBatchSize; i++) {
+			if (answered[i])
+				continue;
+			if (strcmp(pattern, "*") &&
+			    Q_strncmp(schachtmeisterBatch[i], pattern,
+				      strlen(pattern)))
+				continue;
+
+			answered[i] = qtrue;
+			trap_SendConsoleCommand(EXEC_APPEND,
+						va("smr ipa %s %d %s\n",
+						   schachtmeisterBatch[i],
+						   rating, p));
+		}
+	}
+}
+
+static void schachtmeisterFlush(void)
+{
+	char cmd[MAX_STRING_CHARS];
+	int i, batch;
+
+	if (!schachtmeisterBatchSize)
+		return;
+
+	if (!g_schachtmeisterResponder.string[0] ||
+	    !Q_stricmp(g_schachtmeisterResponder.string, "print")) {
+		batch = g_schachtmeisterBatch.integer;
+		if (batch < 1)
+			batch = 1;
+
+		for (i = 0; i < schachtmeisterBatchSize; i++) {
+			if (i % batch == 0)
+				Q_strncpyz(cmd, "smq ipa", sizeof(cmd));
+			Q_strcat(cmd, sizeof(cmd),
+				 va(" \"%s\"", schachtmeisterBatch[i]));
+			if ((i + 1) % batch && i + 1 < schachtmeisterBatchSize)
+				continue;
+
+			Q_strcat(cmd, sizeof(cmd), "\n");
+			if (g_schachtmeisterResponder.string[0])
+				G_Printf("%s", cmd);
+			else
+				trap_SendConsoleCommand(EXEC_APPEND, cmd);
+		}
+	} else
+		schachtmeisterRespondFromFile(g_schachtmeisterResponder.string);
+
+	schachtmeisterBatchSize = 0;
 }
 
 static void dispatchSchachtmeisterIPAQuery(const char *ipa)
 {
-	trap_SendConsoleCommand(EXEC_APPEND, va("smq ipa \"%s\"\n", ipa));
+	int i;
+
+	for (i = 0; i < schachtmeisterBatchSize; i++) {
+		if (!strcmp(schachtmeisterBatch[i], ipa))
+			return;
+	}
+
+	if (schachtmeisterBatchSize == SM_BATCH_IPS)
+		schachtmeisterFlush();
+
+	Q_strncpyz(schachtmeisterBatch[schachtmeisterBatchSize++], ipa,
+		   sizeof(schachtmeisterBatch[0]));
 }
 
+static void schachtmeisterJudge(const char *ipa, int rating,
+				const char *comment);
+
 static void schachtmeisterProcess(g_admin_namelog_t * namelog)
 {
 	schachtmeisterJudgement_t *j = &namelog->smj;
-
-	if (!j->ratingTime || level.time - j->ratingTime >= 600000) {
-		if (j->queryTime)
+	schachtmeisterCache_t *c;
+
+	// waiting for an answer
+	if (j->queryTime) {
+		if (level.time - j->queryTime >= SM_QUERY_TIMEOUT) {
+			j->queryTime = j->dispatchTime = 0;
+			if (namelog->slot != -1)
+				schachtmeisterSchedule(namelog,
+						       level.time +
+						       SM_RATING_LIFE);
 			return;
+		}
+
+		if (level.time - j->dispatchTime >= SM_QUERY_RETRY) {
+			j->dispatchTime = level.time;
+			dispatchSchachtmeisterIPAQuery(namelog->ip);
+		}
+		schachtmeisterSchedule(namelog, j->dispatchTime + SM_QUERY_RETRY);
+		return;
+	}
 
-		j->queryTime = level.time;
-		goto dispatch;
+	if (j->ratingTime && level.time - j->ratingTime < SM_RATING_LIFE) {
+		if (namelog->slot != -1)
+			schachtmeisterSchedule(namelog,
+					       j->ratingTime + SM_RATING_LIFE);
+		return;
 	}
 
-	if (!j->queryTime || level.time - j->queryTime >= 60000)
+	// stale ratings of players who have left can wait until they're back
+	if (j->ratingTime && namelog->slot == -1)
 		return;
 
-	if (j->dispatchTime && level.time - j->dispatchTime < 5000)
+	if ((c = schachtmeisterCacheFind(namelog->ip))) {
+		schachtmeisterJudge(namelog->ip, c->rating,
+				    c->hasComment ? c->comment : NULL);
 		return;
+	}
 
-dispatch:
-	j->dispatchTime = level.time;
+	j->queryTime = j->dispatchTime = level.time;
 	dispatchSchachtmeisterIPAQuery(namelog->ip);
+	schachtmeisterSchedule(namelog, level.time + SM_QUERY_RETRY);
 }
 
 void G_admin_schachtmeisterFrame(void)
 {
-	int i;
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++)
-		schachtmeisterProcess(g_admin_namelog[i]);
+	g_admin_namelog_t *namelog;
+
+	while (schachtmeisterHeapSize &&
+	       schachtmeisterHeap[0]->smj.wakeTime <= level.time) {
+		namelog = schachtmeisterHeap[0];
+		schachtmeisterUnschedule(namelog);
+		schachtmeisterProcess(namelog);
+	}
+
+	schachtmeisterFlush();
+}
+
+void G_admin_namelog_cleanup()
+{
+	g_admin_namelog_t *namelog;
+
+	admin_namelog_writefile();
+
+	for (namelog = g_admin_namelogs; namelog; namelog = namelog->next) {
+		if (namelog->smj.comment)
+			G_Free(namelog->smj.comment);
+	}
+
+	g_admin_namelogs = admin_namelogTail = NULL;
+	admin_namelogPoolUsed = 0;
+	memset(admin_namelogIP, 0, sizeof(admin_namelogIP));
+	memset(admin_namelogGUID, 0, sizeof(admin_namelogGUID));
+	memset(admin_namelogSlot, 0, sizeof(admin_namelogSlot));
+	G_NameIndexClear(&admin_namelogIndex);
+
+	schachtmeisterHeapSize = 0;
+	schachtmeisterBatchSize = 0;
+	memset(schachtmeisterCache, 0, sizeof(schachtmeisterCache));
 }
 
 void G_admin_namelog_update(gclient_t * client, qboolean disconnect)
 {
-	int i, j;
 	g_admin_namelog_t *namelog;
 	char n1[MAX_NAME_LENGTH];
-	char n2[MAX_NAME_LENGTH];
 	int clientNum = (client - level.clients);
 
 	if (client->sess.invisible == qfalse) {
@@ -1638,140 +2412,123 @@ void G_admin_namelog_update(gclient_t * client, qboolean disconnect)
 	}
 
 	G_SanitiseString(client->pers.netname, n1, sizeof(n1));
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
-		if (disconnect && g_admin_namelog[i]->slot != clientNum)
-			continue;
 
-		if (!disconnect && !(g_admin_namelog[i]->slot == clientNum ||
-				     g_admin_namelog[i]->slot == -1)) {
-			continue;
+	if (disconnect) {
+		namelog = G_admin_namelog_slot(clientNum);
+		if (namelog && (Q_stricmp(client->pers.ip, namelog->ip) ||
+				Q_stricmp(client->pers.guid, namelog->guid)))
+			namelog = NULL;
+	} else {
+		for (namelog =
+		     admin_namelogGUID[admin_namelog_hash(client->pers.guid)];
+		     namelog; namelog = namelog->guidNext) {
+			if (namelog->slot != clientNum && namelog->slot != -1)
+				continue;
+
+			if (!Q_stricmp(client->pers.ip, namelog->ip)
+			    && !Q_stricmp(client->pers.guid, namelog->guid))
+				break;
 		}
+	}
 
-		if (!Q_stricmp(client->pers.ip, g_admin_namelog[i]->ip)
-		    && !Q_stricmp(client->pers.guid, g_admin_namelog[i]->guid)) {
-			for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES
-			     && g_admin_namelog[i]->name[j][0]; j++) {
-				G_SanitiseString(g_admin_namelog[i]->name[j],
-						 n2, sizeof(n2));
-				if (!Q_stricmp(n1, n2))
-					break;
+	if (namelog) {
+		admin_namelog_add_name(namelog, client->pers.netname, n1);
+		admin_namelog_set_slot(namelog, (disconnect) ? -1 : clientNum);
+		admin_namelog_touch(namelog);
+
+		// a returning player's rating may need refreshing
+		if (!disconnect && !namelog->smj.heapIndex)
+			schachtmeisterProcess(namelog);
+
+		// if this player is connecting, they are no longer banned
+		if (!disconnect)
+			namelog->banned = qfalse;
+
+		//check other things like if user was denybuild or muted or denyweapon and restore them
+		if (!disconnect) {
+			if (namelog->muted) {
+				client->pers.muted = qtrue;
+				client->pers.muteExpires =
+				    namelog->muteExpires;
+				G_AdminsPrintf
+				    ("^7%s^7's mute has been restored\n",
+				     client->pers.netname);
+				namelog->muted = qfalse;
 			}
-			if (j == MAX_ADMIN_NAMELOG_NAMES)
-				j = MAX_ADMIN_NAMELOG_NAMES - 1;
-			Q_strncpyz(g_admin_namelog[i]->name[j],
-				   client->pers.netname,
-				   sizeof(g_admin_namelog[i]->name[j]));
-			g_admin_namelog[i]->slot =
-			    (disconnect) ? -1 : clientNum;
-
-			// if this player is connecting, they are no longer banned
-			if (!disconnect)
-				g_admin_namelog[i]->banned = qfalse;
-
-			//check other things like if user was denybuild or muted or denyweapon and restore them
-			if (!disconnect) {
-				if (g_admin_namelog[i]->muted) {
-					client->pers.muted = qtrue;
-					client->pers.muteExpires =
-					    g_admin_namelog[i]->muteExpires;
-					G_AdminsPrintf
-					    ("^7%s^7's mute has been restored\n",
-					     client->pers.netname);
-					g_admin_namelog[i]->muted = qfalse;
-				}
-				if (g_admin_namelog[i]->denyBuild) {
-					client->pers.denyBuild = qtrue;
-					G_AdminsPrintf
-					    ("^7%s^7's Denybuild has been restored\n",
-					     client->pers.netname);
-					g_admin_namelog[i]->denyBuild = qfalse;
-				}
-				if (g_admin_namelog[i]->denyHumanWeapons > 0
-				    || g_admin_namelog[i]->denyAlienClasses >
-				    0) {
-					if (g_admin_namelog[i]->
-					    denyHumanWeapons > 0)
-						client->pers.denyHumanWeapons =
-						    g_admin_namelog[i]->
-						    denyHumanWeapons;
-					if (g_admin_namelog[i]->
-					    denyAlienClasses > 0)
-						client->pers.denyAlienClasses =
-						    g_admin_namelog[i]->
-						    denyAlienClasses;
-
-					G_AdminsPrintf
-					    ("^7%s^7's Denyweapon has been restored\n",
-					     client->pers.netname);
-					g_admin_namelog[i]->denyHumanWeapons =
-					    0;
-					g_admin_namelog[i]->denyAlienClasses =
-					    0;
-				}
-				if (g_admin_namelog[i]->specExpires > 0) {
-					client->pers.specExpires =
-					    g_admin_namelog[i]->specExpires;
-					G_AdminsPrintf
-					    ("^7%s^7's Putteam spectator has been restored\n",
-					     client->pers.netname);
-					g_admin_namelog[i]->specExpires = 0;
-				}
-				if (g_admin_namelog[i]->voteCount > 0) {
-					client->pers.voteCount =
-					    g_admin_namelog[i]->voteCount;
-					g_admin_namelog[i]->voteCount = 0;
-				}
-			} else {
-				//for mute
-				if (G_IsMuted(client)) {
-					g_admin_namelog[i]->muted = qtrue;
-					g_admin_namelog[i]->muteExpires =
-					    client->pers.muteExpires;
-				}
-				//denybuild
-				if (client->pers.denyBuild) {
-					g_admin_namelog[i]->denyBuild = qtrue;
-				}
-				//denyweapon humans
-				if (client->pers.denyHumanWeapons > 0) {
-					g_admin_namelog[i]->denyHumanWeapons =
-					    client->pers.denyHumanWeapons;
-				}
-				//denyweapon aliens
-				if (client->pers.denyAlienClasses > 0) {
-					g_admin_namelog[i]->denyAlienClasses =
-					    client->pers.denyAlienClasses;
-				}
-				//putteam spec
-				if (client->pers.specExpires > 0) {
-					g_admin_namelog[i]->specExpires =
-					    client->pers.specExpires;
-				}
-				if (client->pers.voteCount > 0) {
-					g_admin_namelog[i]->voteCount =
-					    client->pers.voteCount;
-				}
+			if (namelog->denyBuild) {
+				client->pers.denyBuild = qtrue;
+				G_AdminsPrintf
+				    ("^7%s^7's Denybuild has been restored\n",
+				     client->pers.netname);
+				namelog->denyBuild = qfalse;
+			}
+			if (namelog->denyHumanWeapons > 0
+			    || namelog->denyAlienClasses > 0) {
+				if (namelog->denyHumanWeapons > 0)
+					client->pers.denyHumanWeapons =
+					    namelog->denyHumanWeapons;
+				if (namelog->denyAlienClasses > 0)
+					client->pers.denyAlienClasses =
+					    namelog->denyAlienClasses;
+
+				G_AdminsPrintf
+				    ("^7%s^7's Denyweapon has been restored\n",
+				     client->pers.netname);
+				namelog->denyHumanWeapons = 0;
+				namelog->denyAlienClasses = 0;
+			}
+			if (namelog->specExpires > 0) {
+				client->pers.specExpires =
+				    namelog->specExpires;
+				G_AdminsPrintf
+				    ("^7%s^7's Putteam spectator has been restored\n",
+				     client->pers.netname);
+				namelog->specExpires = 0;
+			}
+			if (namelog->voteCount > 0) {
+				client->pers.voteCount = namelog->voteCount;
+				namelog->voteCount = 0;
+			}
+		} else {
+			//for mute
+			if (G_IsMuted(client)) {
+				namelog->muted = qtrue;
+				namelog->muteExpires =
+				    client->pers.muteExpires;
+			}
+			//denybuild
+			if (client->pers.denyBuild) {
+				namelog->denyBuild = qtrue;
+			}
+			//denyweapon humans
+			if (client->pers.denyHumanWeapons > 0) {
+				namelog->denyHumanWeapons =
+				    client->pers.denyHumanWeapons;
+			}
+			//denyweapon aliens
+			if (client->pers.denyAlienClasses > 0) {
+				namelog->denyAlienClasses =
+				    client->pers.denyAlienClasses;
+			}
+			//putteam spec
+			if (client->pers.specExpires > 0) {
+				namelog->specExpires =
+				    client->pers.specExpires;
+			}
+			if (client->pers.voteCount > 0) {
+				namelog->voteCount = client->pers.voteCount;
 			}
-
-			return;
 		}
-	}
-	if (i >= MAX_ADMIN_NAMELOGS) {
-		G_Printf
-		    ("G_admin_namelog_update: warning, g_admin_namelogs overflow\n");
+
 		return;
 	}
-	namelog = G_Alloc(sizeof(g_admin_namelog_t));
-	memset(namelog, 0, sizeof(*namelog));
-	for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES; j++)
-		namelog->name[j][0] = '\0';
-	Q_strncpyz(namelog->ip, client->pers.ip, sizeof(namelog->ip));
-	Q_strncpyz(namelog->guid, client->pers.guid, sizeof(namelog->guid));
-	Q_strncpyz(namelog->name[0], client->pers.netname,
-		   sizeof(namelog->name[0]));
-	namelog->slot = (disconnect) ? -1 : clientNum;
+
+	namelog = admin_namelog_new(client->pers.ip, client->pers.guid);
+	if (!namelog)
+		return;
+	admin_namelog_add_name(namelog, client->pers.netname, n1);
+	admin_namelog_set_slot(namelog, (disconnect) ? -1 : clientNum);
 	schachtmeisterProcess(namelog);
-	g_admin_namelog[i] = namelog;
 }
 
 qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
@@ -1784,7 +2541,7 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 	fileHandle_t f;
 	int len;
 	char *cnf, *cnf2;
-	char *t;
+	tokenSpan_t t;
 	qboolean level_open, admin_open, ban_open, command_open;
 	int i;
 
@@ -1812,17 +2569,20 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 	*(cnf + len) = '\0';
 	trap_FS_FCloseFile(f);
 
-	t = COM_Parse(&cnf);
+	COM_BeginParseSession(g_admin.string);
+	COM_ParseSpan(&cnf, qtrue, &t);
 	level_open = admin_open = ban_open = command_open = qfalse;
-	while (*t) {
-		if (!Q_stricmp(t, "[level]") ||
-		    !Q_stricmp(t, "[admin]") ||
-		    !Q_stricmp(t, "[ban]") || !Q_stricmp(t, "[command]")) {
+	while (t.length) {
+		if (COM_SpanEqual(&t, "[level]") ||
+		    COM_SpanEqual(&t, "[admin]") ||
+		    COM_SpanEqual(&t, "[ban]") || COM_SpanEqual(&t, "[command]")) {
 
 			if (level_open)
 				g_admin_levels[lc++] = l;
-			else if (admin_open)
+			else if (admin_open) {
+				admin_index_admin(ac, a);
 				g_admin_admins[ac++] = a;
+			}
 			else if (ban_open)
 				g_admin_bans[bc++] = b;
 			else if (command_open)
@@ -1832,95 +2592,99 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 		}
 
 		if (level_open) {
-			if (!Q_stricmp(t, "level")) {
+			if (COM_SpanEqual(&t, "level")) {
 				admin_readconfig_int(&cnf, &l->level);
-			} else if (!Q_stricmp(t, "name")) {
+			} else if (COM_SpanEqual(&t, "name")) {
 				admin_readconfig_string(&cnf, l->name,
 							sizeof(l->name));
-			} else if (!Q_stricmp(t, "flags")) {
+			} else if (COM_SpanEqual(&t, "flags")) {
 				admin_readconfig_string(&cnf, l->flags,
 							sizeof(l->flags));
 			} else {
 				ADMP(va
 				     ("^3!readconfig: ^7[level] parse error near %s on line %d\n",
-				      t, COM_GetCurrentParseLine()));
+				      COM_SpanToken(&t),
+				      COM_GetCurrentParseLine()));
 			}
 		} else if (admin_open) {
-			if (!Q_stricmp(t, "name")) {
+			if (COM_SpanEqual(&t, "name")) {
 				admin_readconfig_string(&cnf, a->name,
 							sizeof(a->name));
-			} else if (!Q_stricmp(t, "guid")) {
+			} else if (COM_SpanEqual(&t, "guid")) {
 				admin_readconfig_string(&cnf, a->guid,
 							sizeof(a->guid));
-			} else if (!Q_stricmp(t, "level")) {
+			} else if (COM_SpanEqual(&t, "level")) {
 				admin_readconfig_int(&cnf, &a->level);
-			} else if (!Q_stricmp(t, "flags")) {
+			} else if (COM_SpanEqual(&t, "flags")) {
 				admin_readconfig_string(&cnf, a->flags,
 							sizeof(a->flags));
-			} else if (!Q_stricmp(t, "seen")) {
+			} else if (COM_SpanEqual(&t, "seen")) {
 				admin_readconfig_int(&cnf, &a->seen);
 			} else {
 				ADMP(va
 				     ("^3!readconfig: ^7[admin] parse error near %s on line %d\n",
-				      t, COM_GetCurrentParseLine()));
+				      COM_SpanToken(&t),
+				      COM_GetCurrentParseLine()));
 			}
 
 		} else if (ban_open) {
-			if (!Q_stricmp(t, "name")) {
+			if (COM_SpanEqual(&t, "name")) {
 				admin_readconfig_string(&cnf, b->name,
 							sizeof(b->name));
-			} else if (!Q_stricmp(t, "guid")) {
+			} else if (COM_SpanEqual(&t, "guid")) {
 				admin_readconfig_string(&cnf, b->guid,
 							sizeof(b->guid));
-			} else if (!Q_stricmp(t, "ip")) {
+			} else if (COM_SpanEqual(&t, "ip")) {
 				admin_readconfig_string(&cnf, b->ip,
 							sizeof(b->ip));
-			} else if (!Q_stricmp(t, "reason")) {
+			} else if (COM_SpanEqual(&t, "reason")) {
 				admin_readconfig_string(&cnf, b->reason,
 							sizeof(b->reason));
-			} else if (!Q_stricmp(t, "made")) {
+			} else if (COM_SpanEqual(&t, "made")) {
 				admin_readconfig_string(&cnf, b->made,
 							sizeof(b->made));
-			} else if (!Q_stricmp(t, "expires")) {
+			} else if (COM_SpanEqual(&t, "expires")) {
 				admin_readconfig_int(&cnf, &b->expires);
-			} else if (!Q_stricmp(t, "length")) {
+			} else if (COM_SpanEqual(&t, "length")) {
 				admin_readconfig_int(&cnf, &b->length);
-			} else if (!Q_stricmp(t, "suspend")) {
+			} else if (COM_SpanEqual(&t, "suspend")) {
 				admin_readconfig_int(&cnf, &b->suspend);
-			} else if (!Q_stricmp(t, "suspendby")) {
+			} else if (COM_SpanEqual(&t, "suspendby")) {
 				admin_readconfig_string(&cnf, b->suspendby,
 							sizeof(b->suspendby));
-			} else if (!Q_stricmp(t, "banner")) {
+			} else if (COM_SpanEqual(&t, "banner")) {
 				admin_readconfig_string(&cnf, b->banner,
 							sizeof(b->banner));
-			} else if (!Q_stricmp(t, "blevel")) {
+			} else if (COM_SpanEqual(&t, "blevel")) {
 				admin_readconfig_int(&cnf, &b->bannerlevel);
 			} else {
 				ADMP(va
 				     ("^3!readconfig: ^7[ban] parse error near %s on line %d\n",
-				      t, COM_GetCurrentParseLine()));
+				      COM_SpanToken(&t),
+				      COM_GetCurrentParseLine()));
 			}
 		} else if (command_open) {
-			if (!Q_stricmp(t, "command")) {
+			if (COM_SpanEqual(&t, "command")) {
 				admin_readconfig_string(&cnf, c->command,
 							sizeof(c->command));
-			} else if (!Q_stricmp(t, "exec")) {
+			} else if (COM_SpanEqual(&t, "exec")) {
 				admin_readconfig_string(&cnf, c->exec,
 							sizeof(c->exec));
-			} else if (!Q_stricmp(t, "desc")) {
+			} else if (COM_SpanEqual(&t, "desc")) {
 				admin_readconfig_string(&cnf, c->desc,
 							sizeof(c->desc));
-			} else if (!Q_stricmp(t, "flag")) {
+			} else if (COM_SpanEqual(&t, "flag")) {
 				admin_readconfig_string(&cnf, c->flag,
 							sizeof(c->flag));
 			} else {
 				ADMP(va
 				     ("^3!readconfig: ^7[command] parse error near %s on line %d\n",
-				      t, COM_GetCurrentParseLine()));
+				      COM_SpanToken(&t),
+				      COM_GetCurrentParseLine()));
 			}
 		}
 
-		if (!Q_stricmp(t, "[level]")) {
+		if (COM_SpanEqual(&t, "[level]")) {
 			if (lc >= MAX_ADMIN_LEVELS)
 				return qfalse;
 			l = G_Alloc(sizeof(g_admin_level_t));
@@ -1928,7 +2692,7 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 			*l->name = '\0';
 			*l->flags = '\0';
 			level_open = qtrue;
-		} else if (!Q_stricmp(t, "[admin]")) {
+		} else if (COM_SpanEqual(&t, "[admin]")) {
 			if (ac >= MAX_ADMIN_ADMINS)
 				return qfalse;
 			a = G_Alloc(sizeof(g_admin_admin_t));
@@ -1938,7 +2702,7 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 			*a->flags = '\0';
 			a->seen = 0;
 			admin_open = qtrue;
-		} else if (!Q_stricmp(t, "[ban]")) {
+		} else if (COM_SpanEqual(&t, "[ban]")) {
 			if (bc >= MAX_ADMIN_BANS)
 				return qfalse;
 			b = G_Alloc(sizeof(g_admin_ban_t));
@@ -1953,7 +2717,7 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 			*b->reason = '\0';
 			b->bannerlevel = 0;
 			ban_open = qtrue;
-		} else if (!Q_stricmp(t, "[command]")) {
+		} else if (COM_SpanEqual(&t, "[command]")) {
 			if (cc >= MAX_ADMIN_COMMANDS)
 				return qfalse;
 			c = G_Alloc(sizeof(g_admin_command_t));
@@ -1963,14 +2727,16 @@ qboolean G_admin_readconfig(gentity_t * ent, int skiparg)
 			*c->flag = '\0';
 			command_open = qtrue;
 		}
-		t = COM_Parse(&cnf);
+		COM_ParseSpan(&cnf, qtrue, &t);
 	}
 	if (level_open) {
 
 		g_admin_levels[lc++] = l;
 	}
-	if (admin_open)
+	if (admin_open) {
+		admin_index_admin(ac, a);
 		g_admin_admins[ac++] = a;
+	}
 	if (ban_open)
 		g_admin_bans[bc++] = b;
 	if (command_open)
@@ -2058,8 +2824,8 @@ static int G_admin_find_slot(gentity_t * ent, char *namearg,
 			     const char *command)
 {
 	char name[MAX_NAME_LENGTH];
-	char testname[MAX_NAME_LENGTH];
 	char *guid = NULL;
+	int adminMatches[2];
 	int matches = 0;
 	int id = -1;
 	int i;
@@ -2099,15 +2865,13 @@ static int G_admin_find_slot(gentity_t * ent, char *namearg,
 		return -1;
 	}
 
-	for (i = 0; i < MAX_ADMIN_ADMINS && g_admin_admins[i] && matches < 2;
-	     i++) {
-		G_SanitiseString(g_admin_admins[i]->name, testname,
-				 sizeof(testname));
-		if (strstr(testname, name)) {
-			id = i + MAX_CLIENTS;
-			guid = g_admin_admins[i]->guid;
-			matches++;
-		}
+	matches = G_NameIndexSearch(&admin_adminIndex, name, admin_match_admin,
+				    adminMatches, 2);
+	if (matches > 2)
+		matches = 2;
+	if (matches) {
+		id = adminMatches[matches - 1] + MAX_CLIENTS;
+		guid = g_admin_admins[adminMatches[matches - 1]]->guid;
 	}
 	for (i = 0; i < level.maxclients && matches < 2; i++) {
 		if (level.clients[i].pers.connected == CON_DISCONNECTED)
@@ -2117,9 +2881,7 @@ static int G_admin_find_slot(gentity_t * ent, char *namearg,
 		    && !Q_stricmp(level.clients[i].pers.guid, guid))
 			continue;
 
-		G_SanitiseString(level.clients[i].pers.netname, testname,
-				 sizeof(testname));
-		if (strstr(testname, name)) {
+		if (strstr(level.clients[i].pers.sanitisedName, name)) {
 			id = i;
 			matches++;
 		}
@@ -2265,8 +3027,10 @@ qboolean G_admin_setlevel(gentity_t * ent, int skiparg)
 	for (i = 0; i < MAX_ADMIN_ADMINS && g_admin_admins[i]; i++) {
 		if (!Q_stricmp(g_admin_admins[i]->guid, guid)) {
 			g_admin_admins[i]->level = l;
+			admin_unindex_admin(i, g_admin_admins[i]);
 			Q_strncpyz(g_admin_admins[i]->name, adminname,
 				   sizeof(g_admin_admins[i]->name));
+			admin_index_admin(i, g_admin_admins[i]);
 			updated = qtrue;
 		}
 	}
@@ -2280,6 +3044,7 @@ qboolean G_admin_setlevel(gentity_t * ent, int skiparg)
 		Q_strncpyz(a->name, adminname, sizeof(a->name));
 		Q_strncpyz(a->guid, guid, sizeof(a->guid));
 		*a->flags = '\0';
+		admin_index_admin(i, a);
 		g_admin_admins[i] = a;
 	}
 
@@ -2805,10 +3570,11 @@ qboolean G_admin_ban(gentity_t * ent, int skiparg)
 	char *reason;
 	int minargc;
 	char duration[32];
-	int logmatch = -1, logmatches = 0;
+	g_admin_namelog_t *namelog, *logmatch = NULL;
+	static int matches[MAX_ADMIN_NAMELOG_SHOW];
+	int logmatches = 0;
 	int i, j;
 	qboolean exactmatch = qfalse;
-	char n2[MAX_NAME_LENGTH];
 	char s2[MAX_NAME_LENGTH];
 	char guid_stub[9];
 	char notice[51];
@@ -2862,45 +3628,45 @@ qboolean G_admin_ban(gentity_t * ent, int skiparg)
 		}
 	}
 
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
+	for (namelog = g_admin_namelogs; namelog; namelog = namelog->next) {
 		// skip players in the namelog who have already been banned
-		if (g_admin_namelog[i]->banned)
+		if (namelog->banned)
 			continue;
 
 		// skip disconnected players when banning on slot number
-		if (g_admin_namelog[i]->slot == -1)
+		if (namelog->slot == -1)
 			continue;
 
-		if (!Q_stricmp(va("%d", g_admin_namelog[i]->slot), s2)) {
+		if (!Q_stricmp(va("%d", namelog->slot), s2)) {
 			logmatches = 1;
-			logmatch = i;
+			logmatch = namelog;
 			exactmatch = qtrue;
 			break;
 		}
 	}
 
-	for (i = 0;
-	     !exactmatch && i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
+	for (namelog = admin_namelogIP[admin_namelog_hash(s2)];
+	     !exactmatch && namelog; namelog = namelog->ipNext) {
 		// skip players in the namelog who have already been banned
-		if (g_admin_namelog[i]->banned)
+		if (namelog->banned)
 			continue;
 
-		if (!Q_stricmp(g_admin_namelog[i]->ip, s2)) {
+		if (!Q_stricmp(namelog->ip, s2)) {
 			logmatches = 1;
-			logmatch = i;
+			logmatch = namelog;
 			exactmatch = qtrue;
 			break;
 		}
-		for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES
-		     && g_admin_namelog[i]->name[j][0]; j++) {
-			G_SanitiseString(g_admin_namelog[i]->name[j], n2,
-					 sizeof(n2));
-			if (strstr(n2, s2)) {
-				if (logmatch != i)
-					logmatches++;
-				logmatch = i;
-			}
-		}
+	}
+
+	if (!exactmatch) {
+		logmatches = G_NameIndexSearch(&admin_namelogIndex, s2,
+					       admin_match_unbanned_namelog,
+					       matches, MAX_ADMIN_NAMELOG_SHOW);
+		if (logmatches)
+			logmatch = &admin_namelogPool[matches[0]];
+		if (logmatches > MAX_ADMIN_NAMELOG_SHOW)
+			logmatches = MAX_ADMIN_NAMELOG_SHOW;
 	}
 
 	if (!logmatches) {
@@ -2910,25 +3676,21 @@ qboolean G_admin_ban(gentity_t * ent, int skiparg)
 		ADMBP_begin();
 		ADMBP
 		    ("^3!ban: ^7multiple recent clients match name, use IP or slot#:\n");
-		for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
+		for (i = 0; i < logmatches; i++) {
+			namelog = &admin_namelogPool[matches[i]];
 			for (j = 0; j < 8; j++)
-				guid_stub[j] = g_admin_namelog[i]->guid[j + 24];
+				guid_stub[j] = namelog->guid[j + 24];
 			guid_stub[j] = '\0';
 			for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES
-			     && g_admin_namelog[i]->name[j][0]; j++) {
-				G_SanitiseString(g_admin_namelog[i]->name[j],
-						 n2, sizeof(n2));
-				if (strstr(n2, s2)) {
-					if (g_admin_namelog[i]->slot > -1)
+			     && namelog->name[j][0]; j++) {
+				if (strstr(namelog->sanitised[j], s2)) {
+					if (namelog->slot > -1)
 						ADMBP("^3");
-					ADMBP(va("%-2s (*%s) %15s ^7'%s^7'\n",
-						 (g_admin_namelog[i]->slot >
-						  -1) ? va("%d",
-							   g_admin_namelog[i]->
-							   slot) : "-",
-						 guid_stub,
-						 g_admin_namelog[i]->ip,
-						 g_admin_namelog[i]->name[j]));
+					ADMBP(va("%-2s (*%s) %-15s ^7'%s^7'\n",
+						 (namelog->slot > -1) ?
+						 va("%d", namelog->slot) : "-",
+						 guid_stub, namelog->ip,
+						 namelog->name[j]));
 				}
 			}
 		}
@@ -2939,35 +3701,35 @@ qboolean G_admin_ban(gentity_t * ent, int skiparg)
 	G_admin_duration((seconds) ? seconds : -1, duration, sizeof(duration));
 
 	if (ent && !admin_higher_guid(ent->client->pers.guid,
-				      g_admin_namelog[logmatch]->guid)) {
+				      logmatch->guid)) {
 
 		ADMP("^3!ban: ^7sorry, but your intended victim has a higher admin" " level than you\n");
 		return qfalse;
 	}
 
 	admin_create_ban(ent,
-			 g_admin_namelog[logmatch]->name[0],
-			 g_admin_namelog[logmatch]->guid,
-			 g_admin_namelog[logmatch]->ip, seconds, reason);
+			 logmatch->name[0],
+			 logmatch->guid,
+			 logmatch->ip, seconds, reason);
 
-	g_admin_namelog[logmatch]->banned = qtrue;
+	logmatch->banned = qtrue;
 
 	if (!g_admin.string[0])
 		ADMP("^3!ban: ^7WARNING g_admin not set, not saving ban to a file\n");
 	else
 		admin_writeconfig();
 
-	if (g_admin_namelog[logmatch]->slot == -1) {
+	if (logmatch->slot == -1) {
 		// client is already disconnected so stop here
 		AP(va("print \"^3!ban:^7 %s^7 has been banned by %s^7 "
 		      "duration: %s, reason: %s\n\"",
-		      g_admin_namelog[logmatch]->name[0],
+		      logmatch->name[0],
 		      G_admin_adminPrintName(ent),
 		      duration, (*reason) ? reason : "banned by admin"));
 		return qtrue;
 	}
 
-	trap_SendServerCommand(g_admin_namelog[logmatch]->slot,
+	trap_SendServerCommand(logmatch->slot,
 			       va("disconnect \"You have been banned.\n"
 				  "admin:\n%s^7\nduration:\n%s\nreason:\n%s\n%s\"",
 				  G_admin_adminPrintName(ent),
@@ -2977,7 +3739,7 @@ qboolean G_admin_ban(gentity_t * ent, int skiparg)
 
 	AP(va
 	   ("print \"^3!ban: ^7%s ^7was banned by %s^7, duration: %s, reason: %s\n\"",
-	    g_admin_namelog[logmatch]->name[0], G_admin_adminPrintName(ent),
+	    logmatch->name[0], G_admin_adminPrintName(ent),
 	    duration, (*reason) ? reason : "banned by admin"));
 
 	return qtrue;
@@ -2986,33 +3748,24 @@ qboolean G_admin_ban(gentity_t * ent, int skiparg)
 // If true then don't let the player join a team, use the chat or run commands.
 qboolean G_admin_is_restricted(gentity_t * ent, qboolean sendMessage)
 {
-	schachtmeisterJudgement_t *j = NULL;
-	int i;
+	g_admin_namelog_t *namelog;
 
 	// Never restrict admins or whitelisted players.
 	if (G_admin_permission(ent, ADMF_NOAUTOBAHN) ||
 	    G_admin_permission(ent, ADMF_IMMUNITY))
 		return qfalse;
 
-	// Find the relevant namelog.
-	// FIXME: this shouldn't require looping over *all* namelogs.
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
-		if (g_admin_namelog[i]->slot == ent - g_entities) {
-			j = &g_admin_namelog[i]->smj;
-			break;
-		}
-	}
-
 	// A missing namelog shouldn't happen.
-	if (!j)
+	namelog = G_admin_namelog_slot(ent - g_entities);
+	if (!namelog)
 		return qfalse;
 
 	// Restrictions concern only unrated players.
-	if (j->ratingTime)
+	if (namelog->smj.ratingTime)
 		return qfalse;
 
 	// Don't wait forever, allow up to 15 seconds.
-	if (level.time - j->queryTime >= 15000)
+	if (level.time - namelog->smj.queryTime >= 15000)
 		return qfalse;
 
 	if (sendMessage)
@@ -3049,12 +3802,15 @@ static void admin_autobahn(gentity_t * ent, int rating)
 	trap_DropClient(ent - g_entities, "dropped by the Autobahn");
 }
 
-void G_admin_IPA_judgement(const char *ipa, int rating, const char *comment)
+static void schachtmeisterJudge(const char *ipa, int rating,
+				const char *comment)
 {
-	int i;
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
-		if (!strcmp(g_admin_namelog[i]->ip, ipa)) {
-			schachtmeisterJudgement_t *j = &g_admin_namelog[i]->smj;
+	g_admin_namelog_t *namelog;
+
+	for (namelog = admin_namelogIP[admin_namelog_hash(ipa)]; namelog;
+	     namelog = namelog->ipNext) {
+		if (!strcmp(namelog->ip, ipa)) {
+			schachtmeisterJudgement_t *j = &namelog->smj;
 
 			j->ratingTime = level.time;
 			j->queryTime = 0;
@@ -3071,14 +3827,24 @@ void G_admin_IPA_judgement(const char *ipa, int rating, const char *comment)
 			} else
 				j->comment = NULL;
 
-			if (g_admin_namelog[i]->slot != -1)
-				admin_autobahn(g_entities +
-					       g_admin_namelog[i]->slot,
+			if (namelog->slot != -1) {
+				schachtmeisterSchedule(namelog,
+						       level.time +
+						       SM_RATING_LIFE);
+				admin_autobahn(g_entities + namelog->slot,
 					       j->rating);
+			} else
+				schachtmeisterUnschedule(namelog);
 		}
 	}
 }
 
+void G_admin_IPA_judgement(const char *ipa, int rating, const char *comment)
+{
+	schachtmeisterCacheStore(ipa, rating, comment);
+	schachtmeisterJudge(ipa, rating, comment);
+}
+
 qboolean G_admin_adjustban(gentity_t * ent, int skiparg)
 {
 	int bnum;
@@ -3500,7 +4266,9 @@ qboolean G_admin_seen(gentity_t * ent, int skiparg)
 	char search[MAX_NAME_LENGTH];
 	char sduration[32];
 	qboolean numeric = qtrue;
-	int i, j;
+	int i, j, k;
+	static int matches[MAX_ADMIN_ADMINS];
+	int numMatches = 0;
 	int id = -1;
 	int count = 0;
 	int t;
@@ -3536,9 +4304,8 @@ qboolean G_admin_seen(gentity_t * ent, int skiparg)
 		    || vic->client->pers.connected != CON_CONNECTED)
 			continue;
 
-		G_SanitiseString(vic->client->pers.netname, name, sizeof(name));
-
-		if (i == id || (search[0] && strstr(name, search))) {
+		if (i == id || (search[0] &&
+				strstr(vic->client->pers.sanitisedName, search))) {
 			if (vic->client->sess.invisible == qfalse) {
 				ADMBP(va
 				      ("^3%4d ^7%s^7 is currently playing\n", i,
@@ -3547,51 +4314,57 @@ qboolean G_admin_seen(gentity_t * ent, int skiparg)
 			}
 		}
 	}
-	for (i = 0; i < MAX_ADMIN_ADMINS && g_admin_admins[i] && count < 10;
-	     i++) {
-		G_SanitiseString(g_admin_admins[i]->name, name, sizeof(name));
-		if (i + MAX_CLIENTS == id
-		    || (search[0] && strstr(name, search))) {
-			ison = qfalse;
-			for (j = 0; j < level.maxclients; j++) {
-				vic = &g_entities[j];
-				if (!vic->client
-				    || vic->client->pers.connected !=
-				    CON_CONNECTED)
-					continue;
-				G_SanitiseString(vic->client->pers.netname,
-						 name, sizeof(name));
-				if (!Q_stricmp
-				    (vic->client->pers.guid,
-				     g_admin_admins[i]->guid)
-				    && strstr(name, search)) {
-					if (vic->client->sess.invisible ==
-					    qfalse) {
-						ison = qtrue;
-						break;
-					}
+	if (search[0]) {
+		numMatches = G_NameIndexSearch(&admin_adminIndex, search,
+					       admin_match_admin, matches,
+					       MAX_ADMIN_ADMINS);
+		if (numMatches > MAX_ADMIN_ADMINS)
+			numMatches = MAX_ADMIN_ADMINS;
+	} else if (id >= MAX_CLIENTS && id < MAX_CLIENTS + MAX_ADMIN_ADMINS
+		   && g_admin_admins[id - MAX_CLIENTS])
+		matches[numMatches++] = id - MAX_CLIENTS;
+
+	for (k = 0; k < numMatches && count < 10; k++) {
+		i = matches[k];
+
+		ison = qfalse;
+		for (j = 0; j < level.maxclients; j++) {
+			vic = &g_entities[j];
+			if (!vic->client
+			    || vic->client->pers.connected !=
+			    CON_CONNECTED)
+				continue;
+			if (!Q_stricmp
+			    (vic->client->pers.guid,
+			     g_admin_admins[i]->guid)
+			    && strstr(vic->client->pers.sanitisedName,
+				      search)) {
+				if (vic->client->sess.invisible ==
+				    qfalse) {
+					ison = qtrue;
+					break;
 				}
 			}
+		}
 
-			if (ison) {
-				if (id == -1)
-					continue;
-				ADMBP(va("^3%4d ^7%s^7 is currently playing\n",
-					 i + MAX_CLIENTS,
-					 g_admin_admins[i]->name));
-			} else {
-				G_admin_duration(t - g_admin_admins[i]->seen,
-						 sduration, sizeof(sduration));
-				ADMBP(va("%4d %s^7 last seen %s%s\n",
-					 i + MAX_CLIENTS,
-					 g_admin_admins[i]->name,
-					 (g_admin_admins[i]->
-					  seen) ? sduration : "",
-					 (g_admin_admins[i]->
-					  seen) ? " ago" : "time is unknown"));
-			}
-			count++;
+		if (ison) {
+			if (id == -1)
+				continue;
+			ADMBP(va("^3%4d ^7%s^7 is currently playing\n",
+				 i + MAX_CLIENTS,
+				 g_admin_admins[i]->name));
+		} else {
+			G_admin_duration(t - g_admin_admins[i]->seen,
+					 sduration, sizeof(sduration));
+			ADMBP(va("%4d %s^7 last seen %s%s\n",
+				 i + MAX_CLIENTS,
+				 g_admin_admins[i]->name,
+				 (g_admin_admins[i]->
+				  seen) ? sduration : "",
+				 (g_admin_admins[i]->
+				  seen) ? " ago" : "time is unknown"));
 		}
+		count++;
 	}
 
 	if (search[0])
@@ -3843,7 +4616,7 @@ qboolean G_admin_adminlog(gentity_t * ent, int skiparg)
 
 		t = results[i]->time / 1000;
 		G_DecolorString(results[i]->name, n1);
-		Com_sprintf(fmt_name, sizeof(fmt_name), "%%%ds",
+		Com_sprintf(fmt_name, sizeof(fmt_name), "%%-%ds",
 			    (int)(name_length + strlen(results[i]->name) -
 				  strlen(n1)));
 		Com_sprintf(n1, sizeof(n1), fmt_name, results[i]->name);
@@ -4120,7 +4893,7 @@ qboolean G_admin_maplog(gentity_t * ent, int skiparg)
 			clock = curTime;
 		}
 
-		ADMBP(va("%s%20s %-6s %s^7\n",
+		ADMBP(va("%s%-20s %-6s %s^7\n",
 			 (count == 0) ? "^3" : "^7",
 			 ptr,
 			 (clock) ? clock : "",
@@ -4677,8 +5450,6 @@ qboolean G_admin_listplayers(gentity_t * ent, int skiparg)
 	gclient_t *p;
 	char c[3], t[2];	// color and team letter
 	char n[MAX_NAME_LENGTH] = { "" };
-	char n2[MAX_NAME_LENGTH] = { "" };
-	char n3[MAX_NAME_LENGTH] = { "" };
 	char lname[MAX_NAME_LENGTH];
 	char lname2[MAX_NAME_LENGTH];
 	char muted[2], denied[2], dbuilder[2], immune[2], guidless[2];
@@ -4765,7 +5536,6 @@ qboolean G_admin_listplayers(gentity_t * ent, int skiparg)
 		}
 
 		l = 0;
-		G_SanitiseString(p->pers.netname, n2, sizeof(n2));
 		n[0] = '\0';
 		for (j = 0; j < MAX_ADMIN_ADMINS && g_admin_admins[j]; j++) {
 			if (!Q_stricmp(g_admin_admins[j]->guid, p->pers.guid)) {
@@ -4780,9 +5550,8 @@ qboolean G_admin_listplayers(gentity_t * ent, int skiparg)
 					break;
 				}
 				l = g_admin_admins[j]->level;
-				G_SanitiseString(g_admin_admins[j]->name, n3,
-						 sizeof(n3));
-				if (Q_stricmp(n2, n3)) {
+				if (Q_stricmp(p->pers.sanitisedName,
+					      g_admin_admins[j]->sanitised)) {
 					Q_strncpyz(n, g_admin_admins[j]->name,
 						   sizeof(n));
 				}
@@ -4798,7 +5567,7 @@ qboolean G_admin_listplayers(gentity_t * ent, int skiparg)
 				if (*lname) {
 					G_DecolorString(lname, lname2);
 					Com_sprintf(lname_fmt,
-						    sizeof(lname_fmt), "%%%is",
+						    sizeof(lname_fmt), "%%-%is",
 						    (admin_level_maxname +
 						     (int)(strlen(lname) -
 							   strlen(lname2))));
@@ -4878,7 +5647,7 @@ qboolean G_admin_listmaps(gentity_t * ent, int skiparg)
 
 	ADMBP_begin();
 	for (i = 0; i < rows; i++) {
-		ADMBP(va("^7%20s %20s %20s\n",
+		ADMBP(va("^7%-20s %-20s %-20s\n",
 			 fileSort[i],
 			 (rows + i < count) ? fileSort[rows + i] : "",
 			 (rows * 2 + i < count) ? fileSort[rows * 2 + i] : ""));
@@ -6131,6 +6900,7 @@ qboolean G_admin_nobuild(gentity_t * ent, int skiparg)
 		level.nbMarkers[tmp].Marker->noBuild.isNB = qfalse;
 		level.nbMarkers[tmp].Marker->noBuild.Area = 0.0f;
 		level.nbMarkers[tmp].Marker->noBuild.Height = 0.0f;
+		level.buildGeneration++;
 
 		// Free the entitiy and null it out...
 		G_FreeEntity(level.nbMarkers[tmp].Marker);
@@ -6208,63 +6978,72 @@ qboolean G_admin_namelog(gentity_t * ent, int skiparg)
 	int i, j;
 	char search[MAX_NAME_LENGTH] = { "" };
 	char s2[MAX_NAME_LENGTH] = { "" };
-	char n2[MAX_NAME_LENGTH] = { "" };
 	char guid_stub[9];
-	qboolean found = qfalse;
-	int printed = 0;
+	g_admin_namelog_t *namelog;
+	g_admin_namelog_t *results[MAX_ADMIN_NAMELOG_SHOW];
+	static int matches[MAX_ADMIN_NAMELOG_SHOW];
+	int found = 0, printed = 0;
 
 	if (G_SayArgc() > 1 + skiparg) {
 		G_SayArgv(1 + skiparg, search, sizeof(search));
 		G_SanitiseString(search, s2, sizeof(s2));
 	}
-	ADMBP_begin();
-	for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; i++) {
-		if (search[0]) {
-			found = qfalse;
-			for (j = 0; j < MAX_ADMIN_NAMELOG_NAMES &&
-			     g_admin_namelog[i]->name[j][0]; j++) {
-				G_SanitiseString(g_admin_namelog[i]->name[j],
-						 n2, sizeof(n2));
-				if (strstr(n2, s2)) {
-					found = qtrue;
-					break;
-				}
-			}
-			if (!found)
-				continue;
+
+	if (search[0]) {
+		// best matches first
+		found = G_NameIndexSearch(&admin_namelogIndex, s2,
+					  admin_match_namelog, matches,
+					  MAX_ADMIN_NAMELOG_SHOW);
+		printed = (found < MAX_ADMIN_NAMELOG_SHOW) ? found :
+		    MAX_ADMIN_NAMELOG_SHOW;
+		for (i = 0; i < printed; i++)
+			results[printed - 1 - i] =
+			    &admin_namelogPool[matches[i]];
+	} else {
+		// the most recently seen, printed oldest first
+		for (namelog = admin_namelogTail; namelog;
+		     namelog = namelog->prev) {
+			if (printed < MAX_ADMIN_NAMELOG_SHOW)
+				results[printed++] = namelog;
+			found++;
 		}
-		printed++;
+	}
+
+	ADMBP_begin();
+	for (i = printed - 1; i >= 0; i--) {
+		namelog = results[i];
 
 		for (j = 0; j < 8; j++) {
 			if (ent
-			    && G_admin_permission_guid(g_admin_namelog[i]->guid,
+			    && G_admin_permission_guid(namelog->guid,
 						       ADMF_INCOGNITO)
 			    && !admin_higher_guid(ent->client->pers.guid,
-						  g_admin_namelog[i]->guid)
+						  namelog->guid)
 			    && !G_admin_permission(ent, ADMF_SEESINCOGNITO))
 				guid_stub[j] = 'X';
 			else
-				guid_stub[j] = g_admin_namelog[i]->guid[j + 24];
+				guid_stub[j] = namelog->guid[j + 24];
 		}
 		guid_stub[j] = '\0';
 
-		if (g_admin_namelog[i]->slot > -1)
+		if (namelog->slot > -1)
 			ADMBP("^3");
-		ADMBP(va("%-2s (*%s) %15s %s^7",
-			 (g_admin_namelog[i]->slot > -1) ?
-			 va("%d", g_admin_namelog[i]->slot) : "-",
-			 guid_stub, g_admin_namelog[i]->ip,
-			 displaySchachtmeisterJudgement(&g_admin_namelog[i]->
-							smj,
-							g_admin_namelog[i])));
+		ADMBP(va("%-2s (*%s) %-15s %s^7",
+			 (namelog->slot > -1) ? va("%d", namelog->slot) : "-",
+			 guid_stub, namelog->ip,
+			 displaySchachtmeisterJudgement(&namelog->smj,
+							namelog)));
 		for (j = 0;
-		     j < MAX_ADMIN_NAMELOG_NAMES
-		     && g_admin_namelog[i]->name[j][0]; j++) {
-			ADMBP(va(" '%s^7'", g_admin_namelog[i]->name[j]));
+		     j < MAX_ADMIN_NAMELOG_NAMES && namelog->name[j][0]; j++) {
+			ADMBP(va(" '%s^7'", namelog->name[j]));
 		}
 		ADMBP("\n");
 	}
-	ADMBP(va("^3!namelog:^7 %d recent clients found\n", printed));
+	if (found > printed)
+		ADMBP(va("^3!namelog:^7 %d recent clients found, showing the "
+			 "last %d\n", found, printed));
+	else
+		ADMBP(va("^3!namelog:^7 %d recent clients found\n", found));
 	ADMBP_end();
 	return qtrue;
 }
@@ -7265,6 +8044,7 @@ void G_admin_cleanup()
 		G_Free(g_admin_admins[i]);
 		g_admin_admins[i] = NULL;
 	}
+	G_NameIndexClear(&admin_adminIndex);
 	for (i = 0; i < MAX_ADMIN_BANS && g_admin_bans[i]; i++) {
 		G_Free(g_admin_bans[i]);
 		g_admin_bans[i] = NULL;
@@ -8177,7 +8957,7 @@ qboolean G_admin_tklog(gentity_t * ent, int skiparg)
 		t = results[i]->time / 1000;
 
 		G_DecolorString(results[i]->name, n1);
-		Com_sprintf(fmt_name, sizeof(fmt_name), "%%%ds",
+		Com_sprintf(fmt_name, sizeof(fmt_name), "%%-%ds",
 			    (name_length +
 			     (int)(strlen(results[i]->name) - strlen(n1))));
 		Com_sprintf(n1, sizeof(n1), fmt_name, results[i]->name);
@@ -8220,6 +9000,7 @@ qboolean G_admin_sm(gentity_t * ent, int skiparg)
 {
 	const char *s;
 	char feature[16];
+	schachtmeisterCache_t *c;
 
 	if (G_SayArgc() < 2 + skiparg) {
 usage:
@@ -8259,16 +9040,16 @@ usage:
 		Com_sprintf(ipa, sizeof(ipa), "%i.%i.%i.%i", parts[0], parts[1],
 			    parts[2], parts[3]);
 
-		if (rand() % 2 /* FIXME cache hit */ ) {
-			const char *answer = "interesting";
+		if ((c = schachtmeisterCacheFind(ipa))) {
 			ADMP(va
-			     ("^3!sm: ^7IP address %s is: %s\n", ipa, answer));
+			     ("^3!sm: ^7IP address %s is rated %d%s%s\n", ipa,
+			      c->rating, c->hasComment ? ": " : "",
+			      c->comment));
 			return qtrue;
 		}
 
 		ADMP("^3!sm: ^7hmm...\n");
-		trap_SendConsoleCommand(EXEC_APPEND,
-					va("smq ipa \"%s\"\n", ipa));
+		dispatchSchachtmeisterIPAQuery(ipa);
 	} else
 		goto usage;
 
@@ -34,7 +34,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #define MAX_ADMIN_LEVELS 128
 #define MAX_ADMIN_ADMINS 1024
 #define MAX_ADMIN_BANS 1024
-#define MAX_ADMIN_NAMELOGS 128
+#define MAX_ADMIN_NAMELOGS 16384
+#define ADMIN_NAMELOG_HASH_SIZE 4096	// power of two
+#define MAX_ADMIN_NAMELOG_SHOW 128
 #define MAX_ADMIN_NAMELOG_NAMES 5
 #define MAX_ADMIN_ADMINLOGS 128
 #define MAX_ADMIN_ADMINLOG_ARGS 50
@@ -140,6 +142,7 @@ typedef struct g_admin_level {
 typedef struct g_admin_admin {
 	char guid[33];
 	char name[MAX_NAME_LENGTH];
+	char sanitised[MAX_NAME_LENGTH];
 	int level;
 	char flags[MAX_ADMIN_FLAGS];
 	int seen;
@@ -172,13 +175,18 @@ typedef struct {
 	int dispatchTime;
 	int rating;
 	char *comment;
+
+	int wakeTime;		// when the scheduler next looks at this
+	int heapIndex;		// 1-based position in the timer queue, 0 if not queued
 } schachtmeisterJudgement_t;
 
 typedef struct g_admin_namelog {
 	char name[MAX_ADMIN_NAMELOG_NAMES][MAX_NAME_LENGTH];
+	char sanitised[MAX_ADMIN_NAMELOG_NAMES][MAX_NAME_LENGTH];
 	char ip[16];
 	char guid[33];
 	int slot;
+	int seen;		// trap_RealTime() of the last update
 	qboolean banned;
 	qboolean muted;
 	int muteExpires;
@@ -188,8 +196,16 @@ typedef struct g_admin_namelog {
 	int specExpires;
 	int voteCount;
 	schachtmeisterJudgement_t smj;
+
+	// least recently seen first
+	struct g_admin_namelog *prev, *next;
+
+	// hash chains
+	struct g_admin_namelog *ipNext, *guidNext;
 } g_admin_namelog_t;
 
+extern g_admin_namelog_t *g_admin_namelogs;
+
 typedef struct g_admin_adminlog {
 	char name[MAX_NAME_LENGTH];
 	char command[MAX_ADMIN_CMD_LEN];
@@ -218,6 +234,8 @@ qboolean G_admin_permission(gentity_t * ent, const char *flag);
 qboolean G_admin_permission_guid(const char *guid, const char *flag);
 qboolean G_admin_name_check(gentity_t * ent, char *name, char *err, int len);
 void G_admin_namelog_update(gclient_t * ent, qboolean disconnect);
+g_admin_namelog_t *G_admin_namelog_find(const char *ip, const char *guid);
+g_admin_namelog_t *G_admin_namelog_slot(int slot);
 void G_admin_maplog_result(char *flag);
 int G_admin_level(gentity_t * ent);
 void G_admin_set_adminname(gentity_t * ent);
@@ -319,6 +337,7 @@ void G_admin_buffer_end(gentity_t * ent);
 
 void G_admin_duration(int secs, char *duration, int dursize);
 void G_admin_cleanup(void);
+void G_admin_namelog_readfile(void);
 void G_admin_namelog_cleanup(void);
 void admin_writeconfig(void);
 
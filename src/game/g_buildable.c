@@ -26,6 +26,39 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // from g_combat.c
 extern char *modNames[];
 
+/*
+================
+G_LogDecon
+
+Log a buildable being destroyed by a member of its own team
+================
+*/
+static void G_LogDecon(gentity_t * self, gentity_t * attacker, int mod)
+{
+	logEvent_t ev;
+
+	G_LogPrintf("Decon: %i %i %i: %s^7 destroyed %s by %s\n",
+		    attacker->client->ps.clientNum, self->s.modelindex,
+		    mod, attacker->client->pers.netname,
+		    BG_FindNameForBuildable(self->s.modelindex),
+		    modNames[mod]);
+
+	if (G_LogEventBegin(&ev, "decon")) {
+		G_LogEventInt(&ev, "client", attacker->client->ps.clientNum);
+		G_LogEventString(&ev, "name", attacker->client->pers.netname);
+		G_LogEventInt(&ev, "team", self->biteam);
+		G_LogEventInt(&ev, "buildable", self->s.modelindex);
+		G_LogEventString(&ev, "buildableName",
+				 BG_FindNameForBuildable(self->s.modelindex));
+		G_LogEventInt(&ev, "mod", mod);
+		G_LogEventString(&ev, "modName", modNames[mod]);
+		G_LogEventInt(&ev, "x", (int)self->s.origin[0]);
+		G_LogEventInt(&ev, "y", (int)self->s.origin[1]);
+		G_LogEventInt(&ev, "z", (int)self->s.origin[2]);
+		G_LogEventEnd(&ev);
+	}
+}
+
 /*
 ================
 G_SetBuildableAnim
@@ -66,19 +99,17 @@ void G_SetIdleBuildableAnim(gentity_t * ent, buildableAnimNumber_t anim)
 
 /*
 ===============
-G_CheckSpawnPoint
+G_SpawnPointOrigin
 
-Check if a spawn at a specified point is valid
+Where a client spawned from a spawn at origin would appear, and its box
 ===============
 */
-gentity_t *G_CheckSpawnPoint(int spawnNum, vec3_t origin, vec3_t normal,
-			     buildable_t spawn, vec3_t spawnOrigin)
+static qboolean G_SpawnPointOrigin(vec3_t origin, vec3_t normal,
+				   buildable_t spawn, vec3_t localOrigin,
+				   vec3_t cmins, vec3_t cmaxs)
 {
 	float displacement;
 	vec3_t mins, maxs;
-	vec3_t cmins, cmaxs;
-	vec3_t localOrigin;
-	trace_t tr;
 
 	BG_FindBBoxForBuildable(spawn, mins, maxs);
 
@@ -90,48 +121,151 @@ gentity_t *G_CheckSpawnPoint(int spawnNum, vec3_t origin, vec3_t normal,
 
 		displacement = (maxs[2] + MAX_ALIEN_BBOX) * M_ROOT3;
 		VectorMA(origin, displacement, normal, localOrigin);
+		return qtrue;
+	} else if (spawn == BA_H_SPAWN) {
+		BG_FindBBoxForClass(PCL_HUMAN, cmins, cmaxs, NULL, NULL, NULL);
 
-		trap_Trace(&tr, origin, NULL, NULL, localOrigin, spawnNum,
-			   MASK_SHOT);
+		VectorCopy(origin, localOrigin);
+		localOrigin[2] += maxs[2] + fabs(cmins[2]) + 1.0f;
+		return qtrue;
+	}
 
-		if (tr.entityNum != ENTITYNUM_NONE)
-			return &g_entities[tr.entityNum];
+	return qfalse;
+}
 
-		trap_Trace(&tr, localOrigin, cmins, cmaxs, localOrigin, -1,
-			   MASK_PLAYERSOLID);
+/*
+===============
+G_CheckSpawnPoint
 
-		if (tr.entityNum == ENTITYNUM_NONE) {
-			if (spawnOrigin != NULL)
-				VectorCopy(localOrigin, spawnOrigin);
+Check if a spawn at a specified point is valid
+===============
+*/
+gentity_t *G_CheckSpawnPoint(int spawnNum, vec3_t origin, vec3_t normal,
+			     buildable_t spawn, vec3_t spawnOrigin)
+{
+	vec3_t cmins, cmaxs;
+	vec3_t localOrigin;
+	trace_t tr;
 
-			return NULL;
-		} else
-			return &g_entities[tr.entityNum];
-	} else if (spawn == BA_H_SPAWN) {
-		BG_FindBBoxForClass(PCL_HUMAN, cmins, cmaxs, NULL, NULL, NULL);
+	if (!G_SpawnPointOrigin(origin, normal, spawn, localOrigin, cmins,
+				cmaxs))
+		return NULL;
 
-		VectorCopy(origin, localOrigin);
-		localOrigin[2] += maxs[2] + fabs(cmins[2]) + 1.0f;
+	trap_Trace(&tr, origin, NULL, NULL, localOrigin, spawnNum, MASK_SHOT);
 
-		trap_Trace(&tr, origin, NULL, NULL, localOrigin, spawnNum,
-			   MASK_SHOT);
+	if (tr.entityNum != ENTITYNUM_NONE)
+		return &g_entities[tr.entityNum];
 
-		if (tr.entityNum != ENTITYNUM_NONE)
-			return &g_entities[tr.entityNum];
+	trap_Trace(&tr, localOrigin, cmins, cmaxs, localOrigin, -1,
+		   MASK_PLAYERSOLID);
 
-		trap_Trace(&tr, localOrigin, cmins, cmaxs, localOrigin, -1,
-			   MASK_PLAYERSOLID);
+	if (tr.entityNum == ENTITYNUM_NONE) {
+		if (spawnOrigin != NULL)
+			VectorCopy(localOrigin, spawnOrigin);
 
-		if (tr.entityNum == ENTITYNUM_NONE) {
-			if (spawnOrigin != NULL)
-				VectorCopy(localOrigin, spawnOrigin);
+		return NULL;
+	} else
+		return &g_entities[tr.entityNum];
+}
 
-			return NULL;
-		} else
-			return &g_entities[tr.entityNum];
+/*
+===============
+G_SpawnVolumeEmpty
+
+Is there nothing in the space G_CheckSpawnPoint traces through that could
+stop its traces, apart from the spawn itself?
+===============
+*/
+static qboolean G_SpawnVolumeEmpty(gentity_t * spot, vec3_t mins,
+				   vec3_t maxs)
+{
+	int touch[MAX_GENTITIES];
+	int i, num;
+
+	num = trap_EntitiesInBox(mins, maxs, touch, MAX_GENTITIES);
+
+	for (i = 0; i < num; i++) {
+		if (touch[i] != spot->s.number &&
+		    (g_entities[touch[i]].r.contents &
+		     (MASK_SHOT | MASK_PLAYERSOLID)))
+			return qfalse;
+	}
+
+	return qtrue;
+}
+
+/*
+===============
+G_SpawnPointBlocker
+
+G_CheckSpawnPoint for a spawn buildable, remembering the answer so that
+spawns aren't traced every frame while clients wait in the queue:
+
+ - blocked by the world stays blocked until the spawn moves
+ - blocked by an entity stays blocked while the entity is still in the
+   spawn volume, for up to SPAWN_CHECK_TIME
+ - clear, with nothing else in the spawn volume, stays clear for as long
+   as nothing enters it
+===============
+*/
+gentity_t *G_SpawnPointBlocker(gentity_t * spot)
+{
+	buildable_t spawn = spot->s.modelindex;
+	vec3_t cmins, cmaxs, localOrigin;
+	vec3_t mins, maxs;
+	gentity_t *blocker;
+	int i;
+
+	if (!G_SpawnPointOrigin(spot->s.origin, spot->s.origin2, spawn,
+				localOrigin, cmins, cmaxs))
+		return NULL;
+
+	// the box both traces stay inside
+	for (i = 0; i < 3; i++) {
+		mins[i] = MIN(spot->s.origin[i], localOrigin[i] + cmins[i]);
+		maxs[i] = MAX(spot->s.origin[i], localOrigin[i] + cmaxs[i]);
+		mins[i] -= 1.0f;
+		maxs[i] += 1.0f;
+	}
+
+	if (spot->spawnCheckValid &&
+	    VectorCompare(spot->spawnCheckOrigin, spot->s.origin) &&
+	    VectorCompare(spot->spawnCheckNormal, spot->s.origin2)) {
+		if (spot->spawnBlocker == ENTITYNUM_WORLD)
+			return &g_entities[ENTITYNUM_WORLD];
+
+		if (spot->spawnBlocker == ENTITYNUM_NONE) {
+			if (spot->spawnCheckEmpty &&
+			    G_SpawnVolumeEmpty(spot, mins, maxs))
+				return NULL;
+		} else {
+			blocker = &g_entities[spot->spawnBlocker];
+
+			if (level.time - spot->spawnCheckTime <
+			    SPAWN_CHECK_TIME && blocker->inuse &&
+			    blocker->r.linked &&
+			    blocker->r.absmin[0] <= maxs[0] &&
+			    blocker->r.absmin[1] <= maxs[1] &&
+			    blocker->r.absmin[2] <= maxs[2] &&
+			    blocker->r.absmax[0] >= mins[0] &&
+			    blocker->r.absmax[1] >= mins[1] &&
+			    blocker->r.absmax[2] >= mins[2])
+				return blocker;
+		}
 	}
 
-	return NULL;
+	blocker = G_CheckSpawnPoint(spot->s.number, spot->s.origin,
+				    spot->s.origin2, spawn, NULL);
+
+	spot->spawnCheckValid = qtrue;
+	spot->spawnCheckTime = level.time;
+	VectorCopy(spot->s.origin, spot->spawnCheckOrigin);
+	VectorCopy(spot->s.origin2, spot->spawnCheckNormal);
+	spot->spawnBlocker = blocker ? blocker - g_entities : ENTITYNUM_NONE;
+	spot->spawnCheckEmpty = !blocker && G_SpawnVolumeEmpty(spot, mins,
+							       maxs);
+
+	return blocker;
 }
 
 /*
@@ -687,11 +821,7 @@ void ASpawn_Die(gentity_t * self, gentity_t * inflictor, gentity_t * attacker,
 								     modelindex),
 					attacker->client->pers.netname);
 		}
-		G_LogPrintf("Decon: %i %i %i: %s^7 destroyed %s by %s\n",
-			    attacker->client->ps.clientNum, self->s.modelindex,
-			    mod, attacker->client->pers.netname,
-			    BG_FindNameForBuildable(self->s.modelindex),
-			    modNames[mod]);
+		G_LogDecon(self, attacker, mod);
 	}
 }
 
@@ -1088,11 +1218,7 @@ void AGeneric_Die(gentity_t * self, gentity_t * inflictor, gentity_t * attacker,
 								     modelindex),
 					attacker->client->pers.netname);
 		}
-		G_LogPrintf("Decon: %i %i %i: %s^7 destroyed %s by %s\n",
-			    attacker->client->ps.clientNum, self->s.modelindex,
-			    mod, attacker->client->pers.netname,
-			    BG_FindNameForBuildable(self->s.modelindex),
-			    modNames[mod]);
+		G_LogDecon(self, attacker, mod);
 	}
 }
 
@@ -1464,6 +1590,7 @@ void AHovel_Use(gentity_t * self, gentity_t * other, gentity_t * activator)
 			}
 
 			self->active = qtrue;
+			level.buildGeneration++;
 			G_SetBuildableAnim(self, BANIM_ATTACK1, qfalse);
 
 			//prevent lerping
@@ -1617,11 +1744,7 @@ void AHovel_Die(gentity_t * self, gentity_t * inflictor, gentity_t * attacker,
 								     modelindex),
 					attacker->client->pers.netname);
 		}
-		G_LogPrintf("Decon: %i %i %i: %s^7 destroyed %s by %s\n",
-			    attacker->client->ps.clientNum, self->s.modelindex,
-			    mod, attacker->client->pers.netname,
-			    BG_FindNameForBuildable(self->s.modelindex),
-			    modNames[mod]);
+		G_LogDecon(self, attacker, mod);
 	}
 }
 
@@ -2726,11 +2849,7 @@ void HSpawn_Die(gentity_t * self, gentity_t * inflictor, gentity_t * attacker,
 								     modelindex),
 					attacker->client->pers.netname);
 		}
-		G_LogPrintf("Decon: %i %i %i: %s^7 destroyed %s by %s\n",
-			    attacker->client->ps.clientNum, self->s.modelindex,
-			    mod, attacker->client->pers.netname,
-			    BG_FindNameForBuildable(self->s.modelindex),
-			    modNames[mod]);
+		G_LogDecon(self, attacker, mod);
 	}
 }
 
@@ -2902,6 +3021,12 @@ void G_BuildableThink(gentity_t * ent, int msec)
 	int bHealth = BG_FindHealthForBuildable(ent->s.modelindex);
 	int bRegen = BG_FindRegenRateForBuildable(ent->s.modelindex);
 	int bTime = BG_FindBuildTimeForBuildable(ent->s.modelindex);
+	qboolean spawned = ent->spawned;
+	qboolean powered = ent->powered;
+	qboolean alive = ent->health > 0;
+	vec3_t origin;
+
+	VectorCopy(ent->s.origin, origin);
 
 	//pack health, power and dcc
 
@@ -2963,6 +3088,12 @@ void G_BuildableThink(gentity_t * ent, int msec)
 
 	//fall back on normal physics routines
 	G_Physics(ent, msec);
+
+	// G_FreeEntity takes care of buildables that have gone
+	if (ent->inuse && (ent->spawned != spawned || ent->powered != powered
+			   || (ent->health > 0) != alive
+			   || !VectorCompare(ent->s.origin, origin)))
+		level.buildGeneration++;
 }
 
 /*
@@ -3040,16 +3171,15 @@ static qboolean G_BuildablesIntersect(buildable_t a, vec3_t originA,
 
 /*
 ===============
-G_CompareBuildablesForRemoval
+G_RemovalPrecedence
 
-qsort comparison function for a buildable removal list
+Marked buildables of different types are removed in this order, lowest
+first
 ===============
 */
-static buildable_t cmpBuildable;
-static vec3_t cmpOrigin;
-static int G_CompareBuildablesForRemoval(const void *a, const void *b)
+static int G_RemovalPrecedence(buildable_t buildable)
 {
-	int precedence[] = {
+	static const buildable_t precedence[] = {
 		BA_NONE,
 
 		BA_A_BARRICADE,
@@ -3070,50 +3200,86 @@ static int G_CompareBuildablesForRemoval(const void *a, const void *b)
 		BA_H_REPEATER,
 		BA_H_REACTOR
 	};
-
-	gentity_t *buildableA, *buildableB;
 	int i;
-	int aPrecedence = 0, bPrecedence = 0;
-	qboolean aMatches = qfalse, bMatches = qfalse;
-
-	buildableA = *(gentity_t **) a;
-	buildableB = *(gentity_t **) b;
-
-	// Prefer the one that collides with the thing we're building
-	aMatches = G_BuildablesIntersect(cmpBuildable, cmpOrigin,
-					 buildableA->s.modelindex,
-					 buildableA->s.origin);
-	bMatches =
-	    G_BuildablesIntersect(cmpBuildable, cmpOrigin,
-				  buildableB->s.modelindex,
-				  buildableB->s.origin);
-	if (aMatches && !bMatches)
-		return -1;
-	if (!aMatches && bMatches)
-		return 1;
-
-	// If one matches the thing we're building, prefer it
-	aMatches = (buildableA->s.modelindex == cmpBuildable);
-	bMatches = (buildableB->s.modelindex == cmpBuildable);
-	if (aMatches && !bMatches)
-		return -1;
-	if (!aMatches && bMatches)
-		return 1;
-
-	// If they're the same type then pick the one marked earliest
-	if (buildableA->s.modelindex == buildableB->s.modelindex)
-		return buildableA->deconstructTime -
-		    buildableB->deconstructTime;
 
 	for (i = 0; i < sizeof(precedence) / sizeof(precedence[0]); i++) {
-		if (buildableA->s.modelindex == precedence[i])
-			aPrecedence = i;
+		if (precedence[i] == buildable)
+			return i;
+	}
+
+	return 0;
+}
+
+/*
+===============
+G_MarkedListPrune
+
+Drop entityNum from a team's list of marked buildables, along with anything
+that has been unmarked or freed since it was listed
+===============
+*/
+static void G_MarkedListPrune(int team, int entityNum)
+{
+	int *list = level.markedBuildableNums[team];
+	gentity_t *ent;
+	int i, n = 0;
+
+	for (i = 0; i < level.numMarkedBuildables[team]; i++) {
+		ent = g_entities + list[i];
+
+		if (list[i] == entityNum || !ent->inuse ||
+		    ent->s.eType != ET_BUILDABLE || !ent->deconstruct ||
+		    ent->biteam != team)
+			continue;
+
+		list[n++] = list[i];
+	}
+
+	level.numMarkedBuildables[team] = n;
+}
+
+/*
+===============
+G_MarkBuildable
+
+Set or clear ent's deconstruction mark.  Each team keeps its marked
+buildables in the order they'd be removed in: by type precedence, then
+earliest marked first.  deconstructTime must be set before marking.
+===============
+*/
+void G_MarkBuildable(gentity_t * ent, qboolean mark)
+{
+	gentity_t *other;
+	int *list, team, precedence, i, n;
+
+	ent->deconstruct = mark;
+	level.buildGeneration++;
+
+	// the entity may have been freed and reused since it was listed
+	for (team = BIT_ALIENS; team < BIT_NUM_TEAMS; team++)
+		G_MarkedListPrune(team, ent->s.number);
+
+	if (!mark || ent->biteam <= BIT_NONE || ent->biteam >= BIT_NUM_TEAMS)
+		return;
+
+	team = ent->biteam;
+	list = level.markedBuildableNums[team];
+	n = level.numMarkedBuildables[team];
+	precedence = G_RemovalPrecedence(ent->s.modelindex);
+
+	for (i = n; i > 0; i--) {
+		other = g_entities + list[i - 1];
+
+		if (G_RemovalPrecedence(other->s.modelindex) < precedence ||
+		    (other->s.modelindex == ent->s.modelindex &&
+		     other->deconstructTime <= ent->deconstructTime))
+			break;
 
-		if (buildableB->s.modelindex == precedence[i])
-			bPrecedence = i;
+		list[i] = list[i - 1];
 	}
 
-	return aPrecedence - bPrecedence;
+	list[i] = ent->s.number;
+	level.numMarkedBuildables[team]++;
 }
 
 /*
@@ -3182,6 +3348,9 @@ static itemBuildError_t G_SufficientBPAvailable(buildable_t buildable,
 	buildable_t spawn;
 	buildable_t core;
 	int spawnCount = 0;
+	int group, n;
+	static gentity_t *removalCandidates[MAX_GENTITIES];
+	static byte removalGroups[MAX_GENTITIES];
 
 	level.numBuildablesForRemoval = 0;
 
@@ -3229,72 +3398,81 @@ static itemBuildError_t G_SufficientBPAvailable(buildable_t buildable,
 	if (!g_markDeconstructMode.integer)
 		buildPoints -= remainingBP;
 
-	// Build a list of buildable entities
+	// Count what's in the way, which can only be built over if it's all
+	// marked for removal
 	for (i = MAX_CLIENTS, ent = g_entities + i; i < level.num_entities;
 	     i++, ent++) {
 		if (ent->s.eType != ET_BUILDABLE)
 			continue;
 
-		collision =
-		    G_BuildablesIntersect(buildable, origin, ent->s.modelindex,
-					  ent->s.origin);
-
-		if (collision)
+		if (G_BuildablesIntersect(buildable, origin, ent->s.modelindex,
+					  ent->s.origin))
 			collisionCount++;
 
 		// Check if this is a repeater and it's in range
 		if (buildable == BA_H_REPEATER &&
 		    buildable == ent->s.modelindex &&
-		    Distance(ent->s.origin, origin) < REPEATER_BASESIZE) {
-			repeaterInRange = qtrue;
+		    Distance(ent->s.origin, origin) < REPEATER_BASESIZE)
 			repeaterInRangeCount++;
-		} else
-			repeaterInRange = qfalse;
 
-		if (!ent->inuse)
-			continue;
+		// Don't allow destruction of hovel with granger inside
+		if (buildable == BA_A_HOVEL &&
+		    ent->s.modelindex == BA_A_HOVEL && ent->active &&
+		    ent->inuse && ent->health > 0 && ent->biteam == team)
+			return IBE_HOVEL;
+	}
+
+	// The team's marked buildables are kept in removal order, apart from
+	// the comparisons with what's being built.  Anything in the way goes
+	// first, then anything of the same type, keeping that order within
+	// each group.
+	G_MarkedListPrune(team, ENTITYNUM_NONE);
+	for (i = 0; i < level.numMarkedBuildables[team]; i++) {
+		ent = g_entities + level.markedBuildableNums[team][i];
 
 		if (ent->health <= 0)
 			continue;
 
-		if (ent->biteam != team)
+		if (ent->s.modelindex == BA_A_HOVEL && ent->active)
 			continue;
 
-		// Don't allow destruction of hovel with granger inside
-		if (ent->s.modelindex == BA_A_HOVEL && ent->active) {
-			if (buildable == BA_A_HOVEL)
-				return IBE_HOVEL;
-			else
-				continue;
-		}
-
 		// Explicitly disallow replacement of the core buildable with anything
 		// other than the core buildable
 		if (ent->s.modelindex == core && buildable != core)
 			continue;
 
-		if (ent->deconstruct) {
-			level.markedBuildables[numBuildables++] = ent;
-
-			if (collision || repeaterInRange) {
-				if (collision)
-					collisionCount--;
-
-				if (repeaterInRange)
-					repeaterInRangeCount--;
-
-				pointsYielded +=
-				    BG_FindBuildPointsForBuildable(ent->s.
-								   modelindex);
-				level.numBuildablesForRemoval++;
-			} else if (unique && ent->s.modelindex == buildable) {
-				// If it's a unique buildable, it must be replaced by the same type
-				pointsYielded +=
-				    BG_FindBuildPointsForBuildable(ent->s.
-								   modelindex);
-				level.numBuildablesForRemoval++;
-			}
+		collision =
+		    G_BuildablesIntersect(buildable, origin, ent->s.modelindex,
+					  ent->s.origin);
+		repeaterInRange = (buildable == BA_H_REPEATER &&
+				   buildable == ent->s.modelindex &&
+				   Distance(ent->s.origin, origin) <
+				   REPEATER_BASESIZE);
+
+		if (collision || repeaterInRange) {
+			if (collision)
+				collisionCount--;
+
+			if (repeaterInRange)
+				repeaterInRangeCount--;
+
+			pointsYielded +=
+			    BG_FindBuildPointsForBuildable(ent->s.modelindex);
+			level.numBuildablesForRemoval++;
+		} else if (unique && ent->s.modelindex == buildable) {
+			// If it's a unique buildable, it must be replaced by the same type
+			pointsYielded +=
+			    BG_FindBuildPointsForBuildable(ent->s.modelindex);
+			level.numBuildablesForRemoval++;
 		}
+
+		if (collision)
+			removalGroups[numBuildables] = 0;
+		else if (ent->s.modelindex == buildable)
+			removalGroups[numBuildables] = 1;
+		else
+			removalGroups[numBuildables] = 2;
+		removalCandidates[numBuildables++] = ent;
 	}
 
 	// We still need build points, but have no candidates for removal
@@ -3309,11 +3487,13 @@ static itemBuildError_t G_SufficientBPAvailable(buildable_t buildable,
 	if (repeaterInRangeCount > 0)
 		return IBE_RPTWARN2;
 
-	// Sort the list
-	cmpBuildable = buildable;
-	VectorCopy(origin, cmpOrigin);
-	qsort(level.markedBuildables, numBuildables,
-	      sizeof(level.markedBuildables[0]), G_CompareBuildablesForRemoval);
+	for (group = 0, n = 0; group < 3; group++) {
+		for (i = 0; i < numBuildables; i++) {
+			if (removalGroups[i] == group)
+				level.markedBuildables[n++] =
+				    removalCandidates[i];
+		}
+	}
 
 	// Determine if there are enough markees to yield the required BP
 	for (;
@@ -3380,107 +3560,71 @@ static void G_SetBuildableMarkedLinkState(qboolean link)
 
 /*
 ================
-G_CanBuild
+G_BuildCheck
 
-Checks to see if a buildable can be built
+Run the checks on building buildable at origin that depend on other
+buildables, no build markers and build points rather than on traces.  The
+results are kept for ent's client and reused while it asks about the same
+spot and none of those have changed.
 ================
 */
-itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
-			    int distance, vec3_t origin)
+static buildCheck_t *G_BuildCheck(gentity_t * ent, buildable_t buildable,
+				  vec3_t origin)
 {
-	vec3_t angles;
-	vec3_t entity_origin, normal;
-	vec3_t mins, maxs, nbmins, nbmaxs;
-	vec3_t nbVect;
-	trace_t tr1, tr2, tr3;
-	int i;
-	itemBuildError_t reason = IBE_NONE;
+	buildCheck_t *check = &level.buildChecks[ent->s.number];
+	vec3_t nbmins, nbmaxs, nbVect;
 	gentity_t *tempent;
-	float minNormal;
-	qboolean invert;
-	int contents;
-	playerState_t *ps = &ent->client->ps;
-	gentity_t *tmp;
-	itemBuildError_t tempReason;
-
-	// Stop all buildables from interacting with traces
-	if (!g_stackableBuildings.integer)
-		G_SetBuildableLinkState(qfalse);
-
-	BG_FindBBoxForBuildable(buildable, mins, maxs);
-
-	BG_PositionBuildableRelativeToPlayer(ps, mins, maxs, trap_Trace,
-					     entity_origin, angles, &tr1);
-
-	trap_Trace(&tr2, entity_origin, mins, maxs, entity_origin,
-		   ent->s.number, MASK_PLAYERSOLID);
-	trap_Trace(&tr3, ps->origin, NULL, NULL, entity_origin, ent->s.number,
-		   MASK_PLAYERSOLID);
-
-	VectorCopy(entity_origin, origin);
+	int team = ent->client->ps.stats[STAT_PTEAM];
+	int buildPoints, spawns;
+	int i;
 
-	VectorCopy(tr1.plane.normal, normal);
-	minNormal = BG_FindMinNormalForBuildable(buildable);
-	invert = BG_FindInvertNormalForBuildable(buildable);
+	if (BG_FindTeamForBuildable(buildable) == BIT_ALIENS) {
+		buildPoints = level.alienBuildPoints;
+		spawns = level.numAlienSpawns;
+	} else {
+		buildPoints = level.humanBuildPoints;
+		spawns = level.numHumanSpawns;
+	}
 
-	if (!g_stackableBuildings.integer) {
-		//can we build at this angle?
-		if (!
-		    (normal[2] >= minNormal
-		     || (invert && normal[2] <= -minNormal)))
-			reason = IBE_NORMAL;
+	if (check->buildable == buildable &&
+	    check->generation == level.buildGeneration &&
+	    check->team == team && VectorCompare(check->origin, origin) &&
+	    check->buildPoints == buildPoints && check->spawns == spawns) {
+		level.numBuildablesForRemoval = check->numRemovals;
+		for (i = 0; i < check->numRemovals; i++)
+			level.markedBuildables[i] =
+			    g_entities + check->removals[i];
 
-		if (tr1.entityNum != ENTITYNUM_WORLD)
-			reason = IBE_NORMAL;
+		return check;
 	}
 
-	contents = trap_PointContents(entity_origin, -1);
+	memset(check, 0, sizeof(*check));
 
 	//check if we are near a nobuild marker, if so, can't build here...
 	for (i = 0; i < MAX_GENTITIES; i++) {
-		tmp = &g_entities[i];
+		tempent = &g_entities[i];
 
-		if (!tmp->noBuild.isNB)
+		if (!tempent->noBuild.isNB)
 			continue;
 
-		nbVect[0] = tmp->noBuild.Area;
-		nbVect[1] = tmp->noBuild.Area;
-		nbVect[2] = tmp->noBuild.Height;
+		nbVect[0] = tempent->noBuild.Area;
+		nbVect[1] = tempent->noBuild.Area;
+		nbVect[2] = tempent->noBuild.Height;
 
 		VectorSubtract(origin, nbVect, nbmins);
 		VectorAdd(origin, nbVect, nbmaxs);
 
-		if (trap_EntityContact(nbmins, nbmaxs, tmp))
-			reason = IBE_PERMISSION;
-
+		if (trap_EntityContact(nbmins, nbmaxs, tempent))
+			check->noBuild = qtrue;
 	}
-	if (ent->client->ps.stats[STAT_PTEAM] == PTE_ALIENS) {
-		//alien criteria
-
-		if (buildable == BA_A_HOVEL) {
-			vec3_t builderMins, builderMaxs;
-
-			//this assumes the adv builder is the biggest thing that'll use the hovel
-			BG_FindBBoxForClass(PCL_ALIEN_BUILDER0_UPG, builderMins,
-					    builderMaxs, NULL, NULL, NULL);
-
-			if (APropHovel_Blocked(origin, angles, normal, ent))
-				reason = IBE_HOVELEXIT;
-		}
 
+	if (team == PTE_ALIENS) {
 		//check there is creep near by for building on
 		if (BG_FindCreepTestForBuildable(buildable)) {
-			if (!G_IsCreepHere(entity_origin))
-				reason = IBE_NOCREEP;
+			if (!G_IsCreepHere(origin))
+				check->noCreep = qtrue;
 		}
 
-		//check permission to build here
-		if (tr1.surfaceFlags & SURF_NOALIENBUILD
-		    || tr1.surfaceFlags & SURF_NOBUILD
-		    || contents & CONTENTS_NOALIENBUILD
-		    || contents & CONTENTS_NOBUILD)
-			reason = IBE_PERMISSION;
-
 		//look for an Overmind
 		for (i = 1, tempent = g_entities + i; i < level.num_entities;
 		     i++, tempent++) {
@@ -3493,7 +3637,7 @@ itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
 
 		//if none found...
 		if (i >= level.num_entities && buildable != BA_A_OVERMIND)
-			reason = IBE_NOOVERMIND;
+			check->noOvermind = qtrue;
 
 		//can we only have one of these?
 		if (BG_FindUniqueTestForBuildable(buildable)) {
@@ -3506,11 +3650,12 @@ itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
 				    && !tempent->deconstruct) {
 					switch (buildable) {
 					case BA_A_OVERMIND:
-						reason = IBE_OVERMIND;
+						check->uniqueReason =
+						    IBE_OVERMIND;
 						break;
 
 					case BA_A_HOVEL:
-						reason = IBE_HOVEL;
+						check->uniqueReason = IBE_HOVEL;
 						break;
 
 					default:
@@ -3524,18 +3669,15 @@ itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
 				}
 			}
 		}
-	} else if (ent->client->ps.stats[STAT_PTEAM] == PTE_HUMANS) {
-		//human criteria
-		if (!G_IsPowered(entity_origin)) {
-			//tell player to build a repeater to provide power
-			if (buildable != BA_H_REACTOR
-			    && buildable != BA_H_REPEATER)
-				reason = IBE_REPEATER;
-		}
+	} else if (team == PTE_HUMANS) {
+		//tell player to build a repeater to provide power
+		if (!G_IsPowered(origin) && buildable != BA_H_REACTOR
+		    && buildable != BA_H_REPEATER)
+			check->unpowered = qtrue;
 
 		//this buildable requires a DCC
 		if (BG_FindDCCTestForBuildable(buildable) && !G_IsDCCBuilt())
-			reason = IBE_NODCC;
+			check->noDCC = qtrue;
 
 		//check that there is a parent reactor when building a repeater
 		if (buildable == BA_H_REPEATER) {
@@ -3550,6 +3692,7 @@ itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
 
 			if (i >= level.num_entities) {
 				//no reactor present
+				check->repeaterReason = IBE_RPTWARN;
 
 				//check for other nearby repeaters
 				for (i = 1, tempent = g_entities + i;
@@ -3560,26 +3703,17 @@ itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
 					if (tempent->s.modelindex ==
 					    BA_H_REPEATER
 					    && Distance(tempent->s.origin,
-							entity_origin) <
+							origin) <
 					    REPEATER_BASESIZE) {
-						reason = IBE_RPTWARN2;
+						check->repeaterReason =
+						    IBE_RPTWARN2;
 						break;
 					}
 				}
-
-				if (reason == IBE_NONE)
-					reason = IBE_RPTWARN;
-			} else if (G_IsPowered(entity_origin))
-				reason = IBE_RPTWARN2;
+			} else if (G_IsPowered(origin))
+				check->repeaterReason = IBE_RPTWARN2;
 		}
 
-		//check permission to build here
-		if (tr1.surfaceFlags & SURF_NOHUMANBUILD
-		    || tr1.surfaceFlags & SURF_NOBUILD
-		    || contents & CONTENTS_NOHUMANBUILD
-		    || contents & CONTENTS_NOBUILD)
-			reason = IBE_PERMISSION;
-
 		//can we only build one of these?
 		if (BG_FindUniqueTestForBuildable(buildable)) {
 			for (i = 1, tempent = g_entities + i;
@@ -3589,16 +3723,150 @@ itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
 
 				if (tempent->s.modelindex == BA_H_REACTOR
 				    && !tempent->deconstruct) {
-					reason = IBE_REACTOR;
+					check->uniqueReason = IBE_REACTOR;
 					break;
 				}
 			}
 		}
 	}
 
-	if ((tempReason =
-	     G_SufficientBPAvailable(buildable, origin)) != IBE_NONE)
-		reason = tempReason;
+	check->bpReason = G_SufficientBPAvailable(buildable, origin);
+
+	// only a successful check needs its removals, as they're forgotten
+	// otherwise
+	if (check->bpReason == IBE_NONE) {
+		if (level.numBuildablesForRemoval > BUILDCHECK_MAX_REMOVALS)
+			return check;
+
+		check->numRemovals = level.numBuildablesForRemoval;
+		for (i = 0; i < check->numRemovals; i++)
+			check->removals[i] = level.markedBuildables[i]->s.number;
+	}
+
+	check->generation = level.buildGeneration;
+	check->buildable = buildable;
+	check->team = team;
+	VectorCopy(origin, check->origin);
+	check->buildPoints = buildPoints;
+	check->spawns = spawns;
+
+	return check;
+}
+
+/*
+================
+G_CanBuild
+
+Checks to see if a buildable can be built
+================
+*/
+itemBuildError_t G_CanBuild(gentity_t * ent, buildable_t buildable,
+			    int distance, vec3_t origin)
+{
+	vec3_t angles;
+	vec3_t entity_origin, normal;
+	vec3_t mins, maxs;
+	trace_t tr1, tr2, tr3;
+	itemBuildError_t reason = IBE_NONE;
+	float minNormal;
+	qboolean invert;
+	int contents;
+	playerState_t *ps = &ent->client->ps;
+	buildCheck_t *check;
+
+	// Stop all buildables from interacting with traces
+	if (!g_stackableBuildings.integer)
+		G_SetBuildableLinkState(qfalse);
+
+	BG_FindBBoxForBuildable(buildable, mins, maxs);
+
+	BG_PositionBuildableRelativeToPlayer(ps, mins, maxs, trap_Trace,
+					     entity_origin, angles, &tr1);
+
+	trap_Trace(&tr2, entity_origin, mins, maxs, entity_origin,
+		   ent->s.number, MASK_PLAYERSOLID);
+	trap_Trace(&tr3, ps->origin, NULL, NULL, entity_origin, ent->s.number,
+		   MASK_PLAYERSOLID);
+
+	VectorCopy(entity_origin, origin);
+
+	VectorCopy(tr1.plane.normal, normal);
+	minNormal = BG_FindMinNormalForBuildable(buildable);
+	invert = BG_FindInvertNormalForBuildable(buildable);
+
+	if (!g_stackableBuildings.integer) {
+		//can we build at this angle?
+		if (!
+		    (normal[2] >= minNormal
+		     || (invert && normal[2] <= -minNormal)))
+			reason = IBE_NORMAL;
+
+		if (tr1.entityNum != ENTITYNUM_WORLD)
+			reason = IBE_NORMAL;
+	}
+
+	contents = trap_PointContents(entity_origin, -1);
+
+	check = G_BuildCheck(ent, buildable, origin);
+
+	if (check->noBuild)
+		reason = IBE_PERMISSION;
+
+	if (ent->client->ps.stats[STAT_PTEAM] == PTE_ALIENS) {
+		//alien criteria
+
+		if (buildable == BA_A_HOVEL) {
+			vec3_t builderMins, builderMaxs;
+
+			//this assumes the adv builder is the biggest thing that'll use the hovel
+			BG_FindBBoxForClass(PCL_ALIEN_BUILDER0_UPG, builderMins,
+					    builderMaxs, NULL, NULL, NULL);
+
+			if (APropHovel_Blocked(origin, angles, normal, ent))
+				reason = IBE_HOVELEXIT;
+		}
+
+		if (check->noCreep)
+			reason = IBE_NOCREEP;
+
+		//check permission to build here
+		if (tr1.surfaceFlags & SURF_NOALIENBUILD
+		    || tr1.surfaceFlags & SURF_NOBUILD
+		    || contents & CONTENTS_NOALIENBUILD
+		    || contents & CONTENTS_NOBUILD)
+			reason = IBE_PERMISSION;
+
+		if (check->noOvermind)
+			reason = IBE_NOOVERMIND;
+
+		if (check->uniqueReason != IBE_NONE)
+			reason = check->uniqueReason;
+	} else if (ent->client->ps.stats[STAT_PTEAM] == PTE_HUMANS) {
+		//human criteria
+		if (check->unpowered)
+			reason = IBE_REPEATER;
+
+		if (check->noDCC)
+			reason = IBE_NODCC;
+
+		if (check->repeaterReason == IBE_RPTWARN2 ||
+		    (check->repeaterReason == IBE_RPTWARN &&
+		     reason == IBE_NONE))
+			reason = check->repeaterReason;
+
+		//check permission to build here
+		if (tr1.surfaceFlags & SURF_NOHUMANBUILD
+		    || tr1.surfaceFlags & SURF_NOBUILD
+		    || contents & CONTENTS_NOHUMANBUILD
+		    || contents & CONTENTS_NOBUILD)
+			reason = IBE_PERMISSION;
+
+		if (check->uniqueReason != IBE_NONE)
+			reason = check->uniqueReason;
+	}
+
+	if (check->bpReason != IBE_NONE)
+		reason = check->bpReason;
 
 	// Relink buildables
 	if (!g_stackableBuildings.integer)
@@ -3657,6 +3925,7 @@ static gentity_t *G_Build(gentity_t * builder, buildable_t buildable,
 	gentity_t *built;
 	buildHistory_t *new;
 	vec3_t normal;
+	logEvent_t ev;
 
 	// initialise the buildhistory so other functions can use it
 	if (builder && builder->client) {
@@ -3671,6 +3940,7 @@ static gentity_t *G_Build(gentity_t * builder, buildable_t buildable,
 	built = G_Spawn();
 
 	built->s.eType = ET_BUILDABLE;
+	level.buildGeneration++;
 
 	built->classname = BG_FindEntityNameForBuildable(buildable);
 
@@ -3916,6 +4186,22 @@ static gentity_t *G_Build(gentity_t * builder, buildable_t buildable,
 			    builder->client->ps.clientNum, built->s.modelindex,
 			    builder->client->pers.netname,
 			    BG_FindNameForBuildable(built->s.modelindex));
+
+		if (G_LogEventBegin(&ev, "build")) {
+			G_LogEventInt(&ev, "client",
+				      builder->client->ps.clientNum);
+			G_LogEventString(&ev, "name",
+					 builder->client->pers.netname);
+			G_LogEventInt(&ev, "team", built->biteam);
+			G_LogEventInt(&ev, "buildable", built->s.modelindex);
+			G_LogEventString(&ev, "buildableName",
+					 BG_FindNameForBuildable(built->s.
+								 modelindex));
+			G_LogEventInt(&ev, "x", (int)built->s.origin[0]);
+			G_LogEventInt(&ev, "y", (int)built->s.origin[1]);
+			G_LogEventInt(&ev, "z", (int)built->s.origin[2]);
+			G_LogEventEnd(&ev);
+		}
 	}
 
 	// ok we're all done building, so what we log here should be the final values
@@ -3957,6 +4243,7 @@ static void G_SpawnMarker(vec3_t origin)
 	nb->noBuild.Area = level.nbArea;
 	nb->noBuild.Height = level.nbHeight;
 	trap_LinkEntity(nb);
+	level.buildGeneration++;
 
 	// Log markers made...
 	for (i = 0; i < MAX_GENTITIES; i++) {
@@ -4509,7 +4796,7 @@ void G_SpawnRevertedBuildable(buildHistory_t * bh, qboolean mark)
 		built->r.contents = 0;
 		built->think = G_CommitRevertedBuildable;
 		built->nextthink = level.time;
-		built->deconstruct = mark;
+		G_MarkBuildable(built, mark);
 	}
 	for (i = 0; i < j; i++)
 		toRecontent[i]->r.contents = CONTENTS_BODY;
@@ -4834,6 +5121,7 @@ void G_NobuildLoad(void)
 			nb->noBuild.Area = area;
 			nb->noBuild.Height = height;
 			trap_LinkEntity(nb);
+			level.buildGeneration++;
 
 			// Log markers made...
 			for (i = 0; i < MAX_GENTITIES; i++) {
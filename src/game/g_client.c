@@ -433,18 +433,21 @@ go to a random point that doesn't telefrag
 gentity_t *G_SelectAlienSpawnPoint(vec3_t preference)
 {
 	gentity_t *spot;
-	int count;
+	int i, count;
 	gentity_t *spots[MAX_SPAWN_POINTS];
 
 	if (level.numAlienSpawns <= 0)
 		return NULL;
 
 	count = 0;
-	spot = NULL;
 
-	while ((spot = G_Find(spot, FOFS(classname),
-			      BG_FindEntityNameForBuildable(BA_A_SPAWN))) !=
-	       NULL) {
+	for (i = 0; i < level.numAlienSpawnPoints; i++) {
+		spot = level.alienSpawnPoints[i];
+
+		if (!spot->inuse || spot->s.eType != ET_BUILDABLE ||
+		    spot->s.modelindex != BA_A_SPAWN)
+			continue;
+
 		if (!spot->spawned)
 			continue;
 
@@ -457,9 +460,7 @@ gentity_t *G_SelectAlienSpawnPoint(vec3_t preference)
 		if (spot->clientSpawnTime > 0)
 			continue;
 
-		if (G_CheckSpawnPoint(spot->s.number, spot->s.origin,
-				      spot->s.origin2, BA_A_SPAWN,
-				      NULL) != NULL)
+		if (G_SpawnPointBlocker(spot) != NULL)
 			continue;
 
 		spots[count] = spot;
@@ -482,18 +483,21 @@ go to a random point that doesn't telefrag
 gentity_t *G_SelectHumanSpawnPoint(vec3_t preference)
 {
 	gentity_t *spot;
-	int count;
+	int i, count;
 	gentity_t *spots[MAX_SPAWN_POINTS];
 
 	if (level.numHumanSpawns <= 0)
 		return NULL;
 
 	count = 0;
-	spot = NULL;
 
-	while ((spot = G_Find(spot, FOFS(classname),
-			      BG_FindEntityNameForBuildable(BA_H_SPAWN))) !=
-	       NULL) {
+	for (i = 0; i < level.numHumanSpawnPoints; i++) {
+		spot = level.humanSpawnPoints[i];
+
+		if (!spot->inuse || spot->s.eType != ET_BUILDABLE ||
+		    spot->s.modelindex != BA_H_SPAWN)
+			continue;
+
 		if (!spot->spawned)
 			continue;
 
@@ -506,9 +510,7 @@ gentity_t *G_SelectHumanSpawnPoint(vec3_t preference)
 		if (spot->clientSpawnTime > 0)
 			continue;
 
-		if (G_CheckSpawnPoint(spot->s.number, spot->s.origin,
-				      spot->s.origin2, BA_H_SPAWN,
-				      NULL) != NULL)
+		if (G_SpawnPointBlocker(spot) != NULL)
 			continue;
 
 		spots[count] = spot;
@@ -1067,6 +1069,43 @@ static qboolean G_NonSegModel(const char *filename)
 	return qfalse;
 }
 
+/*
+===========
+ClientUserinfoHash
+============
+*/
+static unsigned int ClientUserinfoHash(const char *userinfo)
+{
+	unsigned int hash = 2166136261U;
+
+	while (*userinfo)
+		hash = (hash ^ (byte) * userinfo++) * 16777619U;
+
+	return hash;
+}
+
+/*
+===========
+ClientUserinfoUnchanged
+
+Clients can resend the same userinfo as often as they like, so the engine's
+userinfo changes are only passed on to ClientUserinfoChanged when the
+string differs from the one it last left the client with.
+============
+*/
+qboolean ClientUserinfoUnchanged(int clientNum)
+{
+	char userinfo[MAX_INFO_STRING];
+	gclient_t *client = g_entities[clientNum].client;
+
+	if (!client)
+		return qfalse;
+
+	trap_GetUserinfo(clientNum, userinfo, sizeof(userinfo));
+
+	return ClientUserinfoHash(userinfo) == client->pers.userinfoHash;
+}
+
 /*
 ===========
 ClientUserInfoChanged
@@ -1082,7 +1121,7 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 {
 	gentity_t *ent;
 	int teamTask, teamLeader, health;
-	char *s;
+	const char *s;
 	char model[MAX_QPATH];
 	char buffer[MAX_QPATH];
 	char filename[MAX_QPATH];
@@ -1092,9 +1131,8 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 	qboolean revertName = qfalse;
 	qboolean showRenameMsg = qtrue;
 	gclient_t *client;
-	char c1[MAX_INFO_STRING];
-	char c2[MAX_INFO_STRING];
 	char userinfo[MAX_INFO_STRING];
+	infoIndex_t info;
 	pTeam_t team;
 
 	ent = g_entities + clientNum;
@@ -1110,14 +1148,16 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 				"dropped: illegal or malformed userinfo");
 	}
 
+	Info_Parse(userinfo, &info);
+
 	// check for local client
-	s = Info_ValueForKey(userinfo, "ip");
+	s = Info_IndexValue(&info, "ip");
 
 	if (!strcmp(s, "localhost"))
 		client->pers.localClient = qtrue;
 
 	// check the item prediction
-	s = Info_ValueForKey(userinfo, "cg_predictItems");
+	s = Info_IndexValue(&info, "cg_predictItems");
 
 	if (!atoi(s))
 		client->pers.predictItemPickup = qfalse;
@@ -1126,7 +1166,7 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 
 	// set name
 	Q_strncpyz(oldname, client->pers.netname, sizeof(oldname));
-	s = Info_ValueForKey(userinfo, "name");
+	s = Info_IndexValue(&info, "name");
 
 	if (!G_admin_permission(ent, ADMF_SPECIALNAME))
 		ClientCleanName(s, newname, sizeof(newname), qfalse);
@@ -1204,11 +1244,15 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 		}
 	}
 
+	client->pers.userinfoHash = ClientUserinfoHash(userinfo);
+
 	if (client->sess.sessionTeam == TEAM_SPECTATOR) {
 		if (client->sess.spectatorState == SPECTATOR_SCOREBOARD)
 			Q_strncpyz(client->pers.netname, "scoreboard",
 				   sizeof(client->pers.netname));
 	}
+	G_SanitiseString(client->pers.netname, client->pers.sanitisedName,
+			 sizeof(client->pers.sanitisedName));
 
 	if (client->pers.connected >= CON_CONNECTING && showRenameMsg) {
 		if (strcmp(oldname, client->pers.netname)) {
@@ -1254,7 +1298,7 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 		}
 	}
 	// set max health
-	health = atoi(Info_ValueForKey(userinfo, "handicap"));
+	health = atoi(Info_IndexValue(&info, "handicap"));
 	client->pers.maxHealth = health;
 
 	if (client->pers.maxHealth < 1 || client->pers.maxHealth > 100)
@@ -1301,7 +1345,7 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 			client->ps.persistant[PERS_STATE] &= ~PS_NONSEGMODEL;
 	}
 	// wallwalk follow
-	s = Info_ValueForKey(userinfo, "cg_wwFollow");
+	s = Info_IndexValue(&info, "cg_wwFollow");
 
 	if (atoi(s))
 		client->ps.persistant[PERS_STATE] |= PS_WALLCLIMBINGFOLLOW;
@@ -1309,7 +1353,7 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 		client->ps.persistant[PERS_STATE] &= ~PS_WALLCLIMBINGFOLLOW;
 
 	// wallwalk toggle
-	s = Info_ValueForKey(userinfo, "cg_wwToggle");
+	s = Info_IndexValue(&info, "cg_wwToggle");
 
 	if (atoi(s))
 		client->ps.persistant[PERS_STATE] |= PS_WALLCLIMBINGTOGGLE;
@@ -1317,28 +1361,28 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 		client->ps.persistant[PERS_STATE] &= ~PS_WALLCLIMBINGTOGGLE;
 
 	// teamInfo
-	s = Info_ValueForKey(userinfo, "teamoverlay");
+	s = Info_IndexValue(&info, "teamoverlay");
 
 	if (!*s || atoi(s) != 0)
 		client->pers.teamInfo = qtrue;
 	else
 		client->pers.teamInfo = qfalse;
 
-	s = Info_ValueForKey(userinfo, "cg_unlagged");
+	// only our cgame can take scoreboards split over several commands
+	s = Info_IndexValue(&info, "cg_scoresMore");
+	client->pers.scoresMore = atoi(s) ? qtrue : qfalse;
+
+	s = Info_IndexValue(&info, "cg_unlagged");
 	if (!s[0] || atoi(s) != 0)
 		client->pers.useUnlagged = qtrue;
 	else
 		client->pers.useUnlagged = qfalse;
 
 	// team task (0 = none, 1 = offence, 2 = defence)
-	teamTask = atoi(Info_ValueForKey(userinfo, "teamtask"));
+	teamTask = atoi(Info_IndexValue(&info, "teamtask"));
 	// team Leader (1 = leader, 0 is normal player)
 	teamLeader = client->sess.teamLeader;
 
-	// colors
-	strcpy(c1, Info_ValueForKey(userinfo, "color1"));
-	strcpy(c2, Info_ValueForKey(userinfo, "color2"));
-
 	team = client->pers.teamSelection;
 
 	// send over a subset of the userinfo keys so other clients can
@@ -1348,11 +1392,13 @@ void ClientUserinfoChanged(int clientNum, qboolean forceName)
 			    "n\\%s\\t\\%i\\model\\%s\\hmodel\\%s\\c1\\%s\\c2\\%s\\"
 			    "hc\\%i\\w\\%i\\l\\%i\\tt\\%d\\"
 			    "tl\\%d\\ig\\%16s\\pronoun\\%s",
-			    client->pers.netname, team, model, model, c1, c2,
+			    client->pers.netname, team, model, model,
+			    Info_IndexValue(&info, "color1"),
+			    Info_IndexValue(&info, "color2"),
 			    client->pers.maxHealth, client->sess.wins,
 			    client->sess.losses, teamTask, teamLeader,
 			    BG_ClientListString(&client->sess.ignoreList),
-			    Info_ValueForKey(userinfo, "cg_pronoun"));
+			    Info_IndexValue(&info, "cg_pronoun"));
 
 		trap_SetConfigstring(CS_PLAYERS + clientNum, userinfo);
 	} else {
@@ -1415,9 +1461,10 @@ restarts.
 */
 const char *ClientConnect(int clientNum, qboolean firstTime)
 {
-	char *value;
+	const char *value;
 	gclient_t *client;
 	char userinfo[MAX_INFO_STRING];
+	infoIndex_t info;
 	gentity_t *ent;
 	char guid[33];
 	char ip[16] = { "" };
@@ -1430,9 +1477,13 @@ const char *ClientConnect(int clientNum, qboolean firstTime)
 	if (ent->client && ent->client->pers.connected != CON_DISCONNECTED)
 		ClientDisconnect(clientNum);
 
+	G_ResetServerCommands(clientNum);
+
 	trap_GetUserinfo(clientNum, userinfo, sizeof(userinfo));
 
-	value = Info_ValueForKey(userinfo, "cl_guid");
+	Info_Parse(userinfo, &info);
+
+	value = Info_IndexValue(&info, "cl_guid");
 	Q_strncpyz(guid, value, sizeof(guid));
 
 	// check for admin ban
@@ -1444,7 +1495,7 @@ const char *ClientConnect(int clientNum, qboolean firstTime)
 	// https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=500
 	// recommanding PB based IP / GUID banning, the builtin system is pretty limited
 	// check to see if they are on the banned IP list
-	value = Info_ValueForKey(userinfo, "ip");
+	value = Info_IndexValue(&info, "ip");
 	i = 0;
 	while (*value && i < sizeof(ip) - 1) {
 		if (*value != '.' && (*value < '0' || *value > '9'))
@@ -1457,10 +1508,10 @@ const char *ClientConnect(int clientNum, qboolean firstTime)
 		return "You are banned from this server.";
 
 	if (strlen(ip) < 7
-	    && strcmp(Info_ValueForKey(userinfo, "ip"), "localhost")) {
+	    && strcmp(Info_IndexValue(&info, "ip"), "localhost")) {
 		G_AdminsPrintf
 		    ("Connect from client with invalid IP: '%s' NAME: '%s^7'\n",
-		     ip, Info_ValueForKey(userinfo, "name"));
+		     ip, Info_IndexValue(&info, "name"));
 		return "Invalid client data";
 	}
 	// limit max clients per IP
@@ -1481,13 +1532,13 @@ const char *ClientConnect(int clientNum, qboolean firstTime)
 		if (count + 1 > g_maxGhosts.integer) {
 			G_AdminsPrintf
 			    ("Connect from client exceeds %d maximum connections per IP: '%s' NAME: '%s^7'\n",
-			     g_maxGhosts.integer, ip, Info_ValueForKey(userinfo,
-								       "name"));
+			     g_maxGhosts.integer, ip, Info_IndexValue(&info,
+								      "name"));
 			return "Maximum simultaneous clients exceeded";
 		}
 	}
 	// check for a password
-	value = Info_ValueForKey(userinfo, "password");
+	value = Info_IndexValue(&info, "password");
 
 	if (g_password.string[0] && Q_stricmp(g_password.string, "none") &&
 	    strcmp(g_password.string, value) != 0)
@@ -1497,30 +1548,18 @@ const char *ClientConnect(int clientNum, qboolean firstTime)
 
 	if (!(G_admin_permission_guid(guid, ADMF_NOAUTOBAHN)
 	      || G_admin_permission_guid(guid, ADMF_IMMUNITY))) {
-		extern g_admin_namelog_t *g_admin_namelog[128];
-		for (i = 0; i < MAX_ADMIN_NAMELOGS && g_admin_namelog[i]; ++i) {
-			if (!Q_stricmp(g_admin_namelog[i]->ip, ip)
-			    || !Q_stricmp(g_admin_namelog[i]->guid, guid)) {
-				schachtmeisterJudgement_t *j =
-				    &g_admin_namelog[i]->smj;
-				if (j->ratingTime) {
-					if (j->rating >=
-					    g_schachtmeisterClearThreshold.
-					    integer)
-						break;
-					else if (j->rating <=
-						 g_schachtmeisterAutobahnThreshold.
-						 integer) {
-						G_LogAutobahn(ent, userinfo,
-							      j->rating, qtrue);
-						return
-						    g_schachtmeisterAutobahnMessage.
-						    string;
-					}
-					smj = j;
-				}
-				break;
+		g_admin_namelog_t *namelog = G_admin_namelog_find(ip, guid);
+
+		if (namelog && namelog->smj.ratingTime &&
+		    namelog->smj.rating <
+		    g_schachtmeisterClearThreshold.integer) {
+			if (namelog->smj.rating <=
+			    g_schachtmeisterAutobahnThreshold.integer) {
+				G_LogAutobahn(ent, userinfo,
+					      namelog->smj.rating, qtrue);
+				return g_schachtmeisterAutobahnMessage.string;
 			}
+			smj = &namelog->smj;
 		}
 	}
 	// they can connect
@@ -2041,6 +2080,10 @@ void ClientDisconnect(int clientNum)
 	if (!ent->client)
 		return;
 
+	// whatever is still queued has to reach the engine before it drops
+	// the client
+	G_FlushServerCommands(clientNum);
+
 	// discard this player's vote
 	if (level.voteTime && level.votedHow[clientNum]) {
 		if (level.votedHow[clientNum] > 0) {
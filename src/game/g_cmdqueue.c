@@ -0,0 +1,340 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_cmdqueue.c -- per client queue of outgoing reliable commands
+//
+// Everything the game sends with trap_SendServerCommand is held here until
+// the client's ClientEndFrame (or the end of G_RunFrame) instead of going
+// straight to the engine.  While queued:
+//
+//  - consecutive "print"s are merged into one command
+//  - a new "cp" replaces any "cp" that hasn't been sent yet
+//  - a new "scores" or "tinfo" replaces the stale one, since only the
+//    latest state matters
+//
+// This keeps the number of reliable commands per frame down, which is what
+// gets clients kicked for reliable command overflow.
+
+#include "g_local.h"
+
+#define MAX_QUEUED_COMMANDS   32
+#define COMMAND_QUEUE_SIZE    4096
+#define MAX_COMMAND_LENGTH    (MAX_STRING_CHARS - 2)	// what the engine keeps
+
+typedef struct {
+	serverCommandType_t type;
+	int offset;		// into commandQueue_t.text
+	int length;
+	qboolean mergeable;	// print "..." with nothing else after it
+	qboolean superseded;
+} queuedCommand_t;
+
+typedef struct {
+	int numCommands;
+	queuedCommand_t commands[MAX_QUEUED_COMMANDS];
+	int textLength;
+	char text[COMMAND_QUEUE_SIZE];
+
+	// statistics, reset on connect
+	int requested[SCT_NUM_TYPES];
+	int sent[SCT_NUM_TYPES];
+	int bytes[SCT_NUM_TYPES];
+} commandQueue_t;
+
+static commandQueue_t commandQueues[MAX_CLIENTS];
+
+static const char *commandTypeNames[SCT_NUM_TYPES] = {
+	"print",
+	"cp",
+	"chat",
+	"scores",
+	"tinfo",
+	"other"
+};
+
+/*
+================
+G_ServerCommandType
+================
+*/
+static serverCommandType_t G_ServerCommandType(const char *text)
+{
+	if (!Q_strncmp(text, "print ", 6))
+		return SCT_PRINT;
+	if (!Q_strncmp(text, "cp ", 3))
+		return SCT_CP;
+	if (!Q_strncmp(text, "chat ", 5) || !Q_strncmp(text, "tchat ", 6))
+		return SCT_CHAT;
+	if (!Q_strncmp(text, "scores ", 7) ||
+	    !Q_strncmp(text, "scoresmore ", 11))
+		return SCT_SCORES;
+	if (!Q_strncmp(text, "tinfo ", 6))
+		return SCT_TINFO;
+
+	return SCT_OTHER;
+}
+
+/*
+================
+G_MergeablePrint
+
+Is text exactly print "..." with no other quotes, so that the text of a
+following print can be spliced in before the closing quote?
+================
+*/
+static qboolean G_MergeablePrint(const char *text, int length)
+{
+	const char *s;
+
+	if (length < 8 || Q_strncmp(text, "print \"", 7)
+	    || text[length - 1] != '"')
+		return qfalse;
+
+	for (s = text + 7; s < text + length - 1; s++) {
+		if (*s == '"')
+			return qfalse;
+	}
+
+	return qtrue;
+}
+
+/*
+================
+G_SendQueuedCommand
+================
+*/
+static void G_SendQueuedCommand(int clientNum, serverCommandType_t type,
+				const char *text, int length)
+{
+	commandQueue_t *queue = &commandQueues[clientNum];
+
+	trap_SendServerCommandNow(clientNum, text);
+	queue->sent[type]++;
+	queue->bytes[type] += length;
+}
+
+/*
+================
+G_FlushServerCommands
+
+Hand everything queued for clientNum to the engine, or for every client if
+clientNum is -1
+================
+*/
+void G_FlushServerCommands(int clientNum)
+{
+	commandQueue_t *queue;
+	queuedCommand_t *cmd;
+	int i;
+
+	if (clientNum < 0) {
+		for (i = 0; i < level.maxclients; i++)
+			G_FlushServerCommands(i);
+
+		return;
+	}
+
+	if (clientNum >= MAX_CLIENTS)
+		return;
+
+	queue = &commandQueues[clientNum];
+
+	for (i = 0, cmd = queue->commands; i < queue->numCommands; i++, cmd++) {
+		if (cmd->superseded)
+			continue;
+
+		G_SendQueuedCommand(clientNum, cmd->type,
+				    queue->text + cmd->offset, cmd->length);
+	}
+
+	queue->numCommands = 0;
+	queue->textLength = 0;
+}
+
+/*
+================
+G_ResetServerCommands
+
+Forget anything queued for a client slot and clear its statistics
+================
+*/
+void G_ResetServerCommands(int clientNum)
+{
+	if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+		return;
+
+	memset(&commandQueues[clientNum], 0, sizeof(commandQueues[0]));
+}
+
+/*
+================
+G_SupersedeCommands
+
+Mark every queued command of the given type as not worth sending
+================
+*/
+static void G_SupersedeCommands(commandQueue_t * queue,
+				serverCommandType_t type)
+{
+	int i;
+
+	for (i = 0; i < queue->numCommands; i++) {
+		if (queue->commands[i].type == type)
+			queue->commands[i].superseded = qtrue;
+	}
+}
+
+/*
+================
+trap_SendServerCommand
+
+Queue a reliable command for a client.  Broadcasts (clientNum -1) go out
+straight away, after anything already queued so the order is kept.
+================
+*/
+void trap_SendServerCommand(int clientNum, const char *text)
+{
+	commandQueue_t *queue;
+	queuedCommand_t *cmd, *last;
+	serverCommandType_t type;
+	int i, length;
+
+	type = G_ServerCommandType(text);
+	length = strlen(text);
+
+	if (clientNum < 0 || clientNum >= MAX_CLIENTS) {
+		G_FlushServerCommands(-1);
+		trap_SendServerCommandNow(clientNum, text);
+
+		for (i = 0; i < level.maxclients; i++) {
+			if (level.clients[i].pers.connected == CON_DISCONNECTED)
+				continue;
+
+			commandQueues[i].requested[type]++;
+			commandQueues[i].sent[type]++;
+			commandQueues[i].bytes[type] += length;
+		}
+
+		return;
+	}
+
+	queue = &commandQueues[clientNum];
+	queue->requested[type]++;
+
+	last = queue->numCommands ? &queue->commands[queue->numCommands - 1]
+	    : NULL;
+
+	// splice the text of this print onto the end of the previous one
+	if (type == SCT_PRINT && last && last->mergeable &&
+	    G_MergeablePrint(text, length) &&
+	    last->length + length - 8 <= MAX_COMMAND_LENGTH &&
+	    queue->textLength + length - 8 < COMMAND_QUEUE_SIZE) {
+		// overwrite the closing quote and NUL of the last one
+		memcpy(queue->text + last->offset + last->length - 1,
+		       text + 7, length - 7 + 1);
+		last->length += length - 8;
+		queue->textLength += length - 8;
+		return;
+	}
+
+	if (type == SCT_CP || type == SCT_TINFO)
+		G_SupersedeCommands(queue, type);
+	else if (type == SCT_SCORES && !Q_strncmp(text, "scores ", 7))
+		G_SupersedeCommands(queue, type);	// along with its scoresmore
+
+	// make room, or don't bother queueing what won't fit anyway
+	if (queue->numCommands == MAX_QUEUED_COMMANDS ||
+	    queue->textLength + length + 1 > COMMAND_QUEUE_SIZE)
+		G_FlushServerCommands(clientNum);
+
+	if (length + 1 > COMMAND_QUEUE_SIZE) {
+		G_SendQueuedCommand(clientNum, type, text, length);
+		return;
+	}
+
+	cmd = &queue->commands[queue->numCommands++];
+	cmd->type = type;
+	cmd->offset = queue->textLength;
+	cmd->length = length;
+	cmd->mergeable = (type == SCT_PRINT && G_MergeablePrint(text, length));
+	cmd->superseded = qfalse;
+
+	memcpy(queue->text + queue->textLength, text, length + 1);
+	queue->textLength += length + 1;
+}
+
+/*
+================
+Svcmd_CommandStats_f
+
+cmdstats [slot]
+================
+*/
+void Svcmd_CommandStats_f(void)
+{
+	char arg[MAX_TOKEN_CHARS];
+	int i, j, first, last;
+	commandQueue_t *queue;
+	int totalRequested, totalSent, totalBytes;
+
+	first = 0;
+	last = level.maxclients - 1;
+
+	if (trap_Argc() > 1) {
+		trap_Argv(1, arg, sizeof(arg));
+		first = last = atoi(arg);
+
+		if (first < 0 || first >= level.maxclients) {
+			G_Printf("cmdstats: invalid slot %d\n", first);
+			return;
+		}
+	}
+
+	for (i = first; i <= last; i++) {
+		if (level.clients[i].pers.connected == CON_DISCONNECTED)
+			continue;
+
+		queue = &commandQueues[i];
+		totalRequested = totalSent = totalBytes = 0;
+
+		G_Printf("%2d %s^7\n", i, level.clients[i].pers.netname);
+		G_Printf("   %-7s %9s %9s %10s\n", "type", "requested", "sent",
+			 "bytes");
+
+		for (j = 0; j < SCT_NUM_TYPES; j++) {
+			if (!queue->requested[j])
+				continue;
+
+			G_Printf("   %-7s %9d %9d %10d\n", commandTypeNames[j],
+				 queue->requested[j], queue->sent[j],
+				 queue->bytes[j]);
+
+			totalRequested += queue->requested[j];
+			totalSent += queue->sent[j];
+			totalBytes += queue->bytes[j];
+		}
+
+		G_Printf("   %-7s %9d %9d %10d\n", "total", totalRequested,
+			 totalSent, totalBytes);
+	}
+}
@@ -0,0 +1,322 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_cmdrecord.c -- record everything the engine feeds the game
+//
+// With g_cmdRecord set when a map starts, every connect, userinfo change,
+// usercmd, client command, console command and frame the engine hands the
+// game until it shuts down is written to cmdrecords/<map>-<time>.rec.
+// gamehost -replay feeds a recording back through vmMain in the same order,
+// which drives ClientThink_real and G_RunFrame with the load of a real
+// match.  The format is in g_public.h.
+
+#include "g_local.h"
+
+#define CMDRECORD_BUFFER 16384
+
+static fileHandle_t cmdRecordFile;
+static byte cmdRecordBuffer[CMDRECORD_BUFFER];
+static int cmdRecordLength;
+static int cmdRecordTime;
+static usercmd_t cmdRecordLast[MAX_CLIENTS];
+
+/*
+================
+G_CmdRecordFlush
+================
+*/
+static void G_CmdRecordFlush(void)
+{
+	if (!cmdRecordLength)
+		return;
+
+	trap_FS_Write(cmdRecordBuffer, cmdRecordLength, cmdRecordFile);
+	cmdRecordLength = 0;
+}
+
+/*
+================
+G_CmdRecordByte
+================
+*/
+static void G_CmdRecordByte(int b)
+{
+	if (cmdRecordLength == CMDRECORD_BUFFER)
+		G_CmdRecordFlush();
+
+	cmdRecordBuffer[cmdRecordLength++] = b;
+}
+
+/*
+================
+G_CmdRecordVarint
+================
+*/
+static void G_CmdRecordVarint(unsigned int value)
+{
+	while (value >= 0x80) {
+		G_CmdRecordByte((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+
+	G_CmdRecordByte(value);
+}
+
+/*
+================
+G_CmdRecordSigned
+
+Zigzag encoded, so small negative numbers stay short
+================
+*/
+static void G_CmdRecordSigned(int value)
+{
+	if (value < 0)
+		G_CmdRecordVarint(~((unsigned int)value << 1));
+	else
+		G_CmdRecordVarint((unsigned int)value << 1);
+}
+
+/*
+================
+G_CmdRecordString
+================
+*/
+static void G_CmdRecordString(const char *s)
+{
+	int i, length = strlen(s);
+
+	G_CmdRecordVarint(length);
+	for (i = 0; i < length; i++)
+		G_CmdRecordByte((byte) s[i]);
+}
+
+/*
+================
+G_CmdRecordArgs
+
+Each argument on its own, so that quoting comes back the same
+================
+*/
+static void G_CmdRecordArgs(void)
+{
+	char arg[MAX_STRING_CHARS];
+	int i, argc = trap_Argc();
+
+	G_CmdRecordVarint(argc);
+	for (i = 0; i < argc; i++) {
+		trap_Argv(i, arg, sizeof(arg));
+		G_CmdRecordString(arg);
+	}
+}
+
+/*
+================
+G_CmdRecordStart
+
+Open a new recording if g_cmdRecord is set
+================
+*/
+void G_CmdRecordStart(int levelTime, int randomSeed, int restart)
+{
+	char map[MAX_QPATH];
+	char path[MAX_QPATH];
+	qtime_t qt;
+
+	if (cmdRecordFile || !g_cmdRecord.integer)
+		return;
+
+	trap_Cvar_VariableStringBuffer("mapname", map, sizeof(map));
+	trap_RealTime(&qt);
+	Com_sprintf(path, sizeof(path),
+		    "cmdrecords/%s-%04i%02i%02i-%02i%02i%02i.rec", map,
+		    qt.tm_year + 1900, qt.tm_mon + 1, qt.tm_mday, qt.tm_hour,
+		    qt.tm_min, qt.tm_sec);
+
+	trap_FS_FOpenFile(path, &cmdRecordFile, FS_WRITE);
+	if (!cmdRecordFile) {
+		G_Printf("WARNING: Couldn't open usercmd recording %s\n", path);
+		return;
+	}
+
+	G_Printf("Recording usercmds to %s\n", path);
+
+	cmdRecordLength = 0;
+	cmdRecordTime = levelTime;
+	memset(cmdRecordLast, 0, sizeof(cmdRecordLast));
+
+	G_CmdRecordByte(CMDRECORD_IDENT & 0xFF);
+	G_CmdRecordByte((CMDRECORD_IDENT >> 8) & 0xFF);
+	G_CmdRecordByte((CMDRECORD_IDENT >> 16) & 0xFF);
+	G_CmdRecordByte((CMDRECORD_IDENT >> 24) & 0xFF);
+	G_CmdRecordVarint(CMDRECORD_VERSION);
+
+	G_CmdRecordByte(CR_INIT);
+	G_CmdRecordVarint(levelTime);
+	G_CmdRecordVarint(randomSeed);
+	G_CmdRecordVarint(restart);
+	G_CmdRecordVarint(g_maxclients.integer);
+	G_CmdRecordString(map);
+}
+
+/*
+================
+G_CmdRecordStop
+================
+*/
+void G_CmdRecordStop(void)
+{
+	if (!cmdRecordFile)
+		return;
+
+	G_CmdRecordByte(CR_SHUTDOWN);
+	G_CmdRecordFlush();
+	trap_FS_FCloseFile(cmdRecordFile);
+	cmdRecordFile = 0;
+}
+
+/*
+================
+G_CmdRecordFrame
+================
+*/
+void G_CmdRecordFrame(int levelTime)
+{
+	if (!cmdRecordFile)
+		return;
+
+	G_CmdRecordByte(CR_FRAME);
+	G_CmdRecordVarint(levelTime - cmdRecordTime);
+	cmdRecordTime = levelTime;
+}
+
+/*
+================
+G_CmdRecordClient
+
+A client event, with its userinfo for CR_CONNECT and CR_USERINFO
+================
+*/
+void G_CmdRecordClient(cmdRecordType_t type, int clientNum, int firstTime)
+{
+	char userinfo[MAX_INFO_STRING];
+
+	if (!cmdRecordFile)
+		return;
+
+	G_CmdRecordByte(type);
+	G_CmdRecordVarint(clientNum);
+
+	if (type == CR_CONNECT) {
+		G_CmdRecordVarint(firstTime);
+		memset(&cmdRecordLast[clientNum], 0,
+		       sizeof(cmdRecordLast[0]));
+	}
+
+	if (type == CR_CONNECT || type == CR_USERINFO) {
+		trap_GetUserinfo(clientNum, userinfo, sizeof(userinfo));
+		G_CmdRecordString(userinfo);
+	}
+}
+
+/*
+================
+G_CmdRecordCommand
+
+The current command from clientNum, or from the console if it is -1
+================
+*/
+void G_CmdRecordCommand(int clientNum)
+{
+	if (!cmdRecordFile)
+		return;
+
+	if (clientNum < 0)
+		G_CmdRecordByte(CR_CONSOLE);
+	else {
+		G_CmdRecordByte(CR_COMMAND);
+		G_CmdRecordVarint(clientNum);
+	}
+
+	G_CmdRecordArgs();
+}
+
+/*
+================
+G_CmdRecordThink
+
+Only the fields that changed since the client's last usercmd are written
+================
+*/
+void G_CmdRecordThink(int clientNum, const usercmd_t * cmd)
+{
+	usercmd_t *last = &cmdRecordLast[clientNum];
+	int flags = 0;
+
+	if (!cmdRecordFile)
+		return;
+
+	if (cmd->serverTime != last->serverTime)
+		flags |= CRF_SERVERTIME;
+	if (cmd->angles[0] != last->angles[0])
+		flags |= CRF_ANGLE0;
+	if (cmd->angles[1] != last->angles[1])
+		flags |= CRF_ANGLE1;
+	if (cmd->angles[2] != last->angles[2])
+		flags |= CRF_ANGLE2;
+	if (cmd->buttons != last->buttons)
+		flags |= CRF_BUTTONS;
+	if (cmd->weapon != last->weapon)
+		flags |= CRF_WEAPON;
+	if (cmd->forwardmove != last->forwardmove)
+		flags |= CRF_FORWARDMOVE;
+	if (cmd->rightmove != last->rightmove)
+		flags |= CRF_RIGHTMOVE;
+	if (cmd->upmove != last->upmove)
+		flags |= CRF_UPMOVE;
+
+	G_CmdRecordByte(CR_THINK);
+	G_CmdRecordVarint(clientNum);
+	G_CmdRecordVarint(flags);
+
+	if (flags & CRF_SERVERTIME)
+		G_CmdRecordSigned(cmd->serverTime - last->serverTime);
+	if (flags & CRF_ANGLE0)
+		G_CmdRecordSigned(cmd->angles[0] - last->angles[0]);
+	if (flags & CRF_ANGLE1)
+		G_CmdRecordSigned(cmd->angles[1] - last->angles[1]);
+	if (flags & CRF_ANGLE2)
+		G_CmdRecordSigned(cmd->angles[2] - last->angles[2]);
+	if (flags & CRF_BUTTONS)
+		G_CmdRecordSigned(cmd->buttons - last->buttons);
+	if (flags & CRF_WEAPON)
+		G_CmdRecordSigned(cmd->weapon - last->weapon);
+	if (flags & CRF_FORWARDMOVE)
+		G_CmdRecordSigned(cmd->forwardmove - last->forwardmove);
+	if (flags & CRF_RIGHTMOVE)
+		G_CmdRecordSigned(cmd->rightmove - last->rightmove);
+	if (flags & CRF_UPMOVE)
+		G_CmdRecordSigned(cmd->upmove - last->upmove);
+
+	*last = *cmd;
+}
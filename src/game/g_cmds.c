@@ -35,7 +35,7 @@ void G_SanitiseString(char *in, char *out, int len)
 	qboolean skip = qtrue;
 	int spaces = 0;
 
-	while (*in && len > 0) {
+	while (*in && len > 1) {
 		// strip leading white space
 		if (*in == ' ') {
 			if (skip) {
@@ -78,7 +78,6 @@ int G_ClientNumberFromString(gentity_t * to, char *s)
 	gclient_t *cl;
 	int idnum;
 	char s2[MAX_STRING_CHARS];
-	char n2[MAX_STRING_CHARS];
 
 	// numeric values are just slot numbers
 	if (s[0] >= '0' && s[0] <= '9') {
@@ -102,9 +101,7 @@ int G_ClientNumberFromString(gentity_t * to, char *s)
 		if (cl->pers.connected == CON_DISCONNECTED)
 			continue;
 
-		G_SanitiseString(cl->pers.netname, n2, sizeof(n2));
-
-		if (!strcmp(n2, s2))
+		if (!strcmp(cl->pers.sanitisedName, s2))
 			return idnum;
 	}
 
@@ -165,7 +162,6 @@ int G_ClientNumbersFromString(char *s, int *plist)
 {
 	gclient_t *p;
 	int i, found = 0;
-	char n2[MAX_NAME_LENGTH] = { "" };
 	char s2[MAX_NAME_LENGTH] = { "" };
 	int max = MAX_CLIENTS;
 
@@ -193,8 +189,7 @@ int G_ClientNumbersFromString(char *s, int *plist)
 		if (p->pers.connected == CON_DISCONNECTED) {
 			continue;
 		}
-		G_SanitiseString(p->pers.netname, n2, sizeof(n2));
-		if (strstr(n2, s2)) {
+		if (strstr(p->pers.sanitisedName, s2)) {
 			*plist++ = i;
 			found++;
 		}
@@ -205,87 +200,202 @@ int G_ClientNumbersFromString(char *s, int *plist)
 
 /*
 ==================
-ScoreboardMessage
+Scoreboard cache
+
+The "scores" payload only differs by which team the viewer is on: players
+only get weapon and upgrade information for their own team, spectators get
+it for everyone.  One copy is kept per viewing team and re-serialised only
+when an entry has actually changed, or at most once per frame after
+CalculateRanks has invalidated it.
+
+A payload too long for one reliable command is split up; the first part is a
+normal "scores" command and the rest are sent as "scoresmore" to cgames that
+set cg_scoresMore in their userinfo.  Others only get the first part, as much
+as fits in one "scores" command.
+==================
+*/
+#define MAX_SCOREBOARD_PARTS  4
+#define SCOREBOARD_PART_SIZE  (MAX_STRING_CHARS - 64)	// room for the header
+
+typedef struct {
+	int client;
+	int score;
+	int ping;
+	int time;
+	int weapon;
+	int upgrade;
+} scoreEntry_t;
+
+typedef struct {
+	int checkTime;		// level.time the entries were last compared
+	int numEntries;
+	scoreEntry_t entries[MAX_CLIENTS];
+	int numParts;
+	int partEntries[MAX_SCOREBOARD_PARTS];
+	char parts[MAX_SCOREBOARD_PARTS][SCOREBOARD_PART_SIZE];
+} scoreboardCache_t;
+
+static scoreboardCache_t scoreboardCache[PTE_NUM_TEAMS];
 
+/*
+==================
+G_InvalidateScoreboard
+
+Force the next ScoreboardMessage to recheck every entry
 ==================
 */
-void ScoreboardMessage(gentity_t * ent)
+void G_InvalidateScoreboard(void)
 {
-	char entry[1024];
-	char string[1400];
-	int stringlength;
-	int i, j;
-	gclient_t *cl;
-	int numSorted;
-	weapon_t weapon = WP_NONE;
-	upgrade_t upgrade = UP_NONE;
+	int i;
 
-	// send the latest information on all clients
-	string[0] = 0;
-	stringlength = 0;
+	for (i = 0; i < PTE_NUM_TEAMS; i++)
+		scoreboardCache[i].checkTime = -1;
+}
 
-	numSorted = level.numConnectedClients;
+/*
+==================
+G_ScoreboardEntry
 
-	for (i = 0; i < numSorted; i++) {
-		int ping;
+Fill in one scoreboard entry as seen by a member of team viewer
+==================
+*/
+static void G_ScoreboardEntry(scoreEntry_t * entry, int clientNum,
+			      pTeam_t viewer)
+{
+	gclient_t *cl = &level.clients[clientNum];
 
-		cl = &level.clients[level.sortedClients[i]];
+	entry->client = clientNum;
+	entry->score = cl->pers.score;
+	entry->time = (level.time - cl->pers.enterTime) / 60000;
 
-		if (cl->pers.connected == CON_CONNECTING)
-			ping = -1;
-		else if (cl->sess.spectatorState == SPECTATOR_FOLLOW)
-			ping = cl->pers.ping < 999 ? cl->pers.ping : 999;
+	if (cl->pers.connected == CON_CONNECTING)
+		entry->ping = -1;
+	else if (cl->sess.spectatorState == SPECTATOR_FOLLOW)
+		entry->ping = cl->pers.ping < 999 ? cl->pers.ping : 999;
+	else
+		entry->ping = cl->ps.ping < 999 ? cl->ps.ping : 999;
+
+	//If (loop) client is a spectator, they have nothing, so indicate such. 
+	//Only send the client requesting the scoreboard the weapon/upgrades information for members of their team. If they are not on a team, send it all.
+	if (cl->sess.sessionTeam != TEAM_SPECTATOR &&
+	    (viewer == PTE_NONE || cl->pers.teamSelection == viewer)) {
+		entry->weapon = cl->ps.weapon;
+
+		if (BG_InventoryContainsUpgrade(UP_BATTLESUIT, cl->ps.stats))
+			entry->upgrade = UP_BATTLESUIT;
+		else if (BG_InventoryContainsUpgrade(UP_JETPACK, cl->ps.stats))
+			entry->upgrade = UP_JETPACK;
+		else if (BG_InventoryContainsUpgrade(UP_BATTPACK, cl->ps.stats))
+			entry->upgrade = UP_BATTPACK;
+		else if (BG_InventoryContainsUpgrade(UP_HELMET, cl->ps.stats))
+			entry->upgrade = UP_HELMET;
+		else if (BG_InventoryContainsUpgrade
+			 (UP_LIGHTARMOUR, cl->ps.stats))
+			entry->upgrade = UP_LIGHTARMOUR;
 		else
-			ping = cl->ps.ping < 999 ? cl->ps.ping : 999;
+			entry->upgrade = UP_NONE;
+	} else {
+		entry->weapon = WP_NONE;
+		entry->upgrade = UP_NONE;
+	}
+}
 
-		//If (loop) client is a spectator, they have nothing, so indicate such. 
-		//Only send the client requesting the scoreboard the weapon/upgrades information for members of their team. If they are not on a team, send it all.
-		if (cl->sess.sessionTeam != TEAM_SPECTATOR &&
-		    (ent->client->pers.teamSelection == PTE_NONE
-		     || cl->pers.teamSelection ==
-		     ent->client->pers.teamSelection)) {
-			weapon = cl->ps.weapon;
+/*
+==================
+G_UpdateScoreboardCache
 
-			if (BG_InventoryContainsUpgrade
-			    (UP_BATTLESUIT, cl->ps.stats))
-				upgrade = UP_BATTLESUIT;
-			else if (BG_InventoryContainsUpgrade
-				 (UP_JETPACK, cl->ps.stats))
-				upgrade = UP_JETPACK;
-			else if (BG_InventoryContainsUpgrade
-				 (UP_BATTPACK, cl->ps.stats))
-				upgrade = UP_BATTPACK;
-			else if (BG_InventoryContainsUpgrade
-				 (UP_HELMET, cl->ps.stats))
-				upgrade = UP_HELMET;
-			else if (BG_InventoryContainsUpgrade
-				 (UP_LIGHTARMOUR, cl->ps.stats))
-				upgrade = UP_LIGHTARMOUR;
-			else
-				upgrade = UP_NONE;
-		} else {
-			weapon = WP_NONE;
-			upgrade = UP_NONE;
+Bring the payload for team viewer up to date
+==================
+*/
+static scoreboardCache_t *G_UpdateScoreboardCache(pTeam_t viewer)
+{
+	scoreboardCache_t *cache = &scoreboardCache[viewer];
+	scoreEntry_t entry;
+	qboolean changed;
+	char line[64];
+	int i, len, partLength;
+
+	if (cache->checkTime == level.time)
+		return cache;
+
+	cache->checkTime = level.time;
+	changed = (cache->numEntries != level.numConnectedClients);
+	cache->numEntries = level.numConnectedClients;
+
+	for (i = 0; i < cache->numEntries; i++) {
+		G_ScoreboardEntry(&entry, level.sortedClients[i], viewer);
+
+		if (changed || entry.client != cache->entries[i].client ||
+		    entry.score != cache->entries[i].score ||
+		    entry.ping != cache->entries[i].ping ||
+		    entry.time != cache->entries[i].time ||
+		    entry.weapon != cache->entries[i].weapon ||
+		    entry.upgrade != cache->entries[i].upgrade) {
+			cache->entries[i] = entry;
+			changed = qtrue;
 		}
+	}
 
-		Com_sprintf(entry, sizeof(entry),
-			    " %d %d %d %d %d %d", level.sortedClients[i],
-			    cl->pers.score, ping,
-			    (level.time - cl->pers.enterTime) / 60000, weapon,
-			    upgrade);
+	if (!changed)
+		return cache;
 
-		j = strlen(entry);
+	cache->numParts = 1;
+	cache->partEntries[0] = 0;
+	cache->parts[0][0] = '\0';
+	partLength = 0;
 
-		if (stringlength + j > 1024)
-			break;
+	for (i = 0; i < cache->numEntries; i++) {
+		scoreEntry_t *e = &cache->entries[i];
+
+		Com_sprintf(line, sizeof(line), " %d %d %d %d %d %d",
+			    e->client, e->score, e->ping, e->time, e->weapon,
+			    e->upgrade);
+		len = strlen(line);
+
+		if (partLength + len >= SCOREBOARD_PART_SIZE) {
+			if (cache->numParts == MAX_SCOREBOARD_PARTS)
+				break;
+
+			cache->numParts++;
+			cache->partEntries[cache->numParts - 1] = 0;
+			cache->parts[cache->numParts - 1][0] = '\0';
+			partLength = 0;
+		}
 
-		strcpy(string + stringlength, entry);
-		stringlength += j;
+		strcpy(cache->parts[cache->numParts - 1] + partLength, line);
+		partLength += len;
+		cache->partEntries[cache->numParts - 1]++;
 	}
 
-	trap_SendServerCommand(ent - g_entities, va("scores %i %i %i%s", i,
-						    level.alienKills,
-						    level.humanKills, string));
+	return cache;
+}
+
+/*
+==================
+ScoreboardMessage
+
+==================
+*/
+void ScoreboardMessage(gentity_t * ent)
+{
+	scoreboardCache_t *cache;
+	int i;
+
+	cache = G_UpdateScoreboardCache(ent->client->pers.teamSelection);
+
+	trap_SendServerCommand(ent - g_entities,
+			       va("scores %i %i %i%s", cache->partEntries[0],
+				  level.alienKills, level.humanKills,
+				  cache->parts[0]));
+
+	if (!ent->client->pers.scoresMore)
+		return;
+
+	for (i = 1; i < cache->numParts; i++)
+		trap_SendServerCommand(ent - g_entities,
+				       va("scoresmore %i%s",
+					  cache->partEntries[i],
+					  cache->parts[i]));
 }
 
 /*
@@ -805,37 +915,42 @@ void Cmd_Team_f(gentity_t * ent)
 
 /*
 ==================
-G_Say
+G_SayToKind
+
+Decide whether other gets a chat message from ent, and if so which encoding
+of it they need.  Returns -1 if they don't get it at all.
 ==================
 */
-static void G_SayTo(gentity_t * ent, gentity_t * other, int mode, int color,
-		    const char *name, const char *message, const char *prefix)
+#define SAYTO_IGNORED      1	// other ignores ent, sent with [skipnotify]
+#define SAYTO_SPECALLCHAT  2	// spectator reading team chat, gets the team prefix
+#define SAYTO_NUM_KINDS    4
+
+static int G_SayToKind(gentity_t * ent, gentity_t * other, int mode)
 {
-	qboolean ignore = qfalse;
-	qboolean specAllChat = qfalse;
+	int kind = 0;
 
 	if (!other)
-		return;
+		return -1;
 
 	if (!other->inuse)
-		return;
+		return -1;
 
 	if (!other->client)
-		return;
+		return -1;
 
 	if (other->client->pers.connected != CON_CONNECTED)
-		return;
+		return -1;
 
 	if ((mode == SAY_TEAM || mode == SAY_ACTION_T)
 	    && !OnSameTeam(ent, other)) {
 		if (other->client->pers.teamSelection != PTE_NONE)
-			return;
+			return -1;
 
-		specAllChat = G_admin_permission(other, ADMF_SPEC_ALLCHAT);
-		if (!specAllChat)
-			return;
+		if (!G_admin_permission(other, ADMF_SPEC_ALLCHAT))
+			return -1;
 
 		// specs with ADMF_SPEC_ALLCHAT flag can see team chat
+		kind |= SAYTO_SPECALLCHAT;
 	}
 
 	if (mode == SAY_ADMINS &&
@@ -843,44 +958,89 @@ static void G_SayTo(gentity_t * ent, gentity_t * other, int mode, int color,
 	     || other->client->pers.ignoreAdminWarnings
 	     || (g_scrimMode.integer != 0
 		 && !G_admin_permission(ent, ADMF_NOSCRIMRESTRICTION))))
-		return;
+		return -1;
 
 	if (mode == SAY_HADMINS &&
 	    (!G_admin_permission(other, ADMF_HIGHADMINCHAT)
 	     || other->client->pers.ignoreAdminWarnings))
-		return;
+		return -1;
 
 	if (BG_ClientListTest
-	    (&other->client->sess.ignoreList, ent - g_entities))
-		ignore = qtrue;
+	    (&other->client->sess.ignoreList, ent - g_entities)) {
+		if (g_fullIgnore.integer)
+			return -1;
 
-	if (ignore && g_fullIgnore.integer)
-		return;
+		kind |= SAYTO_IGNORED;
+	}
 
-	trap_SendServerCommand(other - g_entities, va("%s \"%s%s%s%c%c%s\"",
-						      (mode == SAY_TEAM
-						       || mode ==
-						       SAY_ACTION_T) ? "tchat" :
-						      "chat",
-						      (ignore) ? "[skipnotify]"
-						      : "",
-						      (specAllChat) ? prefix :
-						      "", name, Q_COLOR_ESCAPE,
-						      color, message));
+	return kind;
+}
+
+/*
+==================
+G_SayTo
+
+Send a chat message to every client in candidates that should get it, or to
+every client if candidates is NULL.  Recipients are sorted in one pass by
+the encoding they need, and each encoding is only built once.
+==================
+*/
+static void G_SayTo(gentity_t * ent, clientList_t * candidates, int mode,
+		    int color, const char *name, const char *message,
+		    const char *prefix)
+{
+	clientList_t audience[SAYTO_NUM_KINDS];
+	int i, kind;
+
+	memset(audience, 0, sizeof(audience));
+
+	for (i = 0; i < level.maxclients; i++) {
+		if (candidates && !BG_ClientListTest(candidates, i))
+			continue;
+
+		kind = G_SayToKind(ent, &g_entities[i], mode);
+		if (kind >= 0)
+			BG_ClientListAdd(&audience[kind], i);
+	}
+
+	for (kind = 0; kind < SAYTO_NUM_KINDS; kind++) {
+		if (!audience[kind].lo && !audience[kind].hi)
+			continue;
+
+		G_ClientListCommand(&audience[kind],
+				    va("%s \"%s%s%s%c%c%s\"",
+				       (mode == SAY_TEAM
+					|| mode == SAY_ACTION_T) ? "tchat" :
+				       "chat",
+				       (kind & SAYTO_IGNORED) ? "[skipnotify]" :
+				       "",
+				       (kind & SAYTO_SPECALLCHAT) ? prefix : "",
+				       name, Q_COLOR_ESCAPE, color, message));
+	}
 }
 
 #define EC    "\x19"
 
+// names of the SAY_* modes for the JSON event log
+static const char *sayModeNames[] = {
+	"all",
+	"team",
+	"tell",
+	"action",
+	"actionteam",
+	"admins",
+	"hadmins"
+};
+
 void G_Say(gentity_t * ent, gentity_t * target, int mode, const char *chatText)
 {
-	int j;
-	gentity_t *other;
 	int color;
 	const char *prefix;
 	char name[64];
 	// don't let text be too long for malicious reasons
 	char text[MAX_SAY_TEXT];
 	char location[64];
+	logEvent_t ev;
 
 	// Bail if the text is blank.
 	if (!chatText[0])
@@ -1079,6 +1239,19 @@ void G_Say(gentity_t * ent, gentity_t * target, int mode, const char *chatText)
 		break;
 	}
 
+	if (G_LogEventBegin(&ev, "say")) {
+		G_LogEventString(&ev, "mode", sayModeNames[mode]);
+		G_LogEventInt(&ev, "client", ent ? ent - g_entities : -1);
+		G_LogEventString(&ev, "name",
+				 ent ? ent->client->pers.netname : "console");
+		G_LogEventInt(&ev, "team",
+			      ent ? ent->client->pers.teamSelection : PTE_NONE);
+		if (target)
+			G_LogEventInt(&ev, "target", target - g_entities);
+		G_LogEventString(&ev, "message", chatText);
+		G_LogEventEnd(&ev);
+	}
+
 	if (mode != SAY_TEAM && ent && ent->client
 	    && ent->client->pers.teamSelection == PTE_NONE
 	    && G_admin_level(ent) < g_minLevelToSpecMM1.integer) {
@@ -1111,17 +1284,18 @@ void G_Say(gentity_t * ent, gentity_t * target, int mode, const char *chatText)
 	}
 
 	if (target) {
-		G_SayTo(ent, target, mode, color, name, text, prefix);
+		clientList_t only;
+
+		memset(&only, 0, sizeof(only));
+		BG_ClientListAdd(&only, target - g_entities);
+		G_SayTo(ent, &only, mode, color, name, text, prefix);
 		return;
 	}
 
 	// Ugly hax: if adminsayfilter is off, do the SAY first to prevent text from going out of order
 	if (!g_adminSayFilter.integer) {
 		// send it to all the apropriate clients
-		for (j = 0; j < level.maxclients; j++) {
-			other = &g_entities[j];
-			G_SayTo(ent, other, mode, color, name, text, prefix);
-		}
+		G_SayTo(ent, NULL, mode, color, name, text, prefix);
 	}
 
 	if (g_adminParseSay.integer && (mode == SAY_ALL || mode == SAY_TEAM)) {
@@ -1132,10 +1306,7 @@ void G_Say(gentity_t * ent, gentity_t * target, int mode, const char *chatText)
 	// if it's on, do it here, where it won't happen if it was an admin command
 	if (g_adminSayFilter.integer) {
 		// send it to all the apropriate clients
-		for (j = 0; j < level.maxclients; j++) {
-			other = &g_entities[j];
-			G_SayTo(ent, other, mode, color, name, text, prefix);
-		}
+		G_SayTo(ent, NULL, mode, color, name, text, prefix);
 	}
 
 }
@@ -1150,6 +1321,7 @@ static void Cmd_SayArea_f(gentity_t * ent)
 	vec3_t mins, maxs;
 	char *msg = ConcatArgs(1);
 	char name[64];
+	clientList_t candidates;
 
 	if (g_floodMinTime.integer)
 		if (G_Flood_Limited(ent)) {
@@ -1183,19 +1355,20 @@ static void Cmd_SayArea_f(gentity_t * ent)
 	VectorAdd(ent->s.origin, range, maxs);
 	VectorSubtract(ent->s.origin, range, mins);
 
+	memset(&candidates, 0, sizeof(candidates));
+
 	num = trap_EntitiesInBox(mins, maxs, entityList, MAX_GENTITIES);
 	for (i = 0; i < num; i++)
-		G_SayTo(ent, &g_entities[entityList[i]], SAY_TEAM, color, name,
-			msg, prefix);
+		BG_ClientListAdd(&candidates, entityList[i]);
 
 	//Send to ADMF_SPEC_ALLCHAT candidates
 	for (i = 0; i < level.maxclients; i++) {
 		if ((&g_entities[i])->client->pers.teamSelection == PTE_NONE &&
-		    G_admin_permission(&g_entities[i], ADMF_SPEC_ALLCHAT)) {
-			G_SayTo(ent, &g_entities[i], SAY_TEAM, color, name, msg,
-				prefix);
-		}
+		    G_admin_permission(&g_entities[i], ADMF_SPEC_ALLCHAT))
+			BG_ClientListAdd(&candidates, i);
 	}
+
+	G_SayTo(ent, &candidates, SAY_TEAM, color, name, msg, prefix);
 }
 
 /*
@@ -3094,7 +3267,7 @@ void Cmd_Destroy_f(gentity_t * ent)
 			// Cancel deconstruction
 			if (g_markDeconstruct.integer == 1
 			    && traceEnt->deconstruct) {
-				traceEnt->deconstruct = qfalse;
+				G_MarkBuildable(traceEnt, qfalse);
 				return;
 			}
 			if ((traceEnt->s.eFlags & EF_DBUILDER) &&
@@ -3158,8 +3331,9 @@ void Cmd_Destroy_f(gentity_t * ent)
 
 			if (traceEnt->health > 0 || g_deconDead.integer) {
 				if (g_markDeconstruct.integer == 1) {
-					traceEnt->deconstruct = qtrue;	// Mark buildable for deconstruction
+					// Mark buildable for deconstruction
 					traceEnt->deconstructTime = level.time;
+					G_MarkBuildable(traceEnt, qtrue);
 				} else {
 					if (traceEnt->health > 0) {
 						buildHistory_t *new;
@@ -3290,7 +3464,7 @@ void Cmd_Mark_f(gentity_t * ent)
 			}
 			// Cancel deconstruction
 			if (traceEnt->deconstruct) {
-				traceEnt->deconstruct = qfalse;
+				G_MarkBuildable(traceEnt, qfalse);
 
 				trap_SendServerCommand(ent - g_entities,
 						       va
@@ -3317,8 +3491,9 @@ void Cmd_Mark_f(gentity_t * ent)
 			}
 
 			if (traceEnt->health > 0) {
-				traceEnt->deconstruct = qtrue;	// Mark buildable for deconstruction
+				// Mark buildable for deconstruction
 				traceEnt->deconstructTime = level.time;
+				G_MarkBuildable(traceEnt, qtrue);
 
 				trap_SendServerCommand(ent - g_entities,
 						       va
@@ -4009,7 +4184,7 @@ void Cmd_Protect_f(gentity_t * ent)
 			traceEnt->s.eFlags |= EF_DBUILDER;
 
 			// adding protection turns off deconstruction mark
-			traceEnt->deconstruct = qfalse;
+			G_MarkBuildable(traceEnt, qfalse);
 		}
 	}
 }
@@ -5691,6 +5866,7 @@ void G_CP(gentity_t * ent)
 	qboolean sendAliens = qtrue;
 	qboolean sendHumans = qtrue;
 	qboolean sendSpecs = qtrue;
+	clientList_t recipients, admins;
 	Q_strncpyz(buffer, ConcatArgs(1), sizeof(buffer));
 	G_ParseEscapedString(buffer);
 
@@ -5743,6 +5919,9 @@ void G_CP(gentity_t * ent)
 
 	G_WordWrap(wrappedtext, 50);
 
+	memset(&recipients, 0, sizeof(recipients));
+	memset(&admins, 0, sizeof(admins));
+
 	for (i = 0; i < level.maxclients; i++) {
 		if (level.clients[i].pers.connected == CON_DISCONNECTED)
 			continue;
@@ -5753,22 +5932,24 @@ void G_CP(gentity_t * ent)
 			&& level.clients[i].pers.teamSelection == PTE_HUMANS)
 		    || (!sendSpecs
 			&& level.clients[i].pers.teamSelection == PTE_NONE)) {
-			if (G_admin_permission(&g_entities[i], ADMF_ADMINCHAT)) {
-				trap_SendServerCommand(i,
-						       va
-						       ("print \"^7[^fADMIN ALERT^7] CP to other team%s: %s \n\"",
-							prefixes, text));
-			}
+			if (G_admin_permission(&g_entities[i], ADMF_ADMINCHAT))
+				BG_ClientListAdd(&admins, i);
 			continue;
 		}
 
-		trap_SendServerCommand(i, va("cp \"%s\"", wrappedtext));
-		trap_SendServerCommand(i,
-				       va("print \"%s^7 CP%s: %s\n\"",
-					  (ent ? G_admin_adminPrintName(ent) :
-					   "console"), prefixes, text));
+		BG_ClientListAdd(&recipients, i);
 	}
 
+	G_ClientListCommand(&admins,
+			    va
+			    ("print \"^7[^fADMIN ALERT^7] CP to other team%s: %s \n\"",
+			     prefixes, text));
+	G_ClientListCommand(&recipients, va("cp \"%s\"", wrappedtext));
+	G_ClientListCommand(&recipients,
+			    va("print \"%s^7 CP%s: %s\n\"",
+			       (ent ? G_admin_adminPrintName(ent) :
+				"console"), prefixes, text));
+
 	G_Printf("cp: %s\n", ConcatArgs(1));
 }
 
@@ -163,6 +163,7 @@ void player_die(gentity_t * self, gentity_t * inflictor, gentity_t * attacker,
 	float percentDamage = 0.0f;
 	gentity_t *player;
 	qboolean tk = qfalse;
+	logEvent_t ev;
 
 	if (self->client->ps.pm_type == PM_DEAD)
 		return;
@@ -218,6 +219,22 @@ void player_die(gentity_t * self, gentity_t * inflictor, gentity_t * attacker,
 		    killer, self->s.number, meansOfDeath, killerName,
 		    self->client->pers.netname, obit);
 
+	if (G_LogEventBegin(&ev, "kill")) {
+		G_LogEventInt(&ev, "killer", killer);
+		G_LogEventString(&ev, "killerName", killerName);
+		G_LogEventInt(&ev, "victim", self->s.number);
+		G_LogEventString(&ev, "victimName",
+				 self->client->pers.netname);
+		G_LogEventInt(&ev, "victimTeam",
+			      self->client->pers.teamSelection);
+		G_LogEventInt(&ev, "victimClass",
+			      self->client->ps.stats[STAT_PCLASS]);
+		G_LogEventInt(&ev, "mod", meansOfDeath);
+		G_LogEventString(&ev, "modName", obit);
+		G_LogEventInt(&ev, "teamkill", tk);
+		G_LogEventEnd(&ev);
+	}
+
 	//TA: deactivate all upgrades
 	for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++)
 		BG_DeactivateUpgrade(i, self->client->ps.stats);
@@ -1005,6 +1022,45 @@ void G_ParseDmgScript(char *buf, int class)
 	}
 }
 
+/*
+============
+G_HitRotation
+
+The angle, in whole degrees, between the way targ is facing and the way
+the shot came from.  Only the yaw of vectoangles is needed.
+============
+*/
+static int G_HitRotation(const vec3_t targOrigin, const vec3_t point,
+			 gentity_t * targ)
+{
+	vec3_t bulletPath;
+	float yaw;
+	int bulletRotation, clientRotation;
+
+	VectorSubtract(targOrigin, point, bulletPath);
+
+	if (bulletPath[1] == 0 && bulletPath[0] == 0)
+		yaw = 0;
+	else {
+		if (bulletPath[0])
+			yaw = (atan2(bulletPath[1], bulletPath[0]) * 180 /
+			       M_PI);
+		else if (bulletPath[1] > 0)
+			yaw = 90;
+		else
+			yaw = 270;
+
+		if (yaw < 0)
+			yaw += 360;
+	}
+
+	clientRotation = targ->client->ps.viewangles[YAW];
+	bulletRotation = yaw;
+
+	// Keep it in the 0-359 range
+	return abs(clientRotation - bulletRotation) % 360;
+}
+
 /*
 ============
 G_CalcDamageModifier
@@ -1014,14 +1070,13 @@ static float G_CalcDamageModifier(vec3_t point, gentity_t * targ,
 				  gentity_t * attacker, int class, int dflags)
 {
 	vec3_t targOrigin;
-	vec3_t bulletPath;
-	vec3_t bulletAngle;
 	vec3_t pMINUSfloor, floor, normal;
 
 	float clientHeight, hitRelative, hitRatio;
-	int bulletRotation, clientRotation, hitRotation;
+	int hitRotation, ducked;
+	int *stats;
 	float modifier = 1.0f;
-	int i, j;
+	int i;
 
 	if (point == NULL)
 		return 1.0f;
@@ -1029,6 +1084,18 @@ static float G_CalcDamageModifier(vec3_t point, gentity_t * targ,
 	if (dflags & DAMAGE_NO_MOD)
 		return 1.0f;
 
+	stats = targ->client->ps.stats;
+
+	if (dflags & DAMAGE_NO_LOCDAMAGE) {
+		//average all of each upgrade's armour regions together
+		for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
+			if (BG_InventoryContainsUpgrade(i, stats))
+				modifier *= G_ArmourAverageModifier(i);
+		}
+
+		return modifier;
+	}
+
 	if (g_unlagged.integer && targ->client
 	    && targ->client->unlaggedCalc.used)
 		VectorCopy(targ->client->unlaggedCalc.origin, targOrigin);
@@ -1055,119 +1122,30 @@ static float G_CalcDamageModifier(vec3_t point, gentity_t * targ,
 
 	hitRatio = hitRelative / clientHeight;
 
-	VectorSubtract(targOrigin, point, bulletPath);
-	vectoangles(bulletPath, bulletAngle);
-
-	clientRotation = targ->client->ps.viewangles[YAW];
-	bulletRotation = bulletAngle[YAW];
-
-	hitRotation = abs(clientRotation - bulletRotation);
-
-	hitRotation = hitRotation % 360;	// Keep it in the 0-359 range
-
-	if (dflags & DAMAGE_NO_LOCDAMAGE) {
-		for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
-			float totalModifier = 0.0f;
-			float averageModifier = 1.0f;
-
-			//average all of this upgrade's armour regions together
-			if (BG_InventoryContainsUpgrade
-			    (i, targ->client->ps.stats)) {
-				for (j = 0; j < g_numArmourRegions[i]; j++)
-					totalModifier +=
-					    g_armourRegions[i][j].modifier;
-
-				if (g_numArmourRegions[i])
-					averageModifier =
-					    totalModifier /
-					    g_numArmourRegions[i];
-				else
-					averageModifier = 1.0f;
-			}
+	// skip the trig when no region cares about the angle
+	if (G_DamageRegionsAngular(class, stats))
+		hitRotation = G_HitRotation(targOrigin, point, targ);
+	else
+		hitRotation = 0;
 
-			modifier *= averageModifier;
-		}
-	} else {
-		if (attacker && attacker->client) {
-			attacker->client->pers.statscounters.hitslocational++;
-			level.alienStatsCounters.hitslocational++;
-		}
-		for (i = 0; i < g_numDamageRegions[class]; i++) {
-			qboolean rotationBound;
-
-			if (g_damageRegions[class][i].minAngle >
-			    g_damageRegions[class][i].maxAngle) {
-				rotationBound =
-				    (hitRotation >=
-				     g_damageRegions[class][i].minAngle
-				     && hitRotation <= 360) || (hitRotation >= 0
-								&& hitRotation
-								<=
-								g_damageRegions
-								[class][i].
-								maxAngle);
-			} else {
-				rotationBound =
-				    (hitRotation >=
-				     g_damageRegions[class][i].minAngle
-				     && hitRotation <=
-				     g_damageRegions[class][i].maxAngle);
-			}
+	ducked = targ->client->ps.pm_flags & PMF_DUCKED;
 
-			if (rotationBound &&
-			    hitRatio >= g_damageRegions[class][i].minHeight &&
-			    hitRatio <= g_damageRegions[class][i].maxHeight &&
-			    (g_damageRegions[class][i].crouch ==
-			     (targ->client->ps.pm_flags & PMF_DUCKED)))
-				modifier *= g_damageRegions[class][i].modifier;
-		}
+	if (attacker && attacker->client) {
+		attacker->client->pers.statscounters.hitslocational++;
+		level.alienStatsCounters.hitslocational++;
+	}
 
-		if (attacker && attacker->client && modifier == 2) {
-			attacker->client->pers.statscounters.headshots++;
-			level.alienStatsCounters.headshots++;
-		}
+	modifier = G_ClassDamageModifier(class, hitRatio, hitRotation, ducked);
 
-		for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
-			if (BG_InventoryContainsUpgrade
-			    (i, targ->client->ps.stats)) {
-				for (j = 0; j < g_numArmourRegions[i]; j++) {
-					qboolean rotationBound;
-
-					if (g_armourRegions[i][j].minAngle >
-					    g_armourRegions[i][j].maxAngle) {
-						rotationBound =
-						    (hitRotation >=
-						     g_armourRegions[i][j].
-						     minAngle
-						     && hitRotation <= 360)
-						    || (hitRotation >= 0
-							&& hitRotation <=
-							g_armourRegions[i][j].
-							maxAngle);
-					} else {
-						rotationBound =
-						    (hitRotation >=
-						     g_armourRegions[i][j].
-						     minAngle
-						     && hitRotation <=
-						     g_armourRegions[i][j].
-						     maxAngle);
-					}
+	if (attacker && attacker->client && modifier == 2) {
+		attacker->client->pers.statscounters.headshots++;
+		level.alienStatsCounters.headshots++;
+	}
 
-					if (rotationBound &&
-					    hitRatio >=
-					    g_armourRegions[i][j].minHeight
-					    && hitRatio <=
-					    g_armourRegions[i][j].maxHeight
-					    && (g_armourRegions[i][j].crouch ==
-						(targ->client->ps.
-						 pm_flags & PMF_DUCKED)))
-						modifier *=
-						    g_armourRegions[i][j].
-						    modifier;
-				}
-			}
-		}
+	for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
+		if (BG_InventoryContainsUpgrade(i, stats))
+			modifier = G_ArmourDamageModifier(i, modifier, hitRatio,
+							  hitRotation, ducked);
 	}
 
 	return modifier;
@@ -1242,6 +1220,8 @@ void G_InitDamageLocations(void)
 
 		G_ParseArmourScript(buffer, i);
 	}
+
+	G_BakeDamageGrids();
 }
 
 ////////TA: locdamage
@@ -1669,6 +1649,9 @@ void G_Damage(gentity_t * targ, gentity_t * inflictor, gentity_t * attacker,
 			if (targ->health < -999)
 				targ->health = -999;
 
+			if (targ->s.eType == ET_BUILDABLE)
+				level.buildGeneration++;
+
 			targ->enemy = attacker;
 			targ->die(targ, inflictor, attacker, take, mod);
 			return;
@@ -0,0 +1,483 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_damagegrid.c -- lookup grids for locational damage and armour
+//
+// Each class's locdamage regions and each upgrade's armour regions are
+// baked into a grid of modifiers indexed by hit angle, hit height and
+// crouching.  Angles are whole degrees, so degrees that fall in the same
+// regions share an angle band and the grid is exact along that axis.
+// Heights are cut into DAMAGEGRID_HEIGHTS bins, plus one for the very top
+// that hits are often clamped to.  A bin that a region's edge passes
+// through can't be answered from the grid, and neither can an armour cell
+// where several regions multiply, since their product wouldn't round the
+// same way.  Those cells hold DAMAGEGRID_ANALYTIC and go through the
+// region list like before, so the grid never changes a modifier.
+//
+// g_damageGrid 0 skips the grid and 2 checks every hit against the region
+// lists.  The damagegrid command checks every cell of every grid.
+
+#include "g_local.h"
+
+#define DAMAGEGRID_HEIGHTS   32	// a power of two, so bins are exact
+#define DAMAGEGRID_MAX_BANDS 64
+#define DAMAGEGRID_CELLS     32768
+#define DAMAGEGRID_ANALYTIC  -1.0f
+
+typedef struct {
+	qboolean baked;
+	int numBands;
+	byte bands[360];	// angle band of each whole degree
+	float *cells;		// [band][height][ducked]
+} damageGrid_t;
+
+static damageGrid_t classGrids[PCL_NUM_CLASSES];
+static damageGrid_t armourGrids[UP_NUM_UPGRADES];
+static float armourAverages[UP_NUM_UPGRADES];
+
+static float damageGridCells[DAMAGEGRID_CELLS];
+static int damageGridCellsUsed;
+
+/*
+================
+G_RegionAngleBound
+
+Does a region cover hitRotation?  A region whose minAngle is greater than
+its maxAngle wraps around through 0.
+================
+*/
+static qboolean G_RegionAngleBound(const damageRegion_t * region,
+				   int hitRotation)
+{
+	if (region->minAngle > region->maxAngle)
+		return (hitRotation >= region->minAngle && hitRotation <= 360)
+		    || (hitRotation >= 0 && hitRotation <= region->maxAngle);
+
+	return hitRotation >= region->minAngle &&
+	    hitRotation <= region->maxAngle;
+}
+
+/*
+================
+G_LocDamageModifier
+
+Multiply modifier by every region that covers the hit, in order
+================
+*/
+float G_LocDamageModifier(const damageRegion_t * regions, int numRegions,
+			  float modifier, float hitRatio, int hitRotation,
+			  int ducked)
+{
+	int i;
+
+	for (i = 0; i < numRegions; i++) {
+		if (G_RegionAngleBound(&regions[i], hitRotation) &&
+		    hitRatio >= regions[i].minHeight &&
+		    hitRatio <= regions[i].maxHeight &&
+		    regions[i].crouch == ducked)
+			modifier *= regions[i].modifier;
+	}
+
+	return modifier;
+}
+
+/*
+================
+G_DamageGridHeight
+
+The height bin of hitRatio, or -1 if it is out of range
+================
+*/
+static int G_DamageGridHeight(float hitRatio)
+{
+	if (!(hitRatio >= 0.0f && hitRatio <= 1.0f))
+		return -1;
+
+	return (int)(hitRatio * DAMAGEGRID_HEIGHTS);
+}
+
+/*
+================
+G_BakeDamageGrid
+
+Returns qfalse if there were too many angle bands or no cells left, in
+which case the regions are always checked one by one
+================
+*/
+static qboolean G_BakeDamageGrid(damageGrid_t * grid,
+				 const damageRegion_t * regions,
+				 int numRegions, qboolean armour)
+{
+	int masks[DAMAGEGRID_MAX_BANDS];
+	int i, d, b, h, ducked, mask, count, numCells;
+	float low, high, product;
+	qboolean mixed;
+	float *cell;
+
+	memset(grid, 0, sizeof(*grid));
+
+	// degrees covered by the same regions share a band
+	for (d = 0; d < 360; d++) {
+		mask = 0;
+		for (i = 0; i < numRegions; i++) {
+			if (G_RegionAngleBound(&regions[i], d))
+				mask |= 1 << i;
+		}
+
+		for (b = 0; b < grid->numBands; b++) {
+			if (masks[b] == mask)
+				break;
+		}
+
+		if (b == grid->numBands) {
+			if (b == DAMAGEGRID_MAX_BANDS)
+				return qfalse;
+
+			masks[grid->numBands++] = mask;
+		}
+
+		grid->bands[d] = b;
+	}
+
+	numCells = grid->numBands * (DAMAGEGRID_HEIGHTS + 1) * 2;
+	if (damageGridCellsUsed + numCells > DAMAGEGRID_CELLS)
+		return qfalse;
+
+	grid->cells = damageGridCells + damageGridCellsUsed;
+	damageGridCellsUsed += numCells;
+
+	cell = grid->cells;
+	for (b = 0; b < grid->numBands; b++) {
+		for (h = 0; h <= DAMAGEGRID_HEIGHTS; h++) {
+			// the last bin is only 1.0 itself
+			low = (float)h / DAMAGEGRID_HEIGHTS;
+			high = (float)(h + 1) / DAMAGEGRID_HEIGHTS;
+
+			for (ducked = 0; ducked < 2; ducked++, cell++) {
+				product = 1.0f;
+				count = 0;
+				mixed = qfalse;
+
+				for (i = 0; i < numRegions; i++) {
+					if (!(masks[b] & (1 << i)) ||
+					    regions[i].crouch != ducked)
+						continue;
+
+					if (h == DAMAGEGRID_HEIGHTS) {
+						if (regions[i].minHeight > 1.0f
+						    || regions[i].maxHeight <
+						    1.0f)
+							continue;
+					} else if (regions[i].maxHeight < low ||
+						   regions[i].minHeight >= high)
+						continue;
+					else if (regions[i].minHeight > low ||
+						 regions[i].maxHeight < high) {
+						mixed = qtrue;
+						break;
+					}
+
+					product *= regions[i].modifier;
+					count++;
+				}
+
+				if (mixed || (armour && count > 1) ||
+				    product < 0.0f)
+					*cell = DAMAGEGRID_ANALYTIC;
+				else
+					*cell = product;
+			}
+		}
+	}
+
+	grid->baked = qtrue;
+	return qtrue;
+}
+
+/*
+================
+G_BakeDamageGrids
+
+Called once the locdamage and armour files have been parsed
+================
+*/
+void G_BakeDamageGrids(void)
+{
+	float total;
+	int i, j, failed = 0;
+
+	damageGridCellsUsed = 0;
+
+	for (i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++) {
+		if (!G_BakeDamageGrid(&classGrids[i], g_damageRegions[i],
+				      MIN(g_numDamageRegions[i],
+					  MAX_LOCDAMAGE_REGIONS), qfalse))
+			failed++;
+	}
+
+	for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
+		if (!G_BakeDamageGrid(&armourGrids[i], g_armourRegions[i],
+				      MIN(g_numArmourRegions[i],
+					  MAX_ARMOUR_REGIONS), qtrue))
+			failed++;
+
+		total = 0.0f;
+		for (j = 0; j < g_numArmourRegions[i]; j++)
+			total += g_armourRegions[i][j].modifier;
+
+		armourAverages[i] = g_numArmourRegions[i] ?
+		    total / g_numArmourRegions[i] : 1.0f;
+	}
+
+	if (failed)
+		G_Printf(S_COLOR_YELLOW "WARNING: %d damage region grids "
+			 "couldn't be baked\n", failed);
+}
+
+/*
+================
+G_DamageGridCell
+================
+*/
+static float G_DamageGridCell(const damageGrid_t * grid, float hitRatio,
+			      int hitRotation, int ducked)
+{
+	int h;
+
+	if (!grid->baked || hitRotation < 0 || hitRotation >= 360 ||
+	    (h = G_DamageGridHeight(hitRatio)) < 0)
+		return DAMAGEGRID_ANALYTIC;
+
+	return grid->cells[(grid->bands[hitRotation] *
+			    (DAMAGEGRID_HEIGHTS + 1) + h) * 2 + ducked];
+}
+
+/*
+================
+G_DamageGridModifier
+
+Look a hit up in a grid, falling back to the regions if the grid can't
+answer it.  With g_damageGrid 2 the regions are always checked as well.
+================
+*/
+static float G_DamageGridModifier(const damageGrid_t * grid,
+				  const damageRegion_t * regions,
+				  int numRegions, float modifier,
+				  float hitRatio, int hitRotation, int ducked)
+{
+	float cell, analytic;
+
+	if (!g_damageGrid.integer)
+		return G_LocDamageModifier(regions, numRegions, modifier,
+					   hitRatio, hitRotation, ducked);
+
+	cell = G_DamageGridCell(grid, hitRatio, hitRotation, ducked);
+
+	if (g_damageGrid.integer == 2) {
+		analytic = G_LocDamageModifier(regions, numRegions, modifier,
+					       hitRatio, hitRotation, ducked);
+
+		if (cell != DAMAGEGRID_ANALYTIC && modifier * cell != analytic)
+			G_Printf(S_COLOR_YELLOW "WARNING: damage grid gave %f "
+				 "instead of %f at height %f, angle %d%s\n",
+				 modifier * cell, analytic, hitRatio,
+				 hitRotation, ducked ? ", crouching" : "");
+
+		return analytic;
+	}
+
+	if (cell == DAMAGEGRID_ANALYTIC)
+		return G_LocDamageModifier(regions, numRegions, modifier,
+					   hitRatio, hitRotation, ducked);
+
+	return modifier * cell;
+}
+
+/*
+================
+G_ClassDamageModifier
+================
+*/
+float G_ClassDamageModifier(int class, float hitRatio, int hitRotation,
+			    int ducked)
+{
+	return G_DamageGridModifier(&classGrids[class],
+				    g_damageRegions[class],
+				    MIN(g_numDamageRegions[class],
+					MAX_LOCDAMAGE_REGIONS), 1.0f, hitRatio,
+				    hitRotation, ducked);
+}
+
+/*
+================
+G_ArmourDamageModifier
+================
+*/
+float G_ArmourDamageModifier(int upgrade, float modifier, float hitRatio,
+			     int hitRotation, int ducked)
+{
+	return G_DamageGridModifier(&armourGrids[upgrade],
+				    g_armourRegions[upgrade],
+				    MIN(g_numArmourRegions[upgrade],
+					MAX_ARMOUR_REGIONS), modifier, hitRatio,
+				    hitRotation, ducked);
+}
+
+/*
+================
+G_ArmourAverageModifier
+
+The mean of an upgrade's armour regions, for damage that isn't locational
+================
+*/
+float G_ArmourAverageModifier(int upgrade)
+{
+	return armourAverages[upgrade];
+}
+
+/*
+================
+G_DamageRegionsAngular
+
+Does the angle of a hit on this class, with these upgrades, make any
+difference?  If not there is no need to work it out.
+================
+*/
+qboolean G_DamageRegionsAngular(int class, int stats[])
+{
+	int i;
+
+	if (!g_damageGrid.integer || !classGrids[class].baked ||
+	    classGrids[class].numBands > 1)
+		return qtrue;
+
+	for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
+		if (BG_InventoryContainsUpgrade(i, stats) &&
+		    (!armourGrids[i].baked || armourGrids[i].numBands > 1))
+			return qtrue;
+	}
+
+	return qfalse;
+}
+
+/*
+================
+G_CheckDamageGrid
+
+Compare every cell of a grid with the regions it came from, at both edges
+and the middle of each height bin and at every region's edges.  Returns
+the number of mismatches and adds up the hits the grid answered.
+================
+*/
+static int G_CheckDamageGrid(const damageGrid_t * grid,
+			     const damageRegion_t * regions, int numRegions,
+			     float modifier, int *answered, int *total)
+{
+	float heights[DAMAGEGRID_HEIGHTS * 3 + MAX_LOCDAMAGE_REGIONS * 6 + 1];
+	int i, d, ducked, numHeights, bad = 0;
+	float cell, analytic;
+
+	numHeights = 0;
+	for (i = 0; i < DAMAGEGRID_HEIGHTS; i++) {
+		heights[numHeights++] = (float)i / DAMAGEGRID_HEIGHTS;
+		heights[numHeights++] = (i + 0.5f) / DAMAGEGRID_HEIGHTS;
+		heights[numHeights++] = (i + 0.999f) / DAMAGEGRID_HEIGHTS;
+	}
+	for (i = 0; i < numRegions; i++) {
+		heights[numHeights++] = regions[i].minHeight;
+		heights[numHeights++] = regions[i].minHeight - 0.0001f;
+		heights[numHeights++] = regions[i].minHeight + 0.0001f;
+		heights[numHeights++] = regions[i].maxHeight;
+		heights[numHeights++] = regions[i].maxHeight - 0.0001f;
+		heights[numHeights++] = regions[i].maxHeight + 0.0001f;
+	}
+	heights[numHeights++] = 1.0f;
+
+	for (d = 0; d < 360; d++) {
+		for (ducked = 0; ducked < 2; ducked++) {
+			for (i = 0; i < numHeights; i++) {
+				if (heights[i] < 0.0f || heights[i] > 1.0f)
+					continue;
+
+				cell = G_DamageGridCell(grid, heights[i], d,
+							ducked);
+				analytic = G_LocDamageModifier(regions,
+							       numRegions,
+							       modifier,
+							       heights[i], d,
+							       ducked);
+				(*total)++;
+
+				if (cell == DAMAGEGRID_ANALYTIC)
+					continue;
+
+				(*answered)++;
+				if (modifier * cell != analytic)
+					bad++;
+			}
+		}
+	}
+
+	return bad;
+}
+
+/*
+================
+Svcmd_DamageGrid_f
+
+damagegrid: check every grid against the regions it was baked from
+================
+*/
+void Svcmd_DamageGrid_f(void)
+{
+	int i, bad, answered, total, grids;
+
+	bad = answered = total = grids = 0;
+
+	for (i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++) {
+		if (!classGrids[i].baked)
+			continue;
+
+		grids++;
+		bad += G_CheckDamageGrid(&classGrids[i], g_damageRegions[i],
+					 MIN(g_numDamageRegions[i],
+					     MAX_LOCDAMAGE_REGIONS), 1.0f,
+					 &answered, &total);
+	}
+
+	// armour multiplies whatever the class regions came to
+	for (i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++) {
+		if (!armourGrids[i].baked)
+			continue;
+
+		grids++;
+		bad += G_CheckDamageGrid(&armourGrids[i], g_armourRegions[i],
+					 MIN(g_numArmourRegions[i],
+					     MAX_ARMOUR_REGIONS), 0.7f,
+					 &answered, &total);
+	}
+
+	G_Printf("damagegrid: %d grids in %d of %d cells, %d of %d hits "
+		 "answered from the grid, %d mismatches\n", grids,
+		 damageGridCellsUsed, DAMAGEGRID_CELLS, answered, total, bad);
+}
@@ -0,0 +1,216 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+
+// g_libbench.c -- timing for the string and memory functions
+//
+// libbench times the string and memory functions the game leans on, on
+// short strings like names and long ones like info strings.  A QVM gets
+// them from bg_lib.c, apart from memset and memcpy which are syscalls,
+// while game.so gets the system's, so the same command gives a comparison
+// between the two.  Every test is run at each of the four alignments.
+//
+// G_BenchTime and G_BenchMsec are shared with the other benchmarks that
+// time single calls.
+
+#include "g_local.h"
+
+#define BENCH_DEFAULT_MSEC    100
+#define BENCH_MAX_MSEC        10000
+#define BENCH_MAX_CALLS       (1 << 26)
+
+#define LIBBENCH_LONG          1000
+#define LIBBENCH_SHORT         15
+#define LIBBENCH_BUFFER        1024
+
+typedef enum {
+	LB_STRLEN,
+	LB_STRCPY,
+	LB_STRCMP,
+	LB_STRCHR,
+	LB_MEMMOVE,
+	LB_MEMMOVE_OVERLAP,
+	LB_MEMSET,
+	LB_MEMCPY,
+
+	LB_NUM_TESTS
+} libBenchTest_t;
+
+static const char *libBenchNames[LB_NUM_TESTS] = {
+	"strlen",
+	"strcpy",
+	"strcmp",
+	"strchr",
+	"memmove",
+	"memmove overlap",
+	"memset",
+	"memcpy"
+};
+
+// one copy per alignment, so each can end its strings in the right place
+static char libBenchSource[4][LIBBENCH_BUFFER + 4];
+static char libBenchSame[4][LIBBENCH_BUFFER + 4];
+static char libBenchDest[LIBBENCH_BUFFER + 8];
+
+/*
+================
+G_BenchTime
+
+Nanoseconds per call of run's test, with the number of calls doubled until
+they take at least msec
+================
+*/
+float G_BenchTime(benchRun_t run, int test, int param, int msec, float *sum)
+{
+	int calls, start, taken;
+
+	for (calls = 256;; calls *= 2) {
+		start = trap_Milliseconds();
+		*sum += run(test, param, calls);
+		taken = trap_Milliseconds() - start;
+
+		if (taken >= msec || calls >= BENCH_MAX_CALLS)
+			break;
+	}
+
+	return taken * 1000000.0f / calls;
+}
+
+/*
+================
+G_BenchMsec
+
+Read a benchmark's optional [msec] argument, complaining about it under
+name if it's out of range
+================
+*/
+qboolean G_BenchMsec(const char *name, int *msec)
+{
+	char arg[MAX_TOKEN_CHARS];
+
+	*msec = BENCH_DEFAULT_MSEC;
+	if (trap_Argc() > 1) {
+		trap_Argv(1, arg, sizeof(arg));
+		*msec = atoi(arg);
+	}
+	if (*msec < 1 || *msec > BENCH_MAX_MSEC) {
+		G_Printf("%s: msec must be between 1 and %d\n", name,
+			 BENCH_MAX_MSEC);
+		return qfalse;
+	}
+
+	return qtrue;
+}
+
+/*
+================
+G_LibBenchRun
+
+Call test's function on strings of length
+================
+*/
+static float G_LibBenchRun(int test, int length, int calls)
+{
+	char *source, *same, *dest;
+	int i, sum = 0;
+
+	for (i = 0; i < calls; i++) {
+		source = libBenchSource[i & 3] + LIBBENCH_BUFFER - length +
+		    (i & 3);
+		same = libBenchSame[i & 3] + LIBBENCH_BUFFER - length + (i & 3);
+		dest = libBenchDest + (i & 3);
+
+		switch (test) {
+		case LB_STRLEN:
+			sum += strlen(source);
+			break;
+		case LB_STRCPY:
+			sum += strcpy(dest, source)[length - 1];
+			break;
+		case LB_STRCMP:
+			sum += strcmp(source, same);
+			break;
+		case LB_STRCHR:
+			sum += (strchr(source, '!') != NULL);
+			break;
+		case LB_MEMMOVE:
+			sum += *(char *)memmove(dest, source, length);
+			break;
+		case LB_MEMMOVE_OVERLAP:
+			sum += *(char *)memmove(dest + 1, dest, length);
+			break;
+		case LB_MEMSET:
+			sum += *(char *)memset(dest, i, length);
+			break;
+		case LB_MEMCPY:
+			sum += *(char *)memcpy(dest, source, length);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return sum;
+}
+
+/*
+================
+Svcmd_LibBench_f
+
+libbench [msec]
+================
+*/
+void Svcmd_LibBench_f(void)
+{
+	static const int lengths[2] = { LIBBENCH_SHORT, LIBBENCH_LONG };
+	int msec, test, i, j;
+	float ns[2], sum = 0.0f;
+
+	if (!G_BenchMsec("libbench", &msec))
+		return;
+
+	// printable text with no '!' in it, ending length bytes after the
+	// start of the strings at each alignment
+	for (i = 0; i < 4; i++) {
+		for (j = 0; j < LIBBENCH_BUFFER + 4; j++)
+			libBenchSource[i][j] = libBenchSame[i][j] =
+			    'a' + j % 26;
+		libBenchSource[i][LIBBENCH_BUFFER + i] =
+		    libBenchSame[i][LIBBENCH_BUFFER + i] = '\0';
+	}
+
+	G_Printf("libbench: ns per call on %d and %d bytes\n", LIBBENCH_SHORT,
+		 LIBBENCH_LONG);
+
+	for (test = 0; test < LB_NUM_TESTS; test++) {
+		for (i = 0; i < 2; i++)
+			ns[i] = G_BenchTime(G_LibBenchRun, test, lengths[i],
+					    msec, &sum);
+
+		G_Printf("libbench: %-16s %9.1f %9.1f\n", libBenchNames[test],
+			 ns[0], ns[1]);
+	}
+
+	// printed so that the calls' results are used
+	G_Printf("libbench: checksum %g\n", sum);
+}
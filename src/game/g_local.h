@@ -230,6 +230,14 @@ struct gentity_s {
 	int lev1GrabTime;	// for turrets interacting with lev1s
 	int spawnBlockTime;
 
+	// G_SpawnPointBlocker's last answer for a spawn
+	qboolean spawnCheckValid;
+	int spawnCheckTime;
+	vec3_t spawnCheckOrigin;
+	vec3_t spawnCheckNormal;
+	int spawnBlocker;	// ENTITYNUM_NONE if it was clear
+	qboolean spawnCheckEmpty;	// and nothing else was near it
+
 	int credits[MAX_CLIENTS];	// human credits for each client
 	qboolean creditsHash[MAX_CLIENTS];	// track who has claimed credit
 	int killedBy;		// clientNum of killer
@@ -394,11 +402,13 @@ typedef struct {
 	qboolean predictItemPickup;	// based on cg_predictItems userinfo
 	qboolean pmoveFixed;	//
 	char netname[MAX_NETNAME];
+	char sanitisedName[MAX_NAME_LENGTH];	// G_SanitiseString'd netname
 	int maxHealth;		// for handicapping
 	int enterTime;		// level.time the client entered the game
 	playerTeamState_t teamState;	// status in teamplay games
 	int voteCount;		// to prevent people from constantly calling votes
 	qboolean teamInfo;	// send team overlay updates?
+	qboolean scoresMore;	// cgame understands "scoresmore"?
 
 	pClass_t classSelection;	// player class (copied to ent->client->ps.stats[ STAT_PCLASS ] once spawned)
 	float evolveHealthFraction;
@@ -434,6 +444,7 @@ typedef struct {
 	vec3_t lastDeathLocation;
 	char guid[33];
 	char ip[16];
+	unsigned int userinfoHash;	// of the userinfo ClientUserinfoChanged last saw
 	qboolean paused;
 	qboolean muted;
 	int muteExpires;	// level.time at which a player is unmuted
@@ -571,6 +582,9 @@ typedef struct spawnQueue_s {
 	int clients[MAX_CLIENTS];
 
 	int front, back;
+
+	clientList_t members;	// who is queued
+	int slot[MAX_CLIENTS];	// index into clients[] for each member
 } spawnQueue_t;
 
 #define QUEUE_PLUS1(x)  (((x)+1)%MAX_CLIENTS)
@@ -602,14 +616,12 @@ typedef struct damageRegion_s {
 #define MAX_ARMOUR_REGIONS 16
 
 // store locational armour regions
-typedef struct armourRegion_s {
-	float minHeight, maxHeight;
-	int minAngle, maxAngle;
-
-	float modifier;
+typedef damageRegion_t armourRegion_t;
 
-	qboolean crouch;
-} armourRegion_t;
+extern damageRegion_t g_damageRegions[PCL_NUM_CLASSES][MAX_LOCDAMAGE_REGIONS];
+extern int g_numDamageRegions[PCL_NUM_CLASSES];
+extern armourRegion_t g_armourRegions[UP_NUM_UPGRADES][MAX_ARMOUR_REGIONS];
+extern int g_numArmourRegions[UP_NUM_UPGRADES];
 
 //status of the warning of certain events
 typedef enum {
@@ -642,11 +654,43 @@ struct buildHistory_s {
 	buildHistory_t *marked;	// linked list of markdecon buildings taken
 };
 
+// one line of the JSON event log, see G_LogEventBegin
+typedef struct {
+	char text[MAX_STRING_CHARS];
+	int length;
+	qboolean overflowed;
+} logEvent_t;
+
+// the checks in G_CanBuild that depend on other buildables rather than on
+// traces, as last run for a client, see G_BuildCheck
+#define BUILDCHECK_MAX_REMOVALS 32
+
+typedef struct {
+	int generation;		// level.buildGeneration when this was run
+	buildable_t buildable;	// BA_NONE if there are no results
+	int team;
+	vec3_t origin;
+	int buildPoints;
+	int spawns;
+
+	qboolean noBuild;	// inside a no build marker
+	qboolean noCreep;
+	qboolean noOvermind;
+	qboolean unpowered;
+	qboolean noDCC;
+	int repeaterReason;	// IBE_RPTWARN is only a warning
+	int uniqueReason;
+	int bpReason;		// from G_SufficientBPAvailable
+	int numRemovals;	// and the buildables it would remove
+	int removals[BUILDCHECK_MAX_REMOVALS];
+} buildCheck_t;
+
 //
 // this structure is cleared as each map is entered
 //
 #define MAX_SPAWN_VARS      64
 #define MAX_SPAWN_VARS_CHARS  4096
+#define MAX_TEAM_SPAWNS       128
 
 typedef struct {
 	struct gclient_s *clients;	// [maxclients]
@@ -656,6 +700,7 @@ typedef struct {
 	int num_entities;	// current number, <= MAX_GENTITIES
 
 	fileHandle_t logFile;
+	fileHandle_t jsonLogFile;	// g_logFileJSON, see G_LogEventBegin
 
 	// store latched cvars here that we want to get at often
 	int maxclients;
@@ -730,6 +775,12 @@ typedef struct {
 	int numAlienSpawns;
 	int numHumanSpawns;
 
+	// spawn buildables in entity order, from G_CountSpawns
+	gentity_t *alienSpawnPoints[MAX_TEAM_SPAWNS];
+	int numAlienSpawnPoints;
+	gentity_t *humanSpawnPoints[MAX_TEAM_SPAWNS];
+	int numHumanSpawnPoints;
+
 	int numAlienClients;
 	int numHumanClients;
 
@@ -748,6 +799,17 @@ typedef struct {
 	gentity_t *markedBuildables[MAX_GENTITIES];
 	int numBuildablesForRemoval;
 
+	// entity numbers of each team's marked buildables, in removal order
+	int markedBuildableNums[BIT_NUM_TEAMS][MAX_GENTITIES];
+	int numMarkedBuildables[BIT_NUM_TEAMS];
+
+	// bumped whenever something G_BuildCheck depends on changes: a
+	// buildable or no build marker appearing, going or moving, a buildable
+	// dying, finishing building, gaining or losing power or being marked, a
+	// hovel being entered or left, or a cvar changing
+	int buildGeneration;
+	buildCheck_t buildChecks[MAX_CLIENTS];
+
 	int alienKills;
 	int humanKills;
 
@@ -842,6 +904,7 @@ char *G_NewString(const char *string);
 //
 // g_cmds.c
 //
+void G_InvalidateScoreboard(void);
 void Cmd_Score_f(gentity_t * ent);
 qboolean G_RoomForClassChange(gentity_t * ent, pClass_t class,
 			      vec3_t newOrigin);
@@ -882,6 +945,8 @@ void G_Physics(gentity_t * ent, int msec);
 
 #define MAX_ALIEN_BBOX  25
 
+#define SPAWN_CHECK_TIME 200	// msec a spawn is taken to stay blocked
+
 typedef enum {
 	IBE_NONE,
 
@@ -912,6 +977,7 @@ qboolean AHovel_Blocked(gentity_t * hovel, gentity_t * player,
 			qboolean provideExit);
 gentity_t *G_CheckSpawnPoint(int spawnNum, vec3_t origin, vec3_t normal,
 			     buildable_t spawn, vec3_t spawnOrigin);
+gentity_t *G_SpawnPointBlocker(gentity_t * spot);
 
 qboolean G_IsPowered(vec3_t origin);
 qboolean G_IsDCCBuilt(void);
@@ -936,6 +1002,7 @@ void G_LayoutLoad(void);
 void G_BaseSelfDestruct(pTeam_t team);
 gentity_t *G_InstantBuild(buildable_t buildable, vec3_t origin, vec3_t angles,
 			  vec3_t origin2, vec3_t angles2);
+void G_MarkBuildable(gentity_t * ent, qboolean mark);
 void G_SpawnRevertedBuildable(buildHistory_t * bh, qboolean mark);
 void G_CommitRevertedBuildable(gentity_t * ent);
 qboolean G_RevertCanFit(buildHistory_t * bh);
@@ -953,6 +1020,7 @@ int G_ShaderIndex(char *name);
 int G_ModelIndex(char *name);
 int G_SoundIndex(char *name);
 void G_TeamCommand(pTeam_t team, char *cmd);
+void G_ClientListCommand(clientList_t * list, const char *cmd);
 void G_KillBox(gentity_t * ent);
 gentity_t *G_Find(gentity_t * from, int fieldofs, const char *match);
 gentity_t *G_PickTarget(char *targetname);
@@ -1115,7 +1183,7 @@ void G_LogAutobahn(gentity_t * ent, const char *userinfo, int rating,
 //
 qboolean ConsoleCommand(void);
 void G_ProcessIPBans(void);
-qboolean G_FilterPacket(char *from);
+qboolean G_FilterPacket(const char *from);
 
 //
 // g_weapon.c
@@ -1140,6 +1208,14 @@ void G_RunThink(gentity_t * ent);
 void QDECL G_LogPrintf(const char *fmt, ...);
 void QDECL G_LogPrintfColoured(const char *fmt, ...);
 void QDECL G_LogOnlyPrintf(const char *fmt, ...);
+void G_LogOpen(const char *filename, fileHandle_t * f);
+void G_LogFlush(void);
+void G_CheckLogFlush(void);
+void G_LogClose(void);
+qboolean G_LogEventBegin(logEvent_t * ev, const char *type);
+void G_LogEventInt(logEvent_t * ev, const char *key, int value);
+void G_LogEventString(logEvent_t * ev, const char *key, const char *value);
+void G_LogEventEnd(logEvent_t * ev);
 void QDECL G_AdminsPrintf(const char *fmt, ...);
 void QDECL G_WarningsPrintf(char *flag, const char *fmt, ...);
 void QDECL G_LogOnlyPrintf(const char *fmt, ...);
@@ -1157,6 +1233,7 @@ qboolean G_Flood_Limited(gentity_t * ent);
 // g_client.c
 //
 const char *ClientConnect(int clientNum, qboolean firstTime);
+qboolean ClientUserinfoUnchanged(int clientNum);
 void ClientUserinfoChanged(int clientNum, qboolean forceName);
 void ClientDisconnect(int clientNum);
 void ClientBegin(int clientNum);
@@ -1186,6 +1263,111 @@ void G_LeaveTeam(gentity_t * self);
 void G_ChangeTeam(gentity_t * ent, pTeam_t newTeam, qboolean keepScores);
 void G_ShuffleTeams(void);
 
+//
+// g_cmdqueue.c
+//
+typedef enum {
+	SCT_PRINT,
+	SCT_CP,
+	SCT_CHAT,
+	SCT_SCORES,
+	SCT_TINFO,
+	SCT_OTHER,
+
+	SCT_NUM_TYPES
+} serverCommandType_t;
+
+void G_FlushServerCommands(int clientNum);
+void G_ResetServerCommands(int clientNum);
+void Svcmd_CommandStats_f(void);
+
+//
+// g_cmdrecord.c
+//
+void G_CmdRecordStart(int levelTime, int randomSeed, int restart);
+void G_CmdRecordStop(void);
+void G_CmdRecordFrame(int levelTime);
+void G_CmdRecordClient(cmdRecordType_t type, int clientNum, int firstTime);
+void G_CmdRecordCommand(int clientNum);
+void G_CmdRecordThink(int clientNum, const usercmd_t * cmd);
+
+//
+// g_damagegrid.c
+//
+float G_LocDamageModifier(const damageRegion_t * regions, int numRegions,
+			  float modifier, float hitRatio, int hitRotation,
+			  int ducked);
+void G_BakeDamageGrids(void);
+float G_ClassDamageModifier(int class, float hitRatio, int hitRotation,
+			    int ducked);
+float G_ArmourDamageModifier(int upgrade, float modifier, float hitRatio,
+			     int hitRotation, int ducked);
+float G_ArmourAverageModifier(int upgrade);
+qboolean G_DamageRegionsAngular(int class, int stats[]);
+void Svcmd_DamageGrid_f(void);
+
+//
+// g_nameindex.c
+//
+#define NAMEINDEX_BUCKETS 16384	// power of two
+#define NAMEINDEX_MAX_TRIGRAMS (MAX_NAME_LENGTH - 3)	// in one name
+#define NAMEINDEX_MAX_UNINDEXED 64
+
+typedef struct {
+	int id;
+	int next;		// 1-based, 0 ends the chain
+} nameIndexNode_t;
+
+// nodes and maxNodes come first so that an index can be initialised with
+// its own pool, which must have room for every name it will hold at once
+typedef struct {
+	nameIndexNode_t *nodes;
+	int maxNodes;
+	int nodesUsed;
+	int freeNodes;		// 1-based free list
+
+	int buckets[NAMEINDEX_BUCKETS];	// first node, 0 if empty
+	int bucketSize[NAMEINDEX_BUCKETS];
+	int numIds;		// one more than the highest id ever added
+
+	// ids with a name that didn't fit in the pool, which every search
+	// checks until they are removed
+	int unindexed[NAMEINDEX_MAX_UNINDEXED];
+	int numUnindexed;
+	qboolean overflowed;	// too many of those, searches check every id
+} nameIndex_t;
+
+// rank of id's name(s) against search as G_NameMatchRank, 0 if none match
+typedef int (*nameIndexMatch_t) (int id, const char *search);
+
+void G_NameIndexAdd(nameIndex_t * index, int id, const char *name);
+void G_NameIndexRemove(nameIndex_t * index, int id, const char *name);
+void G_NameIndexClear(nameIndex_t * index);
+int G_NameMatchRank(const char *name, const char *search);
+int G_NameIndexSearch(nameIndex_t * index, const char *search,
+		      nameIndexMatch_t match, int *ids, int maxIds);
+
+//
+// g_parsebench.c
+//
+void Svcmd_ParseBench_f(void);
+
+//
+// g_libbench.c
+//
+// call test calls times with param, returning a sum of the results so that
+// none of the calls can be left out
+typedef float (*benchRun_t) (int test, int param, int calls);
+
+qboolean G_BenchMsec(const char *name, int *msec);
+float G_BenchTime(benchRun_t run, int test, int param, int msec, float *sum);
+void Svcmd_LibBench_f(void);
+
+//
+// g_mathbench.c
+//
+void Svcmd_MathBench_f(void);
+
 //
 // g_mem.c
 //
@@ -1431,6 +1613,7 @@ extern vmCvar_t g_layoutAuto;
 
 extern vmCvar_t g_admin;
 extern vmCvar_t g_adminLog;
+extern vmCvar_t g_adminNamelogFile;
 extern vmCvar_t g_adminParseSay;
 extern vmCvar_t g_adminSayFilter;
 extern vmCvar_t g_adminNameProtect;
@@ -1454,6 +1637,9 @@ extern vmCvar_t g_killerHP;
 extern vmCvar_t g_privateMessages;
 extern vmCvar_t g_fullIgnore;
 extern vmCvar_t g_decolourLogfiles;
+extern vmCvar_t g_logFileSync;
+extern vmCvar_t g_logFlushTime;
+extern vmCvar_t g_logFileJSON;
 extern vmCvar_t g_publicSayadmins;
 extern vmCvar_t g_myStats;
 extern vmCvar_t g_teamStatus;
@@ -1503,10 +1689,14 @@ extern vmCvar_t g_bleedingSpree;
 extern vmCvar_t g_schachtmeisterClearThreshold;
 extern vmCvar_t g_schachtmeisterAutobahnThreshold;
 extern vmCvar_t g_schachtmeisterAutobahnMessage;
+extern vmCvar_t g_schachtmeisterBatch;
+extern vmCvar_t g_schachtmeisterResponder;
 extern vmCvar_t g_adminAutobahnNotify;
 extern vmCvar_t g_maxGhosts;
 extern vmCvar_t g_specNoclip;
 extern vmCvar_t g_practise;
+extern vmCvar_t g_cmdRecord;
+extern vmCvar_t g_damageGrid;
 extern vmCvar_t g_tyrantNerf;
 extern vmCvar_t g_disablePollVotes;
 
@@ -1543,7 +1733,10 @@ void trap_LocateGameData(gentity_t * gEnts, int numGEntities,
 			 int sizeofGEntity_t, playerState_t * gameClients,
 			 int sizeofGameClient);
 void trap_DropClient(int clientNum, const char *reason);
+// queued and coalesced per client by g_cmdqueue.c, which passes them on to
+// the engine with trap_SendServerCommandNow
 void trap_SendServerCommand(int clientNum, const char *text);
+void trap_SendServerCommandNow(int clientNum, const char *text);
 void trap_SetConfigstring(int num, const char *string);
 void trap_GetConfigstring(int num, char *buffer, int bufferSize);
 void trap_GetUserinfo(int num, char *buffer, int bufferSize);
@@ -78,6 +78,8 @@ vmCvar_t g_restarted;
 vmCvar_t g_lockTeamsAtStart;
 vmCvar_t g_logFile;
 vmCvar_t g_logFileSync;
+vmCvar_t g_logFlushTime;
+vmCvar_t g_logFileJSON;
 vmCvar_t g_blood;
 vmCvar_t g_podiumDist;
 vmCvar_t g_podiumDrop;
@@ -171,6 +173,7 @@ vmCvar_t g_layoutAuto;
 
 vmCvar_t g_admin;
 vmCvar_t g_adminLog;
+vmCvar_t g_adminNamelogFile;
 vmCvar_t g_adminParseSay;
 vmCvar_t g_adminSayFilter;
 vmCvar_t g_adminNameProtect;
@@ -247,10 +250,14 @@ vmCvar_t g_bleedingSpree;
 vmCvar_t g_schachtmeisterClearThreshold;
 vmCvar_t g_schachtmeisterAutobahnThreshold;
 vmCvar_t g_schachtmeisterAutobahnMessage;
+vmCvar_t g_schachtmeisterBatch;
+vmCvar_t g_schachtmeisterResponder;
 vmCvar_t g_adminAutobahnNotify;
 vmCvar_t g_maxGhosts;
 vmCvar_t g_specNoclip;
 vmCvar_t g_practise;
+vmCvar_t g_cmdRecord;
+vmCvar_t g_damageGrid;
 vmCvar_t g_tyrantNerf;
 
 vmCvar_t g_debugRewards;
@@ -324,6 +331,8 @@ static cvarTable_t gameCvarTable[] = {
 	{ &g_doWarmup, "g_doWarmup", "1", CVAR_ARCHIVE, 0, qtrue },
 	{ &g_logFile, "g_logFile", "games.log", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_logFileSync, "g_logFileSync", "0", CVAR_ARCHIVE, 0, qfalse },
+	{ &g_logFlushTime, "g_logFlushTime", "1000", CVAR_ARCHIVE, 0, qfalse },
+	{ &g_logFileJSON, "g_logFileJSON", "", CVAR_ARCHIVE, 0, qfalse },
 
 	{ &g_password, "g_password", "", CVAR_USERINFO, 0, qfalse },
 
@@ -476,6 +485,8 @@ static cvarTable_t gameCvarTable[] = {
 
 	{ &g_admin, "g_admin", "admin.dat", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_adminLog, "g_adminLog", "admin.log", CVAR_ARCHIVE, 0, qfalse },
+	{ &g_adminNamelogFile, "g_adminNamelogFile", "", CVAR_ARCHIVE, 0,
+	 qfalse },
 	{ &g_adminParseSay, "g_adminParseSay", "1", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_adminSayFilter, "g_adminSayFilter", "0", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_adminNameProtect, "g_adminNameProtect", "1", CVAR_ARCHIVE, 0,
@@ -564,11 +575,17 @@ static cvarTable_t gameCvarTable[] = {
 	 "g_schachtmeisterAutobahnThreshold", "-30", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_schachtmeisterAutobahnMessage, "g_schachtmeisterAutobahnMessage",
 	 "Your host is blacklisted.", CVAR_ARCHIVE, 0, qfalse },
+	{ &g_schachtmeisterBatch, "g_schachtmeisterBatch", "1", CVAR_ARCHIVE, 0,
+	 qfalse },
+	{ &g_schachtmeisterResponder, "g_schachtmeisterResponder", "",
+	 CVAR_ARCHIVE, 0, qfalse },
 	{ &g_adminAutobahnNotify, "g_adminAutobahnNotify", "1", CVAR_ARCHIVE, 0,
 	 qfalse },
 	{ &g_maxGhosts, "g_maxGhosts", "0", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_specNoclip, "g_specNoclip", "0", CVAR_ARCHIVE, 0, qtrue },
 	{ &g_practise, "g_practise", "0", CVAR_ARCHIVE, 0, qfalse },
+	{ &g_cmdRecord, "g_cmdRecord", "0", CVAR_ARCHIVE, 0, qfalse },
+	{ &g_damageGrid, "g_damageGrid", "1", CVAR_ARCHIVE, 0, qfalse },
 	{ &g_tyrantNerf, "g_tyrantNerf", "0", CVAR_ARCHIVE, 0, qfalse },
 
 	{ &g_debugRewards, "g_debugRewards", "0", CVAR_ARCHIVE, 0, qfalse },
@@ -616,6 +633,7 @@ Q_EXPORT intptr_t vmMain(int command, int arg0, int arg1, int arg2, int arg3,
 		return 0;
 
 	case GAME_CLIENT_CONNECT:
+		G_CmdRecordClient(CR_CONNECT, arg0, arg1);
 		return (intptr_t) ClientConnect(arg0, arg1);
 
 	case GAME_CLIENT_THINK:
@@ -623,26 +641,33 @@ Q_EXPORT intptr_t vmMain(int command, int arg0, int arg1, int arg2, int arg3,
 		return 0;
 
 	case GAME_CLIENT_USERINFO_CHANGED:
-		ClientUserinfoChanged(arg0, qfalse);
+		G_CmdRecordClient(CR_USERINFO, arg0, 0);
+		if (!ClientUserinfoUnchanged(arg0))
+			ClientUserinfoChanged(arg0, qfalse);
 		return 0;
 
 	case GAME_CLIENT_DISCONNECT:
+		G_CmdRecordClient(CR_DISCONNECT, arg0, 0);
 		ClientDisconnect(arg0);
 		return 0;
 
 	case GAME_CLIENT_BEGIN:
+		G_CmdRecordClient(CR_BEGIN, arg0, 0);
 		ClientBegin(arg0);
 		return 0;
 
 	case GAME_CLIENT_COMMAND:
+		G_CmdRecordCommand(arg0);
 		ClientCommand(arg0);
 		return 0;
 
 	case GAME_RUN_FRAME:
+		G_CmdRecordFrame(arg0);
 		G_RunFrame(arg0);
 		return 0;
 
 	case GAME_CONSOLE_COMMAND:
+		G_CmdRecordCommand(-1);
 		return ConsoleCommand();
 	}
 
@@ -670,6 +695,9 @@ void QDECL G_Error(const char *fmt, ...)
 	vsprintf(text, fmt, argptr);
 	va_end(argptr);
 
+	// don't lose whatever is still sitting in the log buffers
+	G_LogFlush();
+
 	trap_Error(text);
 }
 
@@ -786,6 +814,9 @@ void G_UpdateCvars(void)
 				cv->modificationCount =
 				    cv->vmCvar->modificationCount;
 
+				// G_BuildCheck doesn't know which ones it uses
+				level.buildGeneration++;
+
 				if (cv->trackChange) {
 					trap_SendServerCommand(-1,
 							       va
@@ -872,12 +903,7 @@ void G_InitGame(int levelTime, int randomSeed, int restart)
 		      ")");
 
 	if (g_logFile.string[0]) {
-		if (g_logFileSync.integer)
-			trap_FS_FOpenFile(g_logFile.string, &level.logFile,
-					  FS_APPEND_SYNC);
-		else
-			trap_FS_FOpenFile(g_logFile.string, &level.logFile,
-					  FS_APPEND);
+		G_LogOpen(g_logFile.string, &level.logFile);
 
 		if (!level.logFile)
 			G_Printf("WARNING: Couldn't open logfile: %s\n",
@@ -902,6 +928,27 @@ void G_InitGame(int levelTime, int randomSeed, int restart)
 	} else
 		G_Printf("Not logging to disk\n");
 
+	G_LogOpen(g_logFileJSON.string, &level.jsonLogFile);
+	G_CmdRecordStart(levelTime, randomSeed, restart);
+	{
+		logEvent_t ev;
+		char map[MAX_QPATH];
+		qtime_t qt;
+
+		if (G_LogEventBegin(&ev, "init")) {
+			trap_Cvar_VariableStringBuffer("mapname", map,
+						       sizeof(map));
+			trap_RealTime(&qt);
+			G_LogEventString(&ev, "map", map);
+			G_LogEventString(&ev, "realtime",
+					 va("%04i-%02i-%02iT%02i:%02i:%02i",
+					    qt.tm_year + 1900, qt.tm_mon + 1,
+					    qt.tm_mday, qt.tm_hour,
+					    qt.tm_min, qt.tm_sec));
+			G_LogEventEnd(&ev);
+		}
+	}
+
 	{
 		char map[MAX_CVAR_VALUE_STRING] = { "" };
 
@@ -915,6 +962,8 @@ void G_InitGame(int levelTime, int randomSeed, int restart)
 	if (g_admin.string[0]) {
 		G_admin_readconfig(NULL, 0);
 	}
+	G_admin_namelog_readfile();
+
 	// initialize all entities for this game
 	memset(g_entities, 0, MAX_GENTITIES * sizeof(g_entities[0]));
 	level.gentities = g_entities;
@@ -1033,12 +1082,21 @@ void G_ShutdownGame(int restart)
 
 	G_Printf("==== ShutdownGame ====\n");
 
+	G_FlushServerCommands(-1);
+
 	if (level.logFile) {
 		G_LogPrintf("ShutdownGame:\n");
 		G_LogPrintf
 		    ("------------------------------------------------------------\n");
-		trap_FS_FCloseFile(level.logFile);
 	}
+	if (level.jsonLogFile) {
+		logEvent_t ev;
+
+		if (G_LogEventBegin(&ev, "shutdown"))
+			G_LogEventEnd(&ev);
+	}
+	G_LogClose();
+	G_CmdRecordStop();
 	// write admin.dat for !seen data
 	admin_writeconfig();
 
@@ -1092,22 +1150,27 @@ PLAYER COUNTING / SCORE SORTING
 =============
 SortRanks
 
+Sort level.sortedClients by score, highest first.  Clients with the same
+score stay in the order they were in.
 =============
 */
-int QDECL SortRanks(const void *a, const void *b)
+static void SortRanks(void)
 {
-	gclient_t *ca, *cb;
+	sortItem_t items[MAX_CLIENTS], temp[MAX_CLIENTS];
+	int i, clientNum;
 
-	ca = &level.clients[*(int *)a];
-	cb = &level.clients[*(int *)b];
+	for (i = 0; i < level.numConnectedClients; i++) {
+		clientNum = level.sortedClients[i];
 
-	// then sort by score
-	if (ca->pers.score > cb->pers.score)
-		return -1;
-	else if (ca->pers.score < cb->pers.score)
-		return 1;
-	else
-		return 0;
+		// ~ reverses the order without overflowing
+		items[i].key = ~level.clients[clientNum].pers.score;
+		items[i].value = clientNum;
+	}
+
+	Q_SortItems(items, temp, level.numConnectedClients);
+
+	for (i = 0; i < level.numConnectedClients; i++)
+		level.sortedClients[i] = items[i].value;
 }
 
 /*
@@ -1125,8 +1188,12 @@ void G_InitSpawnQueue(spawnQueue_t * sq)
 	sq->back = QUEUE_MINUS1(sq->back);
 
 	//0 is a valid clientNum, so use something else
-	for (i = 0; i < MAX_CLIENTS; i++)
+	for (i = 0; i < MAX_CLIENTS; i++) {
 		sq->clients[i] = -1;
+		sq->slot[i] = -1;
+	}
+
+	memset(&sq->members, 0, sizeof(sq->members));
 }
 
 /*
@@ -1163,6 +1230,8 @@ int G_PopSpawnQueue(spawnQueue_t * sq)
 	if (G_GetSpawnQueueLength(sq) > 0) {
 		sq->clients[sq->front] = -1;
 		sq->front = QUEUE_PLUS1(sq->front);
+		sq->slot[clientNum] = -1;
+		BG_ClientListRemove(&sq->members, clientNum);
 		g_entities[clientNum].client->ps.pm_flags &= ~PMF_QUEUED;
 
 		return clientNum;
@@ -1191,12 +1260,10 @@ Look to see if clientNum is already in the spawnQueue
 */
 qboolean G_SearchSpawnQueue(spawnQueue_t * sq, int clientNum)
 {
-	int i;
+	if (clientNum < 0 || clientNum >= MAX_CLIENTS)
+		return qfalse;
 
-	for (i = 0; i < MAX_CLIENTS; i++)
-		if (sq->clients[i] == clientNum)
-			return qtrue;
-	return qfalse;
+	return BG_ClientListTest(&sq->members, clientNum);
 }
 
 /*
@@ -1214,6 +1281,8 @@ qboolean G_PushSpawnQueue(spawnQueue_t * sq, int clientNum)
 
 	sq->back = QUEUE_PLUS1(sq->back);
 	sq->clients[sq->back] = clientNum;
+	sq->slot[clientNum] = sq->back;
+	BG_ClientListAdd(&sq->members, clientNum);
 
 	g_entities[clientNum].client->ps.pm_flags |= PMF_QUEUED;
 	return qtrue;
@@ -1228,33 +1297,24 @@ remove a specific client from a spawn queue
 */
 qboolean G_RemoveFromSpawnQueue(spawnQueue_t * sq, int clientNum)
 {
-	int i = sq->front;
+	int i;
 
-	if (G_GetSpawnQueueLength(sq)) {
-		do {
-			if (sq->clients[i] == clientNum) {
-				//and this kids is why it would have
-				//been better to use an LL for internal
-				//representation
-				do {
-					sq->clients[i] =
-					    sq->clients[QUEUE_PLUS1(i)];
-
-					i = QUEUE_PLUS1(i);
-				} while (i != QUEUE_PLUS1(sq->back));
-
-				sq->back = QUEUE_MINUS1(sq->back);
-				g_entities[clientNum].client->ps.pm_flags &=
-				    ~PMF_QUEUED;
-
-				return qtrue;
-			}
+	if (!G_SearchSpawnQueue(sq, clientNum))
+		return qfalse;
 
-			i = QUEUE_PLUS1(i);
-		} while (i != QUEUE_PLUS1(sq->back));
+	// close the gap by moving up everyone queued behind clientNum
+	for (i = sq->slot[clientNum]; i != sq->back; i = QUEUE_PLUS1(i)) {
+		sq->clients[i] = sq->clients[QUEUE_PLUS1(i)];
+		sq->slot[sq->clients[i]] = i;
 	}
 
-	return qfalse;
+	sq->clients[sq->back] = -1;
+	sq->back = QUEUE_MINUS1(sq->back);
+	sq->slot[clientNum] = -1;
+	BG_ClientListRemove(&sq->members, clientNum);
+	g_entities[clientNum].client->ps.pm_flags &= ~PMF_QUEUED;
+
+	return qtrue;
 }
 
 /*
@@ -1266,22 +1326,13 @@ Get the position of a client in a spawn queue
 */
 int G_GetPosInSpawnQueue(spawnQueue_t * sq, int clientNum)
 {
-	int i = sq->front;
-
-	if (G_GetSpawnQueueLength(sq)) {
-		do {
-			if (sq->clients[i] == clientNum) {
-				if (i < sq->front)
-					return i + MAX_CLIENTS - sq->front;
-				else
-					return i - sq->front;
-			}
-
-			i = QUEUE_PLUS1(i);
-		} while (i != QUEUE_PLUS1(sq->back));
-	}
+	if (!G_SearchSpawnQueue(sq, clientNum))
+		return -1;
 
-	return -1;
+	if (sq->slot[clientNum] < sq->front)
+		return sq->slot[clientNum] + MAX_CLIENTS - sq->front;
+	else
+		return sq->slot[clientNum] - sq->front;
 }
 
 /*
@@ -1376,6 +1427,8 @@ void G_CountSpawns(void)
 
 	level.numAlienSpawns = 0;
 	level.numHumanSpawns = 0;
+	level.numAlienSpawnPoints = 0;
+	level.numHumanSpawnPoints = 0;
 
 	for (i = 1, ent = g_entities + i; i < level.num_entities; i++, ent++) {
 		if (!ent->inuse)
@@ -1386,6 +1439,19 @@ void G_CountSpawns(void)
 
 		if (ent->s.modelindex == BA_H_SPAWN && ent->health > 0)
 			level.numHumanSpawns++;
+
+		if (ent->s.eType != ET_BUILDABLE)
+			continue;
+
+		if (ent->s.modelindex == BA_A_SPAWN &&
+		    level.numAlienSpawnPoints < MAX_TEAM_SPAWNS)
+			level.alienSpawnPoints[level.numAlienSpawnPoints++] =
+			    ent;
+
+		if (ent->s.modelindex == BA_H_SPAWN &&
+		    level.numHumanSpawnPoints < MAX_TEAM_SPAWNS)
+			level.humanSpawnPoints[level.numHumanSpawnPoints++] =
+			    ent;
 	}
 
 	//let the client know how many spawns there are
@@ -1757,6 +1823,8 @@ void CalculateRanks(void)
 	char P[MAX_CLIENTS + 1] = { "" };
 	int ff = 0;
 
+	G_InvalidateScoreboard();
+
 	level.numConnectedClients = 0;
 	level.numNonSpectatorClients = 0;
 	level.numPlayingClients = 0;
@@ -1814,8 +1882,7 @@ void CalculateRanks(void)
 		ff |= FFF_BUILDABLES;
 	trap_Cvar_Set("ff", va("%i", ff));
 
-	qsort(level.sortedClients, level.numConnectedClients,
-	      sizeof(level.sortedClients[0]), SortRanks);
+	SortRanks();
 
 	// see if it is time to end the level
 	CheckExitRules();
@@ -2072,22 +2139,23 @@ void QDECL G_AdminsPrintf(const char *fmt, ...)
 	char string[1024];
 	gentity_t *tempent;
 	int j;
+	clientList_t admins;
 
 	va_start(argptr, fmt);
 	vsprintf(string, fmt, argptr);
 	va_end(argptr);
 
+	memset(&admins, 0, sizeof(admins));
 	for (j = 0; j < level.maxclients; j++) {
 		tempent = &g_entities[j];
 		if (G_admin_permission(tempent, ADMF_ADMINCHAT) &&
-		    !tempent->client->pers.ignoreAdminWarnings) {
-			trap_SendServerCommand(tempent - g_entities,
-					       va
-					       ("print \"^7[^fADMIN ALERT^7] %s\"",
-						string));
-		}
+		    !tempent->client->pers.ignoreAdminWarnings)
+			BG_ClientListAdd(&admins, j);
 	}
 
+	G_ClientListCommand(&admins,
+			    va("print \"^7[^fADMIN ALERT^7] %s\"", string));
+
 	G_LogPrintf("%s", string);
 
 }
@@ -2106,25 +2174,250 @@ void QDECL G_WarningsPrintf(char *flag, const char *fmt, ...)
 	char string[1024];
 	gentity_t *tempent;
 	int j;
+	clientList_t recipients;
 
 	va_start(argptr, fmt);
 	vsprintf(string, fmt, argptr);
 	va_end(argptr);
 
+	memset(&recipients, 0, sizeof(recipients));
 	for (j = 0; j < level.maxclients; j++) {
 		tempent = &g_entities[j];
-		if (G_admin_permission(tempent, flag)) {
-			trap_SendServerCommand(tempent - g_entities,
-					       va
-					       ("print \"^7[^DWARNINGS^7: ^d%s^7] %s\"",
-						flag, string));
-		}
+		if (G_admin_permission(tempent, flag))
+			BG_ClientListAdd(&recipients, j);
 	}
 
+	G_ClientListCommand(&recipients,
+			    va("print \"^7[^DWARNINGS^7: ^d%s^7] %s\"", flag,
+			       string));
+
 	G_LogPrintf("%s", string);
 
 }
 
+/*
+=================
+Log buffering
+
+Log lines are collected in a per-file buffer and written out in one go when
+the buffer fills, every g_logFlushTime msec and on shutdown.  g_logFileSync
+or a g_logFlushTime of 0 makes every line go straight to disk as before.
+=================
+*/
+#define LOG_BUFFER_SIZE 16384
+#define LOG_EVENT_TAIL  24
+
+typedef struct {
+	int length;
+	int flushTime;
+	char data[LOG_BUFFER_SIZE];
+} logBuffer_t;
+
+static logBuffer_t gameLog;
+static logBuffer_t jsonLog;
+
+static void G_LogBufferFlush(logBuffer_t * buffer, fileHandle_t f)
+{
+	if (buffer->length > 0 && f)
+		trap_FS_Write(buffer->data, buffer->length, f);
+
+	buffer->length = 0;
+	buffer->flushTime = level.time;
+}
+
+static void G_LogWrite(logBuffer_t * buffer, fileHandle_t f,
+		       const char *text)
+{
+	int len = strlen(text);
+
+	if (!f)
+		return;
+
+	if (g_logFileSync.integer || g_logFlushTime.integer <= 0) {
+		// keep the file in order if buffering was just switched off
+		G_LogBufferFlush(buffer, f);
+		trap_FS_Write(text, len, f);
+		return;
+	}
+
+	if (buffer->length + len > LOG_BUFFER_SIZE) {
+		G_LogBufferFlush(buffer, f);
+
+		if (len > LOG_BUFFER_SIZE) {
+			trap_FS_Write(text, len, f);
+			return;
+		}
+	}
+
+	memcpy(buffer->data + buffer->length, text, len);
+	buffer->length += len;
+}
+
+/*
+=================
+G_LogOpen
+
+Open a log file for appending, honouring g_logFileSync
+=================
+*/
+void G_LogOpen(const char *filename, fileHandle_t * f)
+{
+	*f = 0;
+
+	if (!filename[0])
+		return;
+
+	if (g_logFileSync.integer)
+		trap_FS_FOpenFile(filename, f, FS_APPEND_SYNC);
+	else
+		trap_FS_FOpenFile(filename, f, FS_APPEND);
+}
+
+/*
+=================
+G_LogFlush
+
+Write out everything buffered so far
+=================
+*/
+void G_LogFlush(void)
+{
+	G_LogBufferFlush(&gameLog, level.logFile);
+	G_LogBufferFlush(&jsonLog, level.jsonLogFile);
+}
+
+/*
+=================
+G_CheckLogFlush
+
+Called every frame, flushes the log buffers once g_logFlushTime has passed
+=================
+*/
+void G_CheckLogFlush(void)
+{
+	if (level.time - gameLog.flushTime >= g_logFlushTime.integer ||
+	    level.time < gameLog.flushTime)
+		G_LogBufferFlush(&gameLog, level.logFile);
+
+	if (level.time - jsonLog.flushTime >= g_logFlushTime.integer ||
+	    level.time < jsonLog.flushTime)
+		G_LogBufferFlush(&jsonLog, level.jsonLogFile);
+}
+
+/*
+=================
+G_LogClose
+
+Flush and close all log files
+=================
+*/
+void G_LogClose(void)
+{
+	G_LogFlush();
+
+	if (level.logFile)
+		trap_FS_FCloseFile(level.logFile);
+	if (level.jsonLogFile)
+		trap_FS_FCloseFile(level.jsonLogFile);
+
+	level.logFile = level.jsonLogFile = 0;
+}
+
+/*
+=================
+G_LogEvent*
+
+Build one line of the machine readable g_logFileJSON log, e.g.
+
+	logEvent_t ev;
+
+	if (G_LogEventBegin(&ev, "kill")) {
+		G_LogEventInt(&ev, "killer", killer);
+		G_LogEventString(&ev, "killerName", killerName);
+		G_LogEventEnd(&ev);
+	}
+
+G_LogEventBegin returns qfalse when JSON logging is off so callers don't
+bother building the event.  Strings are decoloured and escaped.
+=================
+*/
+static void G_LogEventAppend(logEvent_t * ev, const char *text)
+{
+	int len = strlen(text);
+
+	// leave room for G_LogEventEnd to close the line
+	if (ev->length + len >= sizeof(ev->text) - LOG_EVENT_TAIL) {
+		ev->overflowed = qtrue;
+		return;
+	}
+
+	memcpy(ev->text + ev->length, text, len + 1);
+	ev->length += len;
+}
+
+qboolean G_LogEventBegin(logEvent_t * ev, const char *type)
+{
+	if (!level.jsonLogFile)
+		return qfalse;
+
+	ev->length = 0;
+	ev->overflowed = qfalse;
+	ev->text[0] = '\0';
+
+	G_LogEventAppend(ev, va("{\"time\":%d,\"event\":\"%s\"",
+				level.time - level.startTime, type));
+	return qtrue;
+}
+
+void G_LogEventInt(logEvent_t * ev, const char *key, int value)
+{
+	G_LogEventAppend(ev, va(",\"%s\":%d", key, value));
+}
+
+void G_LogEventString(logEvent_t * ev, const char *key, const char *value)
+{
+	char decoloured[MAX_STRING_CHARS];
+	char escaped[MAX_STRING_CHARS];
+	char *in;
+	int len = 0;
+
+	Q_strncpyz(decoloured, value, sizeof(decoloured));
+	G_DecolorString(decoloured, decoloured);
+
+	for (in = decoloured; *in && len < sizeof(escaped) - 7; in++) {
+		unsigned char c = *in;
+
+		if (c == '"' || c == '\\') {
+			escaped[len++] = '\\';
+			escaped[len++] = c;
+		} else if (c < ' ' || c >= 0x7f) {
+			// treat anything outside ASCII as latin-1 so the
+			// output is always valid UTF-8
+			Com_sprintf(escaped + len, sizeof(escaped) - len,
+				    "\\u%04x", c);
+			len += 6;
+		} else
+			escaped[len++] = c;
+	}
+	escaped[len] = '\0';
+
+	G_LogEventAppend(ev, va(",\"%s\":\"", key));
+	G_LogEventAppend(ev, escaped);
+	G_LogEventAppend(ev, "\"");
+}
+
+void G_LogEventEnd(logEvent_t * ev)
+{
+	if (!level.jsonLogFile)
+		return;
+
+	// G_LogEventAppend always leaves space for this
+	Q_strncpyz(ev->text + ev->length,
+		   ev->overflowed ? ",\"truncated\":true}\n" : "}\n",
+		   sizeof(ev->text) - ev->length);
+	G_LogWrite(&jsonLog, level.jsonLogFile, ev->text);
+}
+
 /*
 =================
 G_LogPrintf
@@ -2159,9 +2452,9 @@ void QDECL G_LogPrintf(const char *fmt, ...)
 
 	if (g_decolourLogfiles.integer) {
 		G_DecolorString(string, decoloured);
-		trap_FS_Write(decoloured, strlen(decoloured), level.logFile);
+		G_LogWrite(&gameLog, level.logFile, decoloured);
 	} else {
-		trap_FS_Write(string, strlen(string), level.logFile);
+		G_LogWrite(&gameLog, level.logFile, string);
 	}
 }
 
@@ -2197,7 +2490,7 @@ void QDECL G_LogPrintfColoured(const char *fmt, ...)
 	if (!level.logFile)
 		return;
 
-	trap_FS_Write(string, strlen(string), level.logFile);
+	G_LogWrite(&gameLog, level.logFile, string);
 }
 
 /*
@@ -2231,9 +2524,9 @@ void QDECL G_LogOnlyPrintf(const char *fmt, ...)
 
 	if (g_decolourLogfiles.integer) {
 		G_DecolorString(string, decoloured);
-		trap_FS_Write(decoloured, strlen(decoloured), level.logFile);
+		G_LogWrite(&gameLog, level.logFile, decoloured);
 	} else {
-		trap_FS_Write(string, strlen(string), level.logFile);
+		G_LogWrite(&gameLog, level.logFile, string);
 	}
 }
 
@@ -2973,7 +3266,7 @@ void CheckCvars(void)
 			if (ent->s.eType != ET_BUILDABLE)
 				continue;
 
-			ent->deconstruct = qfalse;
+			G_MarkBuildable(ent, qfalse);
 		}
 	}
 
@@ -3183,6 +3476,11 @@ void G_RunFrame(int levelTime)
 	// for tracking changes
 	CheckCvars();
 
+	G_CheckLogFlush();
+
+	// anything queued after ClientEndFrame
+	G_FlushServerCommands(-1);
+
 	if (g_listEntity.integer) {
 		for (i = 0; i < MAX_GENTITIES; i++)
 			G_Printf("%4i: %s\n", i, g_entities[i].classname);
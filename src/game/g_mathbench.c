@@ -0,0 +1,218 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+
+// g_mathbench.c -- timing and accuracy for the math functions
+//
+// mathbench times the math functions and the vector helpers built on them.
+// sqrt, sin, cos and atan2 are engine calls in a QVM, while acos, tan and
+// pow are worked out in bg_lib.c, so it also reports how far those drift
+// from the same result built out of the engine's functions.  game.so uses
+// the system's for everything, which gives the figures to compare against.
+
+#include "g_local.h"
+
+#define MATHBENCH_INPUTS       1024
+#define MATHBENCH_SWEEP        100000
+
+typedef enum {
+	MB_SQRT,
+	MB_SIN,
+	MB_COS,
+	MB_ATAN2,
+	MB_ACOS,
+	MB_TAN,
+	MB_POW,
+	MB_ANGLEVECTORS_FORWARD,
+	MB_ANGLEVECTORS,
+	MB_VECTOANGLES,
+	MB_VECTOANGLES_FLAT,
+	MB_VECTORNORMALIZE,
+
+	MB_NUM_TESTS
+} mathBenchTest_t;
+
+static const char *mathBenchNames[MB_NUM_TESTS] = {
+	"sqrt",
+	"sin",
+	"cos",
+	"atan2",
+	"acos",
+	"tan",
+	"pow",
+	"AngleVectors fwd",
+	"AngleVectors",
+	"vectoangles",
+	"vectoangles flat",
+	"VectorNormalize"
+};
+
+// values in [-1, 1], and view angles with no roll
+static float mathBenchValues[MATHBENCH_INPUTS];
+static vec3_t mathBenchAngles[MATHBENCH_INPUTS];
+static vec3_t mathBenchVectors[MATHBENCH_INPUTS];
+
+/*
+================
+G_MathBenchRun
+
+Call test's function on a cycle of inputs, for G_BenchTime
+================
+*/
+static float G_MathBenchRun(int test, int unused, int calls)
+{
+	vec3_t forward, right, up, v;
+	float x, sum = 0.0f;
+	int i, j;
+
+	for (i = 0; i < calls; i++) {
+		j = i & (MATHBENCH_INPUTS - 1);
+		x = mathBenchValues[j];
+
+		switch (test) {
+		case MB_SQRT:
+			sum += sqrt(x + 1.0f);
+			break;
+		case MB_SIN:
+			sum += sin(x * M_PI);
+			break;
+		case MB_COS:
+			sum += cos(x * M_PI);
+			break;
+		case MB_ATAN2:
+			sum += atan2(x, 0.5f);
+			break;
+		case MB_ACOS:
+			sum += acos(x);
+			break;
+		case MB_TAN:
+			sum += tan(x);
+			break;
+		case MB_POW:
+			sum += pow(x + 1.0f, 1.5f);
+			break;
+		case MB_ANGLEVECTORS_FORWARD:
+			AngleVectors(mathBenchAngles[j], forward, NULL, NULL);
+			sum += forward[0];
+			break;
+		case MB_ANGLEVECTORS:
+			AngleVectors(mathBenchAngles[j], forward, right, up);
+			sum += forward[0] + right[1] + up[2];
+			break;
+		case MB_VECTOANGLES:
+			vectoangles(mathBenchVectors[j], v);
+			sum += v[YAW];
+			break;
+		case MB_VECTOANGLES_FLAT:
+			VectorCopy(mathBenchVectors[j], v);
+			v[2] = 0.0f;
+			vectoangles(v, v);
+			sum += v[YAW];
+			break;
+		case MB_VECTORNORMALIZE:
+			VectorCopy(mathBenchVectors[j], v);
+			sum += VectorNormalize(v);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return sum;
+}
+
+/*
+================
+G_MathBenchError
+
+The largest differences of acos, tan and pow from the same results worked
+out with sqrt, sin, cos and atan2, over a sweep of their inputs
+================
+*/
+static void G_MathBenchError(float *acosError, float *tanError,
+			     float *powError)
+{
+	float x, error;
+	int i;
+
+	*acosError = *tanError = *powError = 0.0f;
+
+	for (i = 0; i <= MATHBENCH_SWEEP; i++) {
+		x = 2.0f * i / MATHBENCH_SWEEP - 1.0f;
+
+		error = fabs(acos(x) - atan2(sqrt((1.0f - x) * (1.0f + x)), x));
+		if (error > *acosError)
+			*acosError = error;
+
+		// tan is checked as tan * cos = sin, since it runs off to infinity
+		error = fabs(tan(x * 1.5f) * cos(x * 1.5f) - sin(x * 1.5f));
+		if (error > *tanError)
+			*tanError = error;
+
+		error = fabs(pow(x + 1.0f, 1.5f) - (x + 1.0f) * sqrt(x + 1.0f));
+		if (error > *powError)
+			*powError = error;
+	}
+}
+
+/*
+================
+Svcmd_MathBench_f
+
+mathbench [msec]
+================
+*/
+void Svcmd_MathBench_f(void)
+{
+	int msec, test, i;
+	float ns, sum = 0.0f, acosError, tanError, powError;
+
+	if (!G_BenchMsec("mathbench", &msec))
+		return;
+
+	for (i = 0; i < MATHBENCH_INPUTS; i++) {
+		mathBenchValues[i] = 2.0f * i / (MATHBENCH_INPUTS - 1) - 1.0f;
+
+		mathBenchAngles[i][PITCH] = (i * 37 % 178) - 89.0f;
+		mathBenchAngles[i][YAW] = (i * 113 % 360);
+		mathBenchAngles[i][ROLL] = 0.0f;
+
+		AngleVectors(mathBenchAngles[i], mathBenchVectors[i], NULL,
+			     NULL);
+		VectorScale(mathBenchVectors[i], 1.0f + (i & 15),
+			    mathBenchVectors[i]);
+	}
+
+	G_Printf("mathbench: ns per call\n");
+
+	for (test = 0; test < MB_NUM_TESTS; test++) {
+		ns = G_BenchTime(G_MathBenchRun, test, 0, msec, &sum);
+		G_Printf("mathbench: %-16s %9.1f\n", mathBenchNames[test], ns);
+	}
+
+	G_MathBenchError(&acosError, &tanError, &powError);
+	G_Printf("mathbench: largest error acos %g, tan %g, pow %g\n",
+		 acosError, tanError, powError);
+
+	G_Printf("mathbench: checksum %g\n", sum);
+}
@@ -0,0 +1,315 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_nameindex.c -- trigram index for substring searches on sanitised names
+//
+// Every three character run of an indexed name is hashed to a bucket that
+// lists the ids whose names contain it.  Any name containing a search
+// string must contain each of the search string's trigrams, so only the
+// ids in the smallest of those buckets need to be checked.  Searches
+// shorter than a trigram check every id instead.  Each index has its own
+// pool of nodes.  A name that doesn't fit is left out and its id is checked
+// by every search until it is removed.  Hash collisions only cost extra
+// checks, since the caller's match function has the final say.
+
+#include "g_local.h"
+
+#define NAMEINDEX_MAX_RESULTS 1024
+
+static int nameIndexRanks[NAMEINDEX_MAX_RESULTS];
+
+/*
+================
+G_NameIndexTrigrams
+
+Hash each trigram of name into buckets, returning how many there are
+================
+*/
+static int G_NameIndexTrigrams(const char *name, int *buckets, int size)
+{
+	int n = 0;
+
+	for (; name[0] && name[1] && name[2] && n < size; name++) {
+		buckets[n++] = ((name[0] * 131 + name[1]) * 131 + name[2]) &
+		    (NAMEINDEX_BUCKETS - 1);
+	}
+
+	return n;
+}
+
+/*
+================
+G_NameIndexUnlink
+
+Take id out of a bucket, returning its node to the pool
+================
+*/
+static void G_NameIndexUnlink(nameIndex_t * index, int bucket, int id)
+{
+	nameIndexNode_t *nodes = index->nodes;
+	int node, *link;
+
+	for (link = &index->buckets[bucket]; *link;
+	     link = &nodes[*link - 1].next) {
+		if (nodes[*link - 1].id != id)
+			continue;
+
+		node = *link;
+		*link = nodes[node - 1].next;
+		nodes[node - 1].next = index->freeNodes;
+		index->freeNodes = node;
+		index->bucketSize[bucket]--;
+		break;
+	}
+}
+
+/*
+================
+G_NameIndexAdd
+
+Index a name under id.  An id may have several names added to it, but they
+must all be removed together.
+================
+*/
+void G_NameIndexAdd(nameIndex_t * index, int id, const char *name)
+{
+	nameIndexNode_t *nodes = index->nodes;
+	int buckets[NAMEINDEX_MAX_TRIGRAMS];
+	int added[NAMEINDEX_MAX_TRIGRAMS];
+	int i, n, numAdded = 0, node;
+
+	if (id >= index->numIds)
+		index->numIds = id + 1;
+
+	n = G_NameIndexTrigrams(name, buckets, NAMEINDEX_MAX_TRIGRAMS);
+
+	for (i = 0; i < n; i++) {
+		// once per bucket is enough
+		for (node = index->buckets[buckets[i]]; node;
+		     node = nodes[node - 1].next) {
+			if (nodes[node - 1].id == id)
+				break;
+		}
+		if (node)
+			continue;
+
+		if (index->freeNodes) {
+			node = index->freeNodes;
+			index->freeNodes = nodes[node - 1].next;
+		} else if (index->nodesUsed < index->maxNodes)
+			node = ++index->nodesUsed;
+		else
+			break;
+
+		nodes[node - 1].id = id;
+		nodes[node - 1].next = index->buckets[buckets[i]];
+		index->buckets[buckets[i]] = node;
+		index->bucketSize[buckets[i]]++;
+		added[numAdded++] = buckets[i];
+	}
+
+	if (i == n)
+		return;
+
+	// out of nodes, so leave the name out rather than half in
+	G_Printf(S_COLOR_YELLOW "WARNING: name index full, \"%s\" will be "
+		 "found by checking every name\n", name);
+
+	while (numAdded > 0)
+		G_NameIndexUnlink(index, added[--numAdded], id);
+
+	for (i = 0; i < index->numUnindexed; i++) {
+		if (index->unindexed[i] == id)
+			return;
+	}
+
+	if (index->numUnindexed < NAMEINDEX_MAX_UNINDEXED)
+		index->unindexed[index->numUnindexed++] = id;
+	else
+		index->overflowed = qtrue;
+}
+
+/*
+================
+G_NameIndexRemove
+
+Remove id from the buckets of name, which it was added with
+================
+*/
+void G_NameIndexRemove(nameIndex_t * index, int id, const char *name)
+{
+	int buckets[NAMEINDEX_MAX_TRIGRAMS];
+	int i, n;
+
+	n = G_NameIndexTrigrams(name, buckets, NAMEINDEX_MAX_TRIGRAMS);
+
+	for (i = 0; i < n; i++)
+		G_NameIndexUnlink(index, buckets[i], id);
+
+	// its names go together, so none of them are left out any more
+	for (i = 0; i < index->numUnindexed; i++) {
+		if (index->unindexed[i] == id) {
+			index->unindexed[i] =
+			    index->unindexed[--index->numUnindexed];
+			break;
+		}
+	}
+}
+
+/*
+================
+G_NameIndexClear
+
+Empty an index, keeping its pool
+================
+*/
+void G_NameIndexClear(nameIndex_t * index)
+{
+	nameIndexNode_t *nodes = index->nodes;
+	int maxNodes = index->maxNodes;
+
+	memset(index, 0, sizeof(*index));
+	index->nodes = nodes;
+	index->maxNodes = maxNodes;
+}
+
+/*
+================
+G_NameMatchRank
+
+How well name matches search: 3 for the whole name, 2 for a prefix, 1 for
+anywhere in the name and 0 for not at all
+================
+*/
+int G_NameMatchRank(const char *name, const char *search)
+{
+	if (!strcmp(name, search))
+		return 3;
+	if (!Q_strncmp(name, search, strlen(search)))
+		return 2;
+	if (strstr(name, search))
+		return 1;
+
+	return 0;
+}
+
+/*
+================
+G_NameIndexInsert
+
+Insert id with rank into the sorted results, dropping whatever falls off
+the end
+================
+*/
+static void G_NameIndexInsert(int id, int rank, int *ids, int maxIds,
+			      int *stored)
+{
+	int i;
+
+	for (i = *stored; i > 0; i--) {
+		if (nameIndexRanks[i - 1] > rank ||
+		    (nameIndexRanks[i - 1] == rank && ids[i - 1] < id))
+			break;
+		if (i < maxIds) {
+			ids[i] = ids[i - 1];
+			nameIndexRanks[i] = nameIndexRanks[i - 1];
+		}
+	}
+	if (i < maxIds) {
+		ids[i] = id;
+		nameIndexRanks[i] = rank;
+		if (*stored < maxIds)
+			(*stored)++;
+	}
+}
+
+/*
+================
+G_NameIndexSearch
+
+Find the ids that match accepts for search, best ranked first and lowest id
+first within a rank.  Up to maxIds of them are stored in ids, but the
+number returned is all the matches.
+================
+*/
+int G_NameIndexSearch(nameIndex_t * index, const char *search,
+		      nameIndexMatch_t match, int *ids, int maxIds)
+{
+	int buckets[NAMEINDEX_MAX_TRIGRAMS];
+	int i, n, best, node, id, rank, found = 0, stored = 0;
+
+	if (maxIds > NAMEINDEX_MAX_RESULTS)
+		maxIds = NAMEINDEX_MAX_RESULTS;
+
+	n = G_NameIndexTrigrams(search, buckets, NAMEINDEX_MAX_TRIGRAMS);
+	best = -1;
+	if (!index->overflowed) {
+		for (i = 0; i < n; i++) {
+			if (best < 0 ||
+			    index->bucketSize[buckets[i]] <
+			    index->bucketSize[best])
+				best = buckets[i];
+		}
+	}
+
+	if (best < 0) {
+		for (id = 0; id < index->numIds; id++) {
+			if ((rank = match(id, search)) > 0) {
+				found++;
+				G_NameIndexInsert(id, rank, ids, maxIds,
+						  &stored);
+			}
+		}
+
+		return found;
+	}
+
+	for (node = index->buckets[best]; node;
+	     node = index->nodes[node - 1].next) {
+		id = index->nodes[node - 1].id;
+
+		// checked below
+		for (i = 0; i < index->numUnindexed; i++) {
+			if (index->unindexed[i] == id)
+				break;
+		}
+		if (i < index->numUnindexed)
+			continue;
+
+		if ((rank = match(id, search)) > 0) {
+			found++;
+			G_NameIndexInsert(id, rank, ids, maxIds, &stored);
+		}
+	}
+
+	for (i = 0; i < index->numUnindexed; i++) {
+		id = index->unindexed[i];
+
+		if ((rank = match(id, search)) > 0) {
+			found++;
+			G_NameIndexInsert(id, rank, ids, maxIds, &stored);
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,155 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+
+// g_parsebench.c -- throughput checks for the config file tokenizers
+//
+// parsebench tokenizes a file over and over, first with COM_ParseExt and
+// then with COM_ParseSpan, and reports how fast each got through it.  It
+// also walks the file with both at once to check that they found the same
+// tokens, since COM_ParseSpan is meant to be a drop in for any parser that
+// doesn't need its tokens copied.
+
+#include "g_local.h"
+
+#define PARSEBENCH_DEFAULT_PASSES 100
+#define PARSEBENCH_MAX_PASSES     100000
+
+/*
+================
+G_ParseBenchCompare
+
+Tokenize text with both tokenizers at once, returning how many tokens
+differ and setting *tokens to how many there were
+================
+*/
+static int G_ParseBenchCompare(char *text, int *tokens)
+{
+	char span[MAX_TOKEN_CHARS];
+	char *extData = text, *spanData = text;
+	char *ext;
+	tokenSpan_t token;
+	int differ = 0;
+
+	*tokens = 0;
+
+	while (1) {
+		ext = COM_ParseExt(&extData, qtrue);
+
+		if (!COM_ParseSpan(&spanData, qtrue, &token)) {
+			if (ext[0] || extData)
+				differ++;
+			break;
+		}
+
+		COM_SpanCopy(&token, span, sizeof(span));
+		if (strcmp(ext, span)) {
+			if (!differ)
+				G_Printf("parsebench: token %d is \"%s\" from "
+					 "COM_ParseExt but \"%s\" from "
+					 "COM_ParseSpan\n", *tokens, ext, span);
+			differ++;
+		}
+		(*tokens)++;
+	}
+
+	return differ;
+}
+
+/*
+================
+Svcmd_ParseBench_f
+
+parsebench <file> [passes]
+================
+*/
+void Svcmd_ParseBench_f(void)
+{
+	char path[MAX_QPATH];
+	char arg[MAX_TOKEN_CHARS];
+	char *text, *data;
+	tokenSpan_t token;
+	fileHandle_t f;
+	int len, passes, i, tokens, differ, start, extMsec, spanMsec;
+
+	if (trap_Argc() < 2) {
+		G_Printf("usage: parsebench <file> [passes]\n");
+		return;
+	}
+
+	trap_Argv(1, path, sizeof(path));
+
+	passes = PARSEBENCH_DEFAULT_PASSES;
+	if (trap_Argc() > 2) {
+		trap_Argv(2, arg, sizeof(arg));
+		passes = atoi(arg);
+	}
+	if (passes < 1 || passes > PARSEBENCH_MAX_PASSES) {
+		G_Printf("parsebench: passes must be between 1 and %d\n",
+			 PARSEBENCH_MAX_PASSES);
+		return;
+	}
+
+	len = trap_FS_FOpenFile(path, &f, FS_READ);
+	if (len < 0) {
+		G_Printf("parsebench: couldn't open %s\n", path);
+		return;
+	}
+
+	// a second NUL keeps COM_ParseExt inside the buffer when a quoted
+	// string runs to the end of the file
+	text = G_Alloc(len + 2);
+	trap_FS_Read(text, len, f);
+	trap_FS_FCloseFile(f);
+	text[len] = text[len + 1] = '\0';
+
+	differ = G_ParseBenchCompare(text, &tokens);
+
+	start = trap_Milliseconds();
+	for (i = 0; i < passes; i++) {
+		data = text;
+		while (data)
+			COM_ParseExt(&data, qtrue);
+	}
+	extMsec = trap_Milliseconds() - start;
+
+	start = trap_Milliseconds();
+	for (i = 0; i < passes; i++) {
+		data = text;
+		while (COM_ParseSpan(&data, qtrue, &token));
+	}
+	spanMsec = trap_Milliseconds() - start;
+
+	G_Free(text);
+
+	G_Printf("parsebench: %s, %d bytes, %d tokens, %d passes\n", path, len,
+		 tokens, passes);
+	G_Printf("parsebench: COM_ParseExt  %5d msec, %7.1f MB/s\n", extMsec,
+		 extMsec ? (float)len * passes / (extMsec * 1000.0f) : 0.0f);
+	G_Printf("parsebench: COM_ParseSpan %5d msec, %7.1f MB/s\n", spanMsec,
+		 spanMsec ? (float)len * passes / (spanMsec * 1000.0f) : 0.0f);
+
+	if (differ)
+		G_Printf(S_COLOR_YELLOW "WARNING: parsebench: %d tokens "
+			 "differ between the tokenizers\n", differ);
+}
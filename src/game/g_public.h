@@ -257,3 +257,36 @@ typedef enum {
 	    // The game can issue trap_argc() / trap_argv() commands to get the command
 	    // and parameters.  Return qfalse if the game doesn't recognize it as a command.
 } gameExport_t;
+
+// usercmd recordings, written by the game while g_cmdRecord is set and
+// replayed with gamehost -replay.  Integers are little endian base 128
+// varints, signed ones zigzag encoded, and strings are a varint length
+// followed by that many bytes.
+
+#define CMDRECORD_IDENT   (('R'<<24)+('D'<<16)+('M'<<8)+'C')
+#define CMDRECORD_VERSION 1
+
+typedef enum {
+	CR_INIT,		// levelTime, randomSeed, restart, maxclients, mapname
+	CR_FRAME,		// levelTime less the previous frame or init
+	CR_CONNECT,		// clientNum, firstTime, userinfo
+	CR_BEGIN,		// clientNum
+	CR_USERINFO,		// clientNum, userinfo
+	CR_DISCONNECT,		// clientNum
+	CR_THINK,		// clientNum, CRF_* flags, the fields they name
+	CR_COMMAND,		// clientNum, argc, argv...
+	CR_CONSOLE,		// argc, argv...
+	CR_SHUTDOWN
+} cmdRecordType_t;
+
+// which fields of a CR_THINK usercmd changed from that client's last one,
+// each stored as a signed difference
+#define CRF_SERVERTIME    0x0001
+#define CRF_ANGLE0        0x0002
+#define CRF_ANGLE1        0x0004
+#define CRF_ANGLE2        0x0008
+#define CRF_BUTTONS       0x0010
+#define CRF_WEAPON        0x0020
+#define CRF_FORWARDMOVE   0x0040
+#define CRF_RIGHTMOVE     0x0080
+#define CRF_UPMOVE        0x0100
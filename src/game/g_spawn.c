@@ -143,6 +143,15 @@ typedef struct {
 	void (*spawn)(gentity_t * ent);
 } spawn_t;
 
+// G_NewString's copies for this level, open addressed
+#define SPAWN_STRING_BUCKETS 4096	// power of two
+#define SPAWN_STRING_CHUNK   8192
+
+static char *spawnStrings[SPAWN_STRING_BUCKETS];
+static int numSpawnStrings;
+static char *spawnStringChunk;
+static int spawnStringChunkLeft;
+
 void SP_info_player_start(gentity_t * ent);
 void SP_info_player_deathmatch(gentity_t * ent);
 void SP_info_player_intermission(gentity_t * ent);
@@ -294,6 +303,120 @@ spawn_t spawns[] = {
 	{ NULL, 0 }
 };
 
+// fields[] and spawns[] indices sorted by name, ties in table order
+static int fieldOrder[sizeof(fields) / sizeof(fields[0])];
+static int spawnOrder[sizeof(spawns) / sizeof(spawns[0])];
+static int numFields, numSpawns;
+static qboolean spawnTablesSorted;
+
+/*
+===============
+G_CompareFields
+===============
+*/
+static int G_CompareFields(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+	int order = Q_stricmp(fields[x].name, fields[y].name);
+
+	return order ? order : x - y;
+}
+
+/*
+===============
+G_CompareSpawns
+===============
+*/
+static int G_CompareSpawns(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+	int order = strcmp(spawns[x].name, spawns[y].name);
+
+	return order ? order : x - y;
+}
+
+/*
+===============
+G_SortSpawnTables
+===============
+*/
+static void G_SortSpawnTables(void)
+{
+	for (numFields = 0; fields[numFields].name; numFields++)
+		fieldOrder[numFields] = numFields;
+
+	qsort(fieldOrder, numFields, sizeof(int), G_CompareFields);
+
+	for (numSpawns = 0; spawns[numSpawns].name; numSpawns++)
+		spawnOrder[numSpawns] = numSpawns;
+
+	qsort(spawnOrder, numSpawns, sizeof(int), G_CompareSpawns);
+
+	spawnTablesSorted = qtrue;
+}
+
+/*
+===============
+G_FindField
+
+Binary search fields[] for key, ignoring case
+===============
+*/
+static field_t *G_FindField(const char *key)
+{
+	int low, high, mid;
+
+	if (!spawnTablesSorted)
+		G_SortSpawnTables();
+
+	low = 0;
+	high = numFields;
+	while (low < high) {
+		mid = (low + high) / 2;
+
+		if (Q_stricmp(fields[fieldOrder[mid]].name, key) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low < numFields && !Q_stricmp(fields[fieldOrder[low]].name, key))
+		return &fields[fieldOrder[low]];
+
+	return NULL;
+}
+
+/*
+===============
+G_FindSpawn
+
+Binary search spawns[] for classname
+===============
+*/
+static spawn_t *G_FindSpawn(const char *classname)
+{
+	int low, high, mid;
+
+	if (!spawnTablesSorted)
+		G_SortSpawnTables();
+
+	low = 0;
+	high = numSpawns;
+	while (low < high) {
+		mid = (low + high) / 2;
+
+		if (strcmp(spawns[spawnOrder[mid]].name, classname) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low < numSpawns && !strcmp(spawns[spawnOrder[low]].name, classname))
+		return &spawns[spawnOrder[low]];
+
+	return NULL;
+}
+
 /*
 ===============
 G_CallSpawn
@@ -327,12 +450,9 @@ qboolean G_CallSpawn(gentity_t * ent)
 		return qtrue;
 	}
 	// check normal spawn functions
-	for (s = spawns; s->name; s++) {
-		if (!strcmp(s->name, ent->classname)) {
-			// found it
-			s->spawn(ent);
-			return qtrue;
-		}
+	if ((s = G_FindSpawn(ent->classname))) {
+		s->spawn(ent);
+		return qtrue;
 	}
 
 	G_Printf("%s doesn't have a spawn function\n", ent->classname);
@@ -341,22 +461,31 @@ qboolean G_CallSpawn(gentity_t * ent)
 
 /*
 =============
-G_NewString
+G_ClearSpawnStrings
 
-Builds a copy of the string, translating \n to real linefeeds
-so message texts can be multi-line
+Forget the strings G_NewString handed out for the last level
 =============
 */
-char *G_NewString(const char *string)
+static void G_ClearSpawnStrings(void)
 {
-	char *newb, *new_p;
-	int i, l;
-
-	l = strlen(string) + 1;
+	memset(spawnStrings, 0, sizeof(spawnStrings));
+	numSpawnStrings = 0;
+	spawnStringChunk = NULL;
+	spawnStringChunkLeft = 0;
+}
 
-	newb = G_Alloc(l);
+/*
+=============
+G_UnescapeString
 
-	new_p = newb;
+Copy the first l characters of string to dest, translating \n to real
+linefeeds so message texts can be multi-line.  Returns the length copied.
+=============
+*/
+static int G_UnescapeString(char *dest, const char *string, int l)
+{
+	char *new_p = dest;
+	int i;
 
 	// turn \n into a real linefeed
 	for (i = 0; i < l; i++) {
@@ -370,6 +499,69 @@ char *G_NewString(const char *string)
 			*new_p++ = string[i];
 	}
 
+	return new_p - dest;
+}
+
+/*
+=============
+G_NewString
+
+Builds a copy of the string, translating \n to real linefeeds
+so message texts can be multi-line
+
+Copies are interned, so the same classname or target on a thousand
+entities is only stored once, and packed into chunks instead of taking a
+G_Alloc block each.  They must not be written to.
+=============
+*/
+char *G_NewString(const char *string)
+{
+	char buffer[MAX_SPAWN_VARS_CHARS];
+	char *newb;
+	int i, l, slot;
+	unsigned int hash;
+
+	l = strlen(string) + 1;
+
+	if (l > sizeof(buffer)) {
+		newb = G_Alloc(l);
+		G_UnescapeString(newb, string, l);
+		return newb;
+	}
+
+	l = G_UnescapeString(buffer, string, l);
+
+	hash = 2166136261U;
+	for (i = 0; i < l; i++)
+		hash = (hash ^ (byte) buffer[i]) * 16777619U;
+
+	for (slot = hash & (SPAWN_STRING_BUCKETS - 1); spawnStrings[slot];
+	     slot = (slot + 1) & (SPAWN_STRING_BUCKETS - 1)) {
+		if (!strcmp(spawnStrings[slot], buffer))
+			return spawnStrings[slot];
+	}
+
+	if (l > SPAWN_STRING_CHUNK / 4)
+		newb = G_Alloc(l);
+	else {
+		if (l > spawnStringChunkLeft) {
+			spawnStringChunk = G_Alloc(SPAWN_STRING_CHUNK);
+			spawnStringChunkLeft = SPAWN_STRING_CHUNK;
+		}
+
+		newb = spawnStringChunk;
+		spawnStringChunk += l;
+		spawnStringChunkLeft -= l;
+	}
+
+	memcpy(newb, buffer, l);
+
+	// leave the table some room so probes stay short
+	if (numSpawnStrings < SPAWN_STRING_BUCKETS * 3 / 4) {
+		spawnStrings[slot] = newb;
+		numSpawnStrings++;
+	}
+
 	return newb;
 }
 
@@ -389,57 +581,52 @@ void G_ParseField(const char *key, const char *value, gentity_t * ent)
 	vec3_t vec;
 	vec4_t vec4;
 
-	for (f = fields; f->name; f++) {
-		if (!Q_stricmp(f->name, key)) {
-			// found it
-			b = (byte *) ent;
-
-			switch (f->type) {
-			case F_LSTRING:
-				*(char **)(b + f->ofs) = G_NewString(value);
-				break;
-
-			case F_VECTOR:
-				sscanf(value, "%f %f %f", &vec[0], &vec[1],
-				       &vec[2]);
-
-				((float *)(b + f->ofs))[0] = vec[0];
-				((float *)(b + f->ofs))[1] = vec[1];
-				((float *)(b + f->ofs))[2] = vec[2];
-				break;
-
-			case F_VECTOR4:
-				sscanf(value, "%f %f %f %f", &vec4[0], &vec4[1],
-				       &vec4[2], &vec4[3]);
-
-				((float *)(b + f->ofs))[0] = vec4[0];
-				((float *)(b + f->ofs))[1] = vec4[1];
-				((float *)(b + f->ofs))[2] = vec4[2];
-				((float *)(b + f->ofs))[3] = vec4[3];
-				break;
-
-			case F_INT:
-				*(int *)(b + f->ofs) = atoi(value);
-				break;
-
-			case F_FLOAT:
-				*(float *)(b + f->ofs) = atof(value);
-				break;
-
-			case F_ANGLEHACK:
-				v = atof(value);
-				((float *)(b + f->ofs))[0] = 0;
-				((float *)(b + f->ofs))[1] = v;
-				((float *)(b + f->ofs))[2] = 0;
-				break;
-
-			default:
-			case F_IGNORE:
-				break;
-			}
-
-			return;
-		}
+	if (!(f = G_FindField(key)))
+		return;
+
+	b = (byte *) ent;
+
+	switch (f->type) {
+	case F_LSTRING:
+		*(char **)(b + f->ofs) = G_NewString(value);
+		break;
+
+	case F_VECTOR:
+		sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
+
+		((float *)(b + f->ofs))[0] = vec[0];
+		((float *)(b + f->ofs))[1] = vec[1];
+		((float *)(b + f->ofs))[2] = vec[2];
+		break;
+
+	case F_VECTOR4:
+		sscanf(value, "%f %f %f %f", &vec4[0], &vec4[1], &vec4[2],
+		       &vec4[3]);
+
+		((float *)(b + f->ofs))[0] = vec4[0];
+		((float *)(b + f->ofs))[1] = vec4[1];
+		((float *)(b + f->ofs))[2] = vec4[2];
+		((float *)(b + f->ofs))[3] = vec4[3];
+		break;
+
+	case F_INT:
+		*(int *)(b + f->ofs) = atoi(value);
+		break;
+
+	case F_FLOAT:
+		*(float *)(b + f->ofs) = atof(value);
+		break;
+
+	case F_ANGLEHACK:
+		v = atof(value);
+		((float *)(b + f->ofs))[0] = 0;
+		((float *)(b + f->ofs))[1] = v;
+		((float *)(b + f->ofs))[2] = 0;
+		break;
+
+	default:
+	case F_IGNORE:
+		break;
 	}
 }
 
@@ -648,6 +835,8 @@ void G_SpawnEntitiesFromString(void)
 	level.spawning = qtrue;
 	level.numSpawnVars = 0;
 
+	G_ClearSpawnStrings();
+
 	// the worldspawn is not an actual entity, but it still
 	// has a "spawn" function to perform any global setup
 	// needed by a level (setting configstrings or cvars, etc)
@@ -174,12 +174,12 @@ static void UpdateIPBans(void)
 G_FilterPacket
 =================
 */
-qboolean G_FilterPacket(char *from)
+qboolean G_FilterPacket(const char *from)
 {
 	int i;
 	unsigned in;
 	byte m[4];
-	char *p;
+	const char *p;
 
 	i = 0;
 	p = from;
@@ -569,6 +569,31 @@ qboolean ConsoleCommand(void)
 		return qtrue;
 	}
 
+	if (Q_stricmp(cmd, "cmdstats") == 0) {
+		Svcmd_CommandStats_f();
+		return qtrue;
+	}
+
+	if (Q_stricmp(cmd, "damagegrid") == 0) {
+		Svcmd_DamageGrid_f();
+		return qtrue;
+	}
+
+	if (Q_stricmp(cmd, "parsebench") == 0) {
+		Svcmd_ParseBench_f();
+		return qtrue;
+	}
+
+	if (Q_stricmp(cmd, "libbench") == 0) {
+		Svcmd_LibBench_f();
+		return qtrue;
+	}
+
+	if (Q_stricmp(cmd, "mathbench") == 0) {
+		Svcmd_MathBench_f();
+		return qtrue;
+	}
+
 	if (Q_stricmp(cmd, "addip") == 0) {
 		Svcmd_AddIP_f();
 		return qtrue;
@@ -17,7 +17,7 @@ equ trap_FS_FCloseFile                -14
 equ trap_SendConsoleCommand           -15
 equ trap_LocateGameData               -16
 equ trap_DropClient                   -17
-equ trap_SendServerCommand            -18
+equ trap_SendServerCommandNow         -18
 equ trap_SetConfigstring              -19
 equ trap_GetConfigstring              -20
 equ trap_SetConfigstringRestrictions  -21
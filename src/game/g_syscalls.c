@@ -137,7 +137,7 @@ void trap_DropClient(int clientNum, const char *reason)
 	syscall(G_DROP_CLIENT, clientNum, reason);
 }
 
-void trap_SendServerCommand(int clientNum, const char *text)
+void trap_SendServerCommandNow(int clientNum, const char *text)
 {
 	syscall(G_SEND_SERVER_COMMAND, clientNum, text);
 }
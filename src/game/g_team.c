@@ -143,11 +143,6 @@ qboolean Team_GetLocationMsg(gentity_t * ent, char *loc, int loclen)
 
 /*---------------------------------------------------------------------------*/
 
-static int QDECL SortClients(const void *a, const void *b)
-{
-	return *(int *)a - *(int *)b;
-}
-
 /*
 ==================
 TeamplayLocationsMessage
@@ -166,26 +161,10 @@ void TeamplayInfoMessage(gentity_t * ent)
 	gentity_t *player;
 	int cnt;
 	int h, a = 0;
-	int clients[TEAM_MAXOVERLAY];
 
 	if (!ent->client->pers.teamInfo)
 		return;
 
-	// figure out what client should be on the display
-	// we are limited to 8, but we want to use the top eight players
-	// but in client order (so they don't keep changing position on the overlay)
-	for (i = 0, cnt = 0; i < g_maxclients.integer && cnt < TEAM_MAXOVERLAY;
-	     i++) {
-		player = g_entities + level.sortedClients[i];
-
-		if (player->inuse && player->client->sess.sessionTeam ==
-		    ent->client->sess.sessionTeam)
-			clients[cnt++] = level.sortedClients[i];
-	}
-
-	// We have the top eight players, sort them by clientNum
-	qsort(clients, cnt, sizeof(clients[0]), SortClients);
-
 	// send the latest information on all clients
 	string[0] = 0;
 	stringlength = 0;
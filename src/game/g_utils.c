@@ -165,6 +165,26 @@ void G_TeamCommand(pTeam_t team, char *cmd)
 	}
 }
 
+/*
+================
+G_ClientListCommand
+
+Sends an already encoded command to every client in list
+================
+*/
+void G_ClientListCommand(clientList_t * list, const char *cmd)
+{
+	int i;
+
+	if (!list->lo && !list->hi)
+		return;
+
+	for (i = 0; i < level.maxclients; i++) {
+		if (BG_ClientListTest(list, i))
+			trap_SendServerCommand(i, cmd);
+	}
+}
+
 /*
 =============
 G_Find
@@ -491,6 +511,9 @@ void G_FreeEntity(gentity_t * ent)
 	if (ent->neverFree)
 		return;
 
+	if (ent->s.eType == ET_BUILDABLE)
+		level.buildGeneration++;
+
 	memset(ent, 0, sizeof(*ent));
 	ent->classname = "freent";
 	ent->freetime = level.time;
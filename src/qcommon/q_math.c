@@ -582,10 +582,16 @@ void vectoangles(const vec3_t value1, vec3_t angles)
 			yaw += 360;
 		}
 
-		forward = sqrt(value1[0] * value1[0] + value1[1] * value1[1]);
-		pitch = (atan2(value1[2], forward) * 180 / M_PI);
-		if (pitch < 0) {
-			pitch += 360;
+		// atan2 of a 0 over a positive forward is that same 0
+		if (value1[2] == 0)
+			pitch = value1[2];
+		else {
+			forward = sqrt(value1[0] * value1[0] +
+				       value1[1] * value1[1]);
+			pitch = (atan2(value1[2], forward) * 180 / M_PI);
+			if (pitch < 0) {
+				pitch += 360;
+			}
 		}
 	}
 
@@ -1436,15 +1442,31 @@ void AngleVectors(const vec3_t angles, vec3_t forward, vec3_t right, vec3_t up)
 	static float sr, sp, sy, cr, cp, cy;
 	// static to help MS compiler fp bugs
 
+	// sin and cos are engine calls in a VM, so they're skipped where the
+	// answer is known.  sin(0) is taken as angle to keep the sign of a -0.
 	angle = angles[YAW] * (M_PI * 2 / 360);
 	sy = sin(angle);
 	cy = cos(angle);
 	angle = angles[PITCH] * (M_PI * 2 / 360);
-	sp = sin(angle);
-	cp = cos(angle);
-	angle = angles[ROLL] * (M_PI * 2 / 360);
-	sr = sin(angle);
-	cr = cos(angle);
+	if (angle == 0.0f) {
+		sp = angle;
+		cp = 1.0f;
+	} else {
+		sp = sin(angle);
+		cp = cos(angle);
+	}
+
+	// roll only matters to right and up
+	if (right || up) {
+		angle = angles[ROLL] * (M_PI * 2 / 360);
+		if (angle == 0.0f) {
+			sr = angle;
+			cr = 1.0f;
+		} else {
+			sr = sin(angle);
+			cr = cos(angle);
+		}
+	}
 
 	if (forward) {
 		forward[0] = cp * cy;
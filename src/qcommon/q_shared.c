@@ -478,6 +478,212 @@ char *COM_ParseExt(char **data_p, qboolean allowLineBreaks)
 	return com_token;
 }
 
+// any byte of x zero
+#define SPAN_HASZERO(x)	(((x) - 0x01010101U) & ~(x) & 0x80808080U)
+// any byte of x c
+#define SPAN_HASBYTE(x, c)	SPAN_HASZERO((x) ^ (0x01010101U * (c)))
+
+/*
+==============
+COM_SpanSkipTo
+
+The first c1, c2 or NUL from data on, searched for a word at a time once
+data is aligned
+==============
+*/
+static const char *COM_SpanSkipTo(const char *data, int c1, int c2)
+{
+	const unsigned int *word;
+	int c;
+
+	while ((intptr_t) data & 3) {
+		c = *data;
+		if (!c || c == c1 || c == c2)
+			return data;
+		data++;
+	}
+
+	word = (const unsigned int *)data;
+	while (!SPAN_HASZERO(*word) && !SPAN_HASBYTE(*word, c1) &&
+	       !SPAN_HASBYTE(*word, c2))
+		word++;
+	data = (const char *)word;
+
+	while ((c = *data) && c != c1 && c != c2)
+		data++;
+
+	return data;
+}
+
+/*
+==============
+COM_ParseSpan
+
+Like COM_ParseExt, but token is set to where the next token is in the text
+instead of the token being copied out, so it is as long as the text has it
+and is only valid for as long as the text is.  Returns qfalse at the end of
+the text, or at a line break if allowLineBreaks is qfalse.
+
+Comments and quoted strings are searched a word at a time for the
+characters that end them, as are runs of spaces.  Newlines in block
+comments and quoted strings are counted, which COM_ParseExt doesn't do,
+but as there they don't count as line breaks.
+==============
+*/
+qboolean COM_ParseSpan(char **data_p, qboolean allowLineBreaks,
+		       tokenSpan_t * token)
+{
+	const char *data = *data_p;
+	qboolean hasNewLines = qfalse;
+	int c;
+
+	token->text = "";
+	token->length = 0;
+
+	if (!data) {
+		*data_p = NULL;
+		return qfalse;
+	}
+
+	while (1) {
+		// skip whitespace
+		while ((c = *data) <= ' ') {
+			if (!c) {
+				*data_p = NULL;
+				return qfalse;
+			}
+			if (c == '\n') {
+				com_lines++;
+				hasNewLines = qtrue;
+			}
+			data++;
+
+			// indentation, whole words of it at a time
+			if (c == ' ' && !((intptr_t) data & 3)) {
+				while (*(const unsigned int *)data ==
+				       0x20202020U)
+					data += 4;
+			}
+		}
+
+		if (hasNewLines && !allowLineBreaks) {
+			*data_p = (char *)data;
+			return qfalse;
+		}
+
+		if (c != '/')
+			break;
+
+		if (data[1] == '/')
+			data = COM_SpanSkipTo(data + 2, '\n', '\n');
+		else if (data[1] == '*') {
+			data += 2;
+			while (1) {
+				data = COM_SpanSkipTo(data, '*', '\n');
+				if (!*data)
+					break;
+				if (*data == '*' && data[1] == '/') {
+					data += 2;
+					break;
+				}
+				if (*data == '\n')
+					com_lines++;
+				data++;
+			}
+		} else
+			break;
+	}
+
+	// quoted strings run to the closing quote or the end of the text
+	if (c == '\"') {
+		token->text = ++data;
+		while (1) {
+			data = COM_SpanSkipTo(data, '\"', '\n');
+			if (*data != '\n')
+				break;
+			com_lines++;
+			data++;
+		}
+		token->length = data - token->text;
+		if (*data)
+			data++;
+		*data_p = (char *)data;
+		return qtrue;
+	}
+	// words are usually too short to be worth searching a word at a time
+	token->text = data;
+	do {
+		data++;
+	} while (*data > ' ');
+	token->length = data - token->text;
+
+	*data_p = (char *)data;
+	return qtrue;
+}
+
+/*
+==============
+COM_SpanEqual
+
+Whether token is s, ignoring case like Q_stricmp
+==============
+*/
+qboolean COM_SpanEqual(const tokenSpan_t * token, const char *s)
+{
+	int i, c1, c2;
+
+	for (i = 0; i < token->length; i++) {
+		c1 = token->text[i];
+		c2 = s[i];
+
+		if (c1 != c2) {
+			if (c1 >= 'a' && c1 <= 'z')
+				c1 -= ('a' - 'A');
+			if (c2 >= 'a' && c2 <= 'z')
+				c2 -= ('a' - 'A');
+			if (c1 != c2)
+				return qfalse;
+		}
+	}
+
+	return !s[i];
+}
+
+/*
+==============
+COM_SpanCopy
+
+Copy token into buffer as a string, truncated like Q_strncpyz
+==============
+*/
+void COM_SpanCopy(const tokenSpan_t * token, char *buffer, int size)
+{
+	int length = token->length;
+
+	if (size < 1)
+		return;
+
+	if (length > size - 1)
+		length = size - 1;
+
+	memcpy(buffer, token->text, length);
+	buffer[length] = '\0';
+}
+
+/*
+==============
+COM_SpanToken
+
+token as a string, as COM_ParseExt would have returned it
+==============
+*/
+char *COM_SpanToken(const tokenSpan_t * token)
+{
+	COM_SpanCopy(token, com_token, sizeof(com_token));
+
+	return com_token;
+}
+
 #if 0
 // no longer used
 /*
@@ -871,13 +1077,17 @@ void QDECL Com_sprintf(char *dest, int size, const char *fmt, ...)
 	va_list argptr;
 	char bigbuffer[32000];	// big, but small enough to fit in PPC stack
 
+	if (size < 1)
+		return;
+
+	// dest may also be one of the arguments, so it can't be written until
+	// the whole string is formatted
 	va_start(argptr, fmt);
-	len = vsprintf(bigbuffer, fmt, argptr);
+	len = Q_vsnprintf(bigbuffer, sizeof(bigbuffer), fmt, argptr);
 	va_end(argptr);
-	if (len >= sizeof(bigbuffer)) {
-		Com_Error(ERR_FATAL, "Com_sprintf: overflowed bigbuffer");
-	}
-	if (len >= size) {
+	bigbuffer[sizeof(bigbuffer) - 1] = '\0';
+
+	if (len < 0 || len >= size || len >= (int)sizeof(bigbuffer)) {
 		Com_Printf("Com_sprintf: overflow of %i in %i\n", len, size);
 #ifdef	_DEBUG
 		__asm {
@@ -893,8 +1103,8 @@ void QDECL Com_sprintf(char *dest, int size, const char *fmt, ...)
 va
 
 does a varargs printf into a temp buffer, so I don't need to have
-varargs versions of all text functions.
-FIXME: make this buffer size safe someday
+varargs versions of all text functions.  Anything that doesn't fit in
+the buffer is cut off.
 ============
 */
 char *QDECL va(char *format, ...)
@@ -908,8 +1118,9 @@ char *QDECL va(char *format, ...)
 	index++;
 
 	va_start(argptr, format);
-	vsprintf(buf, format, argptr);
+	Q_vsnprintf(buf, sizeof(string[0]), format, argptr);
 	va_end(argptr);
+	buf[sizeof(string[0]) - 1] = '\0';
 
 	return buf;
 }
@@ -935,6 +1146,66 @@ void Com_TruncateLongString(char *buffer, const char *s)
 	}
 }
 
+/*
+============
+Q_SortItems
+
+Sort items into ascending order of key, keeping items with equal keys in
+the order they were in.  Short lists get an insertion sort, and longer
+ones a radix sort a byte of the key at a time, which needs temp to be as
+long as items.
+============
+*/
+#define SORT_INSERTION_MAX	32
+#define SORT_DIGIT(k, shift)	((((unsigned int)(k) ^ 0x80000000U) >> \
+				  (shift)) & 0xFF)
+
+void Q_SortItems(sortItem_t * items, sortItem_t * temp, int count)
+{
+	int counts[256];
+	sortItem_t item, *from, *to, *swap;
+	int i, j, n, sum, shift;
+
+	if (count <= SORT_INSERTION_MAX) {
+		for (i = 1; i < count; i++) {
+			item = items[i];
+			for (j = i; j > 0 && items[j - 1].key > item.key; j--)
+				items[j] = items[j - 1];
+			items[j] = item;
+		}
+		return;
+	}
+
+	from = items;
+	to = temp;
+
+	for (shift = 0; shift < 32; shift += 8) {
+		memset(counts, 0, sizeof(counts));
+		for (i = 0; i < count; i++)
+			counts[SORT_DIGIT(from[i].key, shift)]++;
+
+		// every key has the same byte here, so nothing would move
+		if (counts[SORT_DIGIT(from[0].key, shift)] == count)
+			continue;
+
+		for (i = 0, sum = 0; i < 256; i++) {
+			n = counts[i];
+			counts[i] = sum;
+			sum += n;
+		}
+
+		for (i = 0; i < count; i++)
+			to[counts[SORT_DIGIT(from[i].key, shift)]++] = from[i];
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if (from != items)
+		memcpy(items, from, count * sizeof(items[0]));
+}
+
 /*
 =====================================================================
 
@@ -999,6 +1270,111 @@ char *Info_ValueForKey(const char *s, const char *key)
 	return "";
 }
 
+/*
+===============
+Info_KeyHash
+
+Case insensitive, so it can only rule out a Q_stricmp match
+===============
+*/
+static byte Info_KeyHash(const char *key)
+{
+	unsigned int hash = 0;
+	int c;
+
+	while ((c = *key++)) {
+		if (c >= 'a' && c <= 'z')
+			c -= ('a' - 'A');
+		hash = hash * 31 + c;
+	}
+
+	return (byte) (hash ^ (hash >> 8));
+}
+
+/*
+===============
+Info_Parse
+
+Split s into index once, so that Info_IndexValue can find keys in it
+without copying every key and value before it like Info_ValueForKey does.
+A key without a value after it is ignored, as Info_ValueForKey would.
+Returns qfalse and leaves the index empty if s is too long.
+===============
+*/
+qboolean Info_Parse(const char *s, infoIndex_t * index)
+{
+	char *o = index->string;
+	int length;
+
+	index->numPairs = 0;
+	index->string[0] = '\0';
+
+	if (!s)
+		return qtrue;
+
+	length = strlen(s);
+	if (length >= MAX_INFO_STRING)
+		return qfalse;
+
+	memcpy(index->string, s, length + 1);
+
+	if (*o == '\\')
+		o++;
+
+	while (*o) {
+		index->keys[index->numPairs] = o - index->string;
+
+		while (*o != '\\') {
+			if (!*o)
+				return qtrue;
+			o++;
+		}
+		*o++ = '\0';
+
+		index->values[index->numPairs] = o - index->string;
+		index->keyHashes[index->numPairs] =
+		    Info_KeyHash(index->string + index->keys[index->numPairs]);
+		index->numPairs++;
+
+		while (*o != '\\' && *o)
+			o++;
+
+		if (!*o)
+			break;
+		*o++ = '\0';
+	}
+
+	return qtrue;
+}
+
+/*
+===============
+Info_IndexValue
+
+The value of the first key in index that matches key, or an empty string.
+The value stays valid for as long as index does.
+===============
+*/
+const char *Info_IndexValue(const infoIndex_t * index, const char *key)
+{
+	byte hash;
+	int i;
+
+	if (!key)
+		return "";
+
+	hash = Info_KeyHash(key);
+
+	for (i = 0; i < index->numPairs; i++) {
+		if (index->keyHashes[i] != hash)
+			continue;
+		if (!Q_stricmp(key, index->string + index->keys[i]))
+			return index->string + index->values[i];
+	}
+
+	return "";
+}
+
 /*
 ===================
 Info_NextPair
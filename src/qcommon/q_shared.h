@@ -138,6 +138,13 @@ typedef unsigned __int8 uint8_t;
 #endif
 #endif
 
+// may not terminate or return the full length if it runs out of room
+#if defined(_MSC_VER) && !defined(Q3_VM)
+#define Q_vsnprintf _vsnprintf
+#else
+#define Q_vsnprintf vsnprintf
+#endif
+
 typedef unsigned char byte;
 
 typedef enum { qfalse, qtrue } qboolean;
@@ -832,6 +839,19 @@ char *COM_ParseExt(char **data_p, qboolean allowLineBreak);
 int COM_Compress(char *data_p);
 void COM_ParseError(char *format, ...) __attribute__((format(printf, 1, 2)));
 void COM_ParseWarning(char *format, ...) __attribute__((format(printf, 1, 2)));
+
+// a token as a span of the text it was parsed from, which is not copied and
+// not NUL terminated
+typedef struct {
+	const char *text;
+	int length;
+} tokenSpan_t;
+
+qboolean COM_ParseSpan(char **data_p, qboolean allowLineBreaks,
+		       tokenSpan_t * token);
+qboolean COM_SpanEqual(const tokenSpan_t * token, const char *s);
+void COM_SpanCopy(const tokenSpan_t * token, char *buffer, int size);
+char *COM_SpanToken(const tokenSpan_t * token);
 //int           COM_ParseInfos( char *buf, int max, char infos[][MAX_INFO_STRING] );
 
 #define MAX_TOKENLENGTH		1024
@@ -944,6 +964,15 @@ char *QDECL va(char *format, ...) __attribute__((format(printf, 1, 2)));
 #define TRUNCATE_LENGTH	64
 void Com_TruncateLongString(char *buffer, const char *s);
 
+// a value carried along by an int sort key, for sorts that would otherwise
+// work out the same key in a qsort comparator over and over
+typedef struct {
+	int key;
+	int value;
+} sortItem_t;
+
+void Q_SortItems(sortItem_t * items, sortItem_t * temp, int count);
+
 //=============================================
 
 //
@@ -957,6 +986,21 @@ void Info_SetValueForKey_Big(char *s, const char *key, const char *value);
 qboolean Info_Validate(const char *s);
 void Info_NextPair(const char **s, char *key, char *value);
 
+// an info string split up once, so that many keys can be looked up without
+// rescanning it for each one
+#define MAX_INFO_PAIRS		(MAX_INFO_STRING / 2)
+
+typedef struct {
+	char string[MAX_INFO_STRING];	// the info string, NUL at each '\\'
+	int numPairs;
+	short keys[MAX_INFO_PAIRS];	// offsets into string
+	short values[MAX_INFO_PAIRS];
+	byte keyHashes[MAX_INFO_PAIRS];
+} infoIndex_t;
+
+qboolean Info_Parse(const char *s, infoIndex_t * index);
+const char *Info_IndexValue(const infoIndex_t * index, const char *key);
+
 // this is only here so the functions in q_shared.c and bg_*.c can link
 void QDECL Com_Error(int level, const char *error, ...)
     __attribute__((format(printf, 2, 3)));
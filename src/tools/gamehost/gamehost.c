@@ -0,0 +1,1993 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// gamehost.c -- headless host for load testing the native game module
+//
+// gamehost loads game.so (BUILD_GAME_SO=1) and answers its syscalls itself,
+// without an engine, a map or any real clients:
+//
+//  - files live in memory, read through from -fs <dir> if one is given
+//  - the world is the room of brushes in gh_world.c, and traces are swept
+//    boxes against that and the linked entities' bounds
+//  - the map is an entity string with an alien and a human base
+//  - fake clients connect, join a team and send usercmds from a seeded
+//    random walk, with builders picking buildables and placing them
+//  - a script can issue client and server commands on given frames
+//
+// It runs the requested number of server frames and reports percentiles of
+// how long each took.  The host itself does next to nothing, so that is
+// almost all time spent in the game.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <math.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <dlfcn.h>
+
+#include "q_shared.h"
+#include "bg_public.h"
+#include "g_public.h"
+#include "gh_local.h"
+
+#define GH_MAX_CVARS          1024
+#define GH_MAX_ARGS           64
+#define GH_MAX_HANDLES        64
+#define GH_MAX_SCRIPT         4096
+#define GH_CONSOLE_BUFFER     16384
+
+typedef intptr_t(*vmMain_t) (int command, int arg0, int arg1, int arg2,
+			     int arg3, int arg4, int arg5, int arg6, int arg7,
+			     int arg8, int arg9, int arg10, int arg11);
+typedef void (*dllEntry_t) (intptr_t(QDECL * syscallptr) (intptr_t arg,
+							   ...));
+
+typedef struct {
+	char *name;
+	char string[MAX_CVAR_VALUE_STRING];
+	char resetString[MAX_CVAR_VALUE_STRING];
+	int flags;
+	int modificationCount;
+} ghCvar_t;
+
+typedef struct ghFile_s {
+	char name[MAX_QPATH];
+	char *data;
+	int length;
+	int size;
+	struct ghFile_s *next;
+} ghFile_t;
+
+typedef struct {
+	ghFile_t *file;
+	int position;
+	qboolean written;
+} ghHandle_t;
+
+typedef struct {
+	qboolean active;
+	char userinfo[MAX_INFO_STRING];
+	usercmd_t cmd;
+	int cmdTime;
+	unsigned int seed;
+	int nextChange;
+	int turn;
+	int attackUntil;
+	qboolean builder;
+	int nextBuild;
+
+	int commands;
+	int commandBytes;
+} ghClient_t;
+
+typedef struct {
+	int frame;
+	char target[MAX_TOKEN_CHARS];
+	char text[MAX_STRING_CHARS];
+} ghScriptLine_t;
+
+static vmMain_t gameMain;
+
+static ghCvar_t cvars[GH_MAX_CVARS];
+static int numCvars;
+
+static int cmdArgc;
+static char *cmdArgv[GH_MAX_ARGS];
+static char cmdTokenized[BIG_INFO_STRING + GH_MAX_ARGS];
+
+static char *fsBasePath;
+static char *fsSavePath;
+static ghFile_t *files;
+static ghHandle_t handles[GH_MAX_HANDLES];
+
+static char *configstrings[MAX_CONFIGSTRINGS];
+
+static byte *gameEntities;
+static int numGameEntities;
+static int sizeofGameEntity;
+static byte *gameClients;
+static int sizeofGameClient;
+
+static char entityString[MAX_STRING_CHARS * 4];
+static char *entityParsePoint;
+
+static ghClient_t clients[MAX_CLIENTS];
+static int maxClients;
+
+static char consoleBuffer[GH_CONSOLE_BUFFER];
+static int consoleLength;
+
+static ghScriptLine_t script[GH_MAX_SCRIPT];
+static int numScript;
+
+static qboolean quiet;
+static int seed = 1;
+static double *frameTimes;
+
+static qboolean replaying;
+static int replayStartTime, replayEndTime;
+static struct timespec startTime;
+
+static int traces, pointContents, entitiesInBox;
+
+static const char *alienBuildables[] = {
+	"eggpod", "barricade", "booster", "acid_tube", "hive", "trapper"
+};
+
+static const char *humanBuildables[] = {
+	"telenode", "medistat", "mgturret", "tesla", "dcc", "arm", "repeater"
+};
+
+/*
+================
+Com_Error
+
+For q_shared.c
+================
+*/
+void QDECL Com_Error(int level, const char *error, ...)
+{
+	va_list argptr;
+
+	va_start(argptr, error);
+	fprintf(stderr, "gamehost: error: ");
+	vfprintf(stderr, error, argptr);
+	fprintf(stderr, "\n");
+	va_end(argptr);
+
+	exit(1);
+}
+
+/*
+================
+Com_Printf
+
+For q_shared.c
+================
+*/
+void QDECL Com_Printf(const char *msg, ...)
+{
+	va_list argptr;
+
+	va_start(argptr, msg);
+	vprintf(msg, argptr);
+	va_end(argptr);
+}
+
+/*
+================
+GH_Microseconds
+================
+*/
+static double GH_Microseconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - startTime.tv_sec) * 1000000.0 +
+	    (now.tv_nsec - startTime.tv_nsec) / 1000.0;
+}
+
+/*
+================
+GH_Random
+
+Same sequence on every platform, unlike rand()
+================
+*/
+static int GH_Random(unsigned int *seed, int range)
+{
+	*seed = *seed * 1103515245U + 12345U;
+
+	return (int)((*seed >> 16) % (unsigned int)range);
+}
+
+/*
+=============================================================================
+
+CVARS
+
+=============================================================================
+*/
+
+/*
+================
+GH_FindCvar
+================
+*/
+static ghCvar_t *GH_FindCvar(const char *name, qboolean create)
+{
+	int i;
+
+	for (i = 0; i < numCvars; i++) {
+		if (!Q_stricmp(cvars[i].name, name))
+			return &cvars[i];
+	}
+
+	if (!create)
+		return NULL;
+
+	if (numCvars == GH_MAX_CVARS)
+		Com_Error(ERR_FATAL, "too many cvars");
+
+	cvars[numCvars].name = strdup(name);
+	return &cvars[numCvars++];
+}
+
+/*
+================
+GH_CvarSet
+
+A NULL value resets the cvar to its default, as in the engine
+================
+*/
+static void GH_CvarSet(const char *name, const char *value)
+{
+	ghCvar_t *cvar = GH_FindCvar(name, qtrue);
+
+	if (!value)
+		value = cvar->resetString;
+
+	if (!strcmp(cvar->string, value) && cvar->modificationCount)
+		return;
+
+	Q_strncpyz(cvar->string, value, sizeof(cvar->string));
+	cvar->modificationCount++;
+}
+
+/*
+================
+GH_CvarUpdate
+================
+*/
+static void GH_CvarUpdate(vmCvar_t * vmCvar)
+{
+	ghCvar_t *cvar;
+
+	if (vmCvar->handle < 0 || vmCvar->handle >= numCvars)
+		return;
+
+	cvar = &cvars[vmCvar->handle];
+	if (vmCvar->modificationCount == cvar->modificationCount)
+		return;
+
+	vmCvar->modificationCount = cvar->modificationCount;
+	Q_strncpyz(vmCvar->string, cvar->string, sizeof(vmCvar->string));
+	vmCvar->value = atof(cvar->string);
+	vmCvar->integer = atoi(cvar->string);
+}
+
+/*
+================
+GH_CvarRegister
+================
+*/
+static void GH_CvarRegister(vmCvar_t * vmCvar, const char *name,
+			    const char *defaultValue, int flags)
+{
+	ghCvar_t *cvar = GH_FindCvar(name, qfalse);
+
+	if (!cvar) {
+		cvar = GH_FindCvar(name, qtrue);
+		Q_strncpyz(cvar->string, defaultValue, sizeof(cvar->string));
+		cvar->modificationCount = 1;
+	}
+	if (!cvar->resetString[0])
+		Q_strncpyz(cvar->resetString, defaultValue,
+			   sizeof(cvar->resetString));
+	cvar->flags |= flags;
+
+	if (vmCvar) {
+		vmCvar->handle = cvar - cvars;
+		vmCvar->modificationCount = -1;
+		GH_CvarUpdate(vmCvar);
+	}
+}
+
+/*
+================
+GH_CvarString
+================
+*/
+static const char *GH_CvarString(const char *name)
+{
+	ghCvar_t *cvar = GH_FindCvar(name, qfalse);
+
+	return cvar ? cvar->string : "";
+}
+
+/*
+================
+GH_Serverinfo
+================
+*/
+static void GH_Serverinfo(char *buffer, int size)
+{
+	char info[MAX_INFO_STRING];
+	int i;
+
+	info[0] = '\0';
+	for (i = 0; i < numCvars; i++) {
+		if (cvars[i].flags & CVAR_SERVERINFO)
+			Info_SetValueForKey(info, cvars[i].name,
+					    cvars[i].string);
+	}
+
+	Q_strncpyz(buffer, info, size);
+}
+
+/*
+=============================================================================
+
+COMMANDS
+
+=============================================================================
+*/
+
+/*
+================
+GH_TokenizeString
+
+The same rules as the engine: whitespace separates arguments, quotes group
+them and // starts a comment
+================
+*/
+static void GH_TokenizeString(const char *text)
+{
+	char *out = cmdTokenized;
+	char *end = cmdTokenized + sizeof(cmdTokenized) - 1;
+
+	cmdArgc = 0;
+
+	while (cmdArgc < GH_MAX_ARGS) {
+		while (*text && *text <= ' ')
+			text++;
+		if (!*text || (text[0] == '/' && text[1] == '/'))
+			return;
+
+		cmdArgv[cmdArgc++] = out;
+
+		if (*text == '"') {
+			text++;
+			while (*text && *text != '"' && out < end)
+				*out++ = *text++;
+			if (*text == '"')
+				text++;
+		} else {
+			while (*text > ' ' && out < end)
+				*out++ = *text++;
+		}
+
+		*out++ = '\0';
+		if (out >= end)
+			return;
+	}
+}
+
+/*
+================
+GH_ClientCommand
+================
+*/
+static void GH_ClientCommand(int clientNum, const char *text)
+{
+	if (!clients[clientNum].active)
+		return;
+
+	GH_TokenizeString(text);
+	gameMain(GAME_CLIENT_COMMAND, clientNum, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		 0);
+}
+
+/*
+================
+GH_SendConsoleCommand
+
+Add text to be run once the game returns, like Cbuf_AddText
+================
+*/
+static void GH_SendConsoleCommand(const char *text)
+{
+	if (consoleLength + strlen(text) + 1 >= GH_CONSOLE_BUFFER)
+		Com_Error(ERR_FATAL, "console buffer overflow");
+
+	Q_strcat(consoleBuffer, GH_CONSOLE_BUFFER, text);
+	Q_strcat(consoleBuffer, GH_CONSOLE_BUFFER, "\n");
+	consoleLength = strlen(consoleBuffer);
+}
+
+/*
+================
+GH_ServerCommand
+================
+*/
+static void GH_ServerCommand(const char *text)
+{
+	int i;
+
+	GH_TokenizeString(text);
+	if (!cmdArgc)
+		return;
+
+	if (!Q_stricmp(cmdArgv[0], "set") || !Q_stricmp(cmdArgv[0], "seta")) {
+		if (cmdArgc > 2)
+			GH_CvarSet(cmdArgv[1], cmdArgv[2]);
+		return;
+	}
+
+	// whatever else reached the game is in the recording already
+	if (replaying)
+		return;
+
+	// Schachtmeister asks the engine to rate addresses, rate them all clean
+	if (!Q_stricmp(cmdArgv[0], "smq")) {
+		if (cmdArgc > 2 && !Q_stricmp(cmdArgv[1], "ipa")) {
+			for (i = 2; i < cmdArgc; i++)
+				GH_SendConsoleCommand(va("smr ipa %s 0\n",
+							 cmdArgv[i]));
+		}
+		return;
+	}
+
+	if (!gameMain(GAME_CONSOLE_COMMAND, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+	    && !quiet)
+		printf("gamehost: ignored engine command %s\n", cmdArgv[0]);
+}
+
+/*
+================
+GH_ExecuteConsoleBuffer
+
+Run what the game added with trap_SendConsoleCommand
+================
+*/
+static void GH_ExecuteConsoleBuffer(void)
+{
+	char text[GH_CONSOLE_BUFFER];
+	char *s, *line;
+
+	while (consoleLength) {
+		memcpy(text, consoleBuffer, consoleLength + 1);
+		consoleLength = 0;
+		consoleBuffer[0] = '\0';
+
+		for (line = s = text; *s; line = s) {
+			while (*s && *s != '\n' && *s != ';')
+				s++;
+			if (*s)
+				*s++ = '\0';
+
+			GH_ServerCommand(line);
+		}
+	}
+}
+
+/*
+=============================================================================
+
+FILES
+
+=============================================================================
+*/
+
+/*
+================
+GH_LoadFile
+
+Find a file in memory, or read it in from the base path
+================
+*/
+static ghFile_t *GH_LoadFile(const char *name, qboolean create)
+{
+	ghFile_t *file;
+	FILE *f;
+	char path[MAX_OSPATH];
+	long length;
+
+	for (file = files; file; file = file->next) {
+		if (!Q_stricmp(file->name, name))
+			return file;
+	}
+
+	f = NULL;
+	if (fsBasePath) {
+		Com_sprintf(path, sizeof(path), "%s/%s", fsBasePath, name);
+		f = fopen(path, "rb");
+	}
+	if (!f && !create)
+		return NULL;
+
+	file = calloc(1, sizeof(*file));
+	Q_strncpyz(file->name, name, sizeof(file->name));
+	file->next = files;
+	files = file;
+
+	if (f) {
+		fseek(f, 0, SEEK_END);
+		length = ftell(f);
+		fseek(f, 0, SEEK_SET);
+
+		file->data = malloc(length + 1);
+		file->size = length + 1;
+		file->length = fread(file->data, 1, length, f);
+		fclose(f);
+	}
+
+	return file;
+}
+
+/*
+================
+GH_FOpenFile
+================
+*/
+static int GH_FOpenFile(const char *name, fileHandle_t * f, fsMode_t mode)
+{
+	ghFile_t *file;
+	int i;
+
+	file = GH_LoadFile(name, mode != FS_READ);
+
+	if (!f)
+		return file ? file->length : 0;
+
+	*f = 0;
+	if (!file)
+		return -1;
+
+	for (i = 1; i < GH_MAX_HANDLES; i++) {
+		if (!handles[i].file)
+			break;
+	}
+	if (i == GH_MAX_HANDLES)
+		return -1;
+
+	if (mode == FS_WRITE)
+		file->length = 0;
+
+	handles[i].file = file;
+	handles[i].position = (mode == FS_READ) ? 0 : file->length;
+	*f = i;
+
+	return file->length;
+}
+
+/*
+================
+GH_Handle
+================
+*/
+static ghHandle_t *GH_Handle(fileHandle_t f)
+{
+	if (f <= 0 || f >= GH_MAX_HANDLES || !handles[f].file)
+		return NULL;
+
+	return &handles[f];
+}
+
+/*
+================
+GH_FRead
+================
+*/
+static int GH_FRead(void *buffer, int length, fileHandle_t f)
+{
+	ghHandle_t *handle = GH_Handle(f);
+
+	if (!handle)
+		return 0;
+
+	if (length > handle->file->length - handle->position)
+		length = handle->file->length - handle->position;
+	if (length <= 0)
+		return 0;
+
+	memcpy(buffer, handle->file->data + handle->position, length);
+	handle->position += length;
+
+	return length;
+}
+
+/*
+================
+GH_FWrite
+================
+*/
+static int GH_FWrite(const void *buffer, int length, fileHandle_t f)
+{
+	ghHandle_t *handle = GH_Handle(f);
+	ghFile_t *file;
+
+	if (!handle || length <= 0)
+		return 0;
+
+	file = handle->file;
+	if (handle->position + length > file->size) {
+		file->size = (handle->position + length) * 2;
+		file->data = realloc(file->data, file->size);
+	}
+
+	memcpy(file->data + handle->position, buffer, length);
+	handle->position += length;
+	if (handle->position > file->length)
+		file->length = handle->position;
+	handle->written = qtrue;
+
+	return length;
+}
+
+/*
+================
+GH_FCloseFile
+
+Files the game wrote are kept in memory, and saved under the save path too
+if there is one
+================
+*/
+static void GH_FCloseFile(fileHandle_t f)
+{
+	ghHandle_t *handle = GH_Handle(f);
+	char path[MAX_OSPATH];
+	char *s;
+	FILE *out;
+
+	if (!handle)
+		return;
+
+	if (handle->written && fsSavePath) {
+		Com_sprintf(path, sizeof(path), "%s/%s", fsSavePath,
+			    handle->file->name);
+
+		for (s = path + strlen(fsSavePath) + 1; *s; s++) {
+			if (*s == '/') {
+				*s = '\0';
+				mkdir(path, 0755);
+				*s = '/';
+			}
+		}
+
+		if ((out = fopen(path, "wb"))) {
+			fwrite(handle->file->data, 1, handle->file->length,
+			       out);
+			fclose(out);
+		} else
+			printf("gamehost: couldn't save %s\n", path);
+	}
+
+	handle->file = NULL;
+	handle->written = qfalse;
+}
+
+/*
+================
+GH_FSeek
+================
+*/
+static int GH_FSeek(fileHandle_t f, long offset, int origin)
+{
+	ghHandle_t *handle = GH_Handle(f);
+
+	if (!handle)
+		return -1;
+
+	switch (origin) {
+	case FS_SEEK_CUR:
+		offset += handle->position;
+		break;
+	case FS_SEEK_END:
+		offset += handle->file->length;
+		break;
+	}
+
+	if (offset < 0 || offset > handle->file->length)
+		return -1;
+
+	handle->position = offset;
+	return 0;
+}
+
+/*
+================
+GH_ListFileName
+
+Add name to a NUL separated file list unless it is already in it
+================
+*/
+static void GH_ListFileName(const char *name, char *list, int size,
+			    int *length, int *count)
+{
+	const char *s;
+	int n = strlen(name) + 1;
+
+	for (s = list; s < list + *length; s += strlen(s) + 1) {
+		if (!Q_stricmp(s, name))
+			return;
+	}
+
+	if (*length + n > size)
+		return;
+
+	memcpy(list + *length, name, n);
+	*length += n;
+	(*count)++;
+}
+
+/*
+================
+GH_ExtensionMatches
+================
+*/
+static qboolean GH_ExtensionMatches(const char *name, const char *extension)
+{
+	int n = strlen(name), e = strlen(extension);
+
+	return n >= e && !Q_stricmp(name + n - e, extension);
+}
+
+/*
+================
+GH_GetFileList
+================
+*/
+static int GH_GetFileList(const char *path, const char *extension, char *list,
+			  int size)
+{
+	ghFile_t *file;
+	DIR *dir;
+	struct dirent *entry;
+	char osPath[MAX_OSPATH];
+	int pathLength = strlen(path);
+	int length = 0, count = 0;
+
+	for (file = files; file; file = file->next) {
+		if (Q_stricmpn(file->name, path, pathLength) ||
+		    file->name[pathLength] != '/' ||
+		    strchr(file->name + pathLength + 1, '/') ||
+		    !GH_ExtensionMatches(file->name, extension))
+			continue;
+
+		GH_ListFileName(file->name + pathLength + 1, list, size,
+				&length, &count);
+	}
+
+	if (fsBasePath) {
+		Com_sprintf(osPath, sizeof(osPath), "%s/%s", fsBasePath, path);
+		if ((dir = opendir(osPath))) {
+			while ((entry = readdir(dir))) {
+				if (entry->d_name[0] == '.' ||
+				    !GH_ExtensionMatches(entry->d_name,
+							 extension))
+					continue;
+
+				GH_ListFileName(entry->d_name, list, size,
+						&length, &count);
+			}
+			closedir(dir);
+		}
+	}
+
+	return count;
+}
+
+/*
+=============================================================================
+
+WORLD
+
+=============================================================================
+*/
+
+/*
+================
+GH_AddEntity
+================
+*/
+static void GH_AddEntity(const char *fmt, ...)
+{
+	va_list argptr;
+	int length = strlen(entityString);
+
+	va_start(argptr, fmt);
+	vsnprintf(entityString + length, sizeof(entityString) - length, fmt,
+		  argptr);
+	va_end(argptr);
+}
+
+/*
+================
+GH_BuildEntityString
+
+worldspawn, intermission points and a base for each team at either end of
+the room
+================
+*/
+static void GH_BuildEntityString(float size)
+{
+	int base = size * 0.75f;
+	int i;
+
+	entityString[0] = '\0';
+
+	GH_AddEntity("{\n\"classname\" \"worldspawn\"\n"
+		     "\"message\" \"gamehost\"\n}\n");
+	GH_AddEntity("{\n\"classname\" \"info_player_intermission\"\n"
+		     "\"origin\" \"0 0 %d\"\n\"angles\" \"45 0 0\"\n}\n", base);
+	GH_AddEntity("{\n\"classname\" \"info_alien_intermission\"\n"
+		     "\"origin\" \"%d 0 128\"\n}\n", -base);
+	GH_AddEntity("{\n\"classname\" \"info_human_intermission\"\n"
+		     "\"origin\" \"%d 0 128\"\n}\n", base);
+
+	GH_AddEntity("{\n\"classname\" \"team_alien_overmind\"\n"
+		     "\"origin\" \"%d 0 64\"\n}\n", -base);
+	GH_AddEntity("{\n\"classname\" \"team_human_reactor\"\n"
+		     "\"origin\" \"%d 0 64\"\n}\n", base);
+
+	for (i = 0; i < 4; i++) {
+		GH_AddEntity("{\n\"classname\" \"team_alien_spawn\"\n"
+			     "\"origin\" \"%d %d 32\"\n}\n", -base + 128,
+			     (i - 2) * 128 + 64);
+		GH_AddEntity("{\n\"classname\" \"team_human_spawn\"\n"
+			     "\"origin\" \"%d %d 32\"\n}\n", base - 128,
+			     (i - 2) * 128 + 64);
+	}
+
+	entityParsePoint = entityString;
+}
+
+/*
+================
+GH_Entity
+================
+*/
+static sharedEntity_t *GH_Entity(int num)
+{
+	return (sharedEntity_t *) (gameEntities + num * sizeofGameEntity);
+}
+
+/*
+================
+GH_LinkEntity
+================
+*/
+static void GH_LinkEntity(sharedEntity_t * ent)
+{
+	VectorAdd(ent->r.currentOrigin, ent->r.mins, ent->r.absmin);
+	VectorAdd(ent->r.currentOrigin, ent->r.maxs, ent->r.absmax);
+
+	// just like the engine, so that touching items get triggered
+	ent->r.absmin[0] -= 1;
+	ent->r.absmin[1] -= 1;
+	ent->r.absmin[2] -= 1;
+	ent->r.absmax[0] += 1;
+	ent->r.absmax[1] += 1;
+	ent->r.absmax[2] += 1;
+
+	ent->r.linked = qtrue;
+	ent->r.linkcount++;
+}
+
+/*
+================
+GH_BoxesOverlap
+================
+*/
+static qboolean GH_BoxesOverlap(const vec3_t mins1, const vec3_t maxs1,
+				const vec3_t mins2, const vec3_t maxs2)
+{
+	return mins1[0] <= maxs2[0] && mins1[1] <= maxs2[1] &&
+	    mins1[2] <= maxs2[2] && maxs1[0] >= mins2[0] &&
+	    maxs1[1] >= mins2[1] && maxs1[2] >= mins2[2];
+}
+
+/*
+================
+GH_EntitiesInBox
+================
+*/
+static int GH_EntitiesInBox(const vec3_t mins, const vec3_t maxs, int *list,
+			    int maxCount)
+{
+	sharedEntity_t *ent;
+	int i, count = 0;
+
+	entitiesInBox++;
+
+	for (i = 0; i < numGameEntities && count < maxCount; i++) {
+		ent = GH_Entity(i);
+		if (!ent->r.linked)
+			continue;
+
+		if (GH_BoxesOverlap(mins, maxs, ent->r.absmin, ent->r.absmax))
+			list[count++] = i;
+	}
+
+	return count;
+}
+
+/*
+================
+GH_Trace
+================
+*/
+static void GH_Trace(trace_t * trace, const vec3_t start, const vec3_t mins,
+		     const vec3_t maxs, const vec3_t end, int passEntityNum,
+		     int contentMask)
+{
+	sharedEntity_t *ent;
+	ghBrush_t brush;
+	vec3_t sweepMins, sweepMaxs, boxMins, boxMaxs;
+	int i, passOwnerNum;
+
+	traces++;
+
+	if (!mins)
+		mins = vec3_origin;
+	if (!maxs)
+		maxs = vec3_origin;
+
+	GH_WorldTrace(trace, start, mins, maxs, end, contentMask);
+
+	for (i = 0; i < 3; i++) {
+		sweepMins[i] = MIN(start[i], end[i]) + mins[i] - 1.0f;
+		sweepMaxs[i] = MAX(start[i], end[i]) + maxs[i] + 1.0f;
+	}
+
+	passOwnerNum = -1;
+	if (passEntityNum >= 0 && passEntityNum < numGameEntities) {
+		passOwnerNum = GH_Entity(passEntityNum)->r.ownerNum;
+		if (passOwnerNum == ENTITYNUM_NONE)
+			passOwnerNum = -1;
+	}
+
+	for (i = 0; i < numGameEntities; i++) {
+		ent = GH_Entity(i);
+		if (!ent->r.linked || !(ent->r.contents & contentMask))
+			continue;
+
+		if (passEntityNum != ENTITYNUM_NONE &&
+		    (i == passEntityNum || ent->r.ownerNum == passEntityNum ||
+		     ent->r.ownerNum == passOwnerNum))
+			continue;
+
+		if (!GH_BoxesOverlap(sweepMins, sweepMaxs, ent->r.absmin,
+				     ent->r.absmax))
+			continue;
+
+		VectorAdd(ent->r.currentOrigin, ent->r.mins, boxMins);
+		VectorAdd(ent->r.currentOrigin, ent->r.maxs, boxMaxs);
+		GH_BoxBrush(&brush, boxMins, boxMaxs, ent->r.contents, 0);
+		GH_ClipToBrush(trace, start, end, mins, maxs, &brush, i);
+	}
+
+	for (i = 0; i < 3; i++)
+		trace->endpos[i] = start[i] + trace->fraction *
+		    (end[i] - start[i]);
+}
+
+/*
+================
+GH_PointContents
+================
+*/
+static int GH_PointContents(const vec3_t point, int passEntityNum)
+{
+	sharedEntity_t *ent;
+	int i, contents;
+
+	pointContents++;
+
+	contents = GH_WorldContents(point);
+
+	for (i = 0; i < numGameEntities; i++) {
+		ent = GH_Entity(i);
+		if (i == passEntityNum || !ent->r.linked)
+			continue;
+
+		if (GH_BoxesOverlap(point, point, ent->r.absmin, ent->r.absmax))
+			contents |= ent->r.contents;
+	}
+
+	return contents;
+}
+
+/*
+=============================================================================
+
+SYSCALLS
+
+=============================================================================
+*/
+
+/*
+================
+GH_DropClient
+================
+*/
+static void GH_DropClient(int clientNum, const char *reason)
+{
+	if (clientNum < 0 || clientNum >= maxClients ||
+	    !clients[clientNum].active)
+		return;
+
+	if (!quiet)
+		printf("gamehost: dropped client %d: %s\n", clientNum, reason);
+
+	gameMain(GAME_CLIENT_DISCONNECT, clientNum, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		 0, 0);
+	clients[clientNum].active = qfalse;
+}
+
+/*
+================
+GH_ServerCommandSent
+================
+*/
+static void GH_ServerCommandSent(int clientNum, const char *text)
+{
+	int i;
+
+	if (clientNum >= 0) {
+		if (clientNum < maxClients) {
+			clients[clientNum].commands++;
+			clients[clientNum].commandBytes += strlen(text);
+		}
+		return;
+	}
+
+	for (i = 0; i < maxClients; i++) {
+		if (clients[i].active)
+			GH_ServerCommandSent(i, text);
+	}
+}
+
+/*
+================
+GH_Syscall
+
+What the engine's SV_GameSystemCalls does, as far as the game can tell
+================
+*/
+static intptr_t QDECL GH_Syscall(intptr_t command, ...)
+{
+	intptr_t args[12];
+	va_list argptr;
+	struct tm *local;
+	time_t now;
+	int i;
+
+	va_start(argptr, command);
+	for (i = 0; i < 12; i++)
+		args[i] = va_arg(argptr, intptr_t);
+	va_end(argptr);
+
+#define VMA(x) ((void *)args[x])
+
+	switch (command) {
+	case G_PRINT:
+		if (!quiet)
+			printf("%s", (const char *)VMA(0));
+		return 0;
+	case G_ERROR:
+		Com_Error(ERR_DROP, "%s", (const char *)VMA(0));
+		return 0;
+	case G_MILLISECONDS:
+		return (int)(GH_Microseconds() / 1000.0);
+	case G_CVAR_REGISTER:
+		GH_CvarRegister(VMA(0), VMA(1), VMA(2), args[3]);
+		return 0;
+	case G_CVAR_UPDATE:
+		GH_CvarUpdate(VMA(0));
+		return 0;
+	case G_CVAR_SET:
+		GH_CvarSet(VMA(0), VMA(1));
+		return 0;
+	case G_CVAR_VARIABLE_INTEGER_VALUE:
+		return atoi(GH_CvarString(VMA(0)));
+	case G_CVAR_VARIABLE_STRING_BUFFER:
+		Q_strncpyz(VMA(1), GH_CvarString(VMA(0)), args[2]);
+		return 0;
+	case G_ARGC:
+		return cmdArgc;
+	case G_ARGV:
+		Q_strncpyz(VMA(1), (args[0] >= 0 && args[0] < cmdArgc) ?
+			   cmdArgv[args[0]] : "", args[2]);
+		return 0;
+	case G_SEND_CONSOLE_COMMAND:
+		GH_SendConsoleCommand(VMA(1));
+		return 0;
+	case G_FS_FOPEN_FILE:
+		return GH_FOpenFile(VMA(0), VMA(1), args[2]);
+	case G_FS_READ:
+		GH_FRead(VMA(0), args[1], args[2]);
+		return 0;
+	case G_FS_WRITE:
+		GH_FWrite(VMA(0), args[1], args[2]);
+		return 0;
+	case G_FS_FCLOSE_FILE:
+		GH_FCloseFile(args[0]);
+		return 0;
+	case G_FS_GETFILELIST:
+		return GH_GetFileList(VMA(0), VMA(1), VMA(2), args[3]);
+	case G_FS_SEEK:
+		return GH_FSeek(args[0], args[1], args[2]);
+	case G_LOCATE_GAME_DATA:
+		gameEntities = VMA(0);
+		numGameEntities = args[1];
+		sizeofGameEntity = args[2];
+		gameClients = VMA(3);
+		sizeofGameClient = args[4];
+		return 0;
+	case G_DROP_CLIENT:
+		GH_DropClient(args[0], VMA(1));
+		return 0;
+	case G_SEND_SERVER_COMMAND:
+		GH_ServerCommandSent(args[0], VMA(1));
+		return 0;
+	case G_SET_CONFIGSTRING:
+		if (args[0] < 0 || args[0] >= MAX_CONFIGSTRINGS)
+			Com_Error(ERR_DROP, "bad configstring %d",
+				  (int)args[0]);
+		free(configstrings[args[0]]);
+		configstrings[args[0]] = strdup(VMA(1));
+		return 0;
+	case G_GET_CONFIGSTRING:
+		Q_strncpyz(VMA(1), (args[0] >= 0 && args[0] < MAX_CONFIGSTRINGS
+				    && configstrings[args[0]]) ?
+			   configstrings[args[0]] : "", args[2]);
+		return 0;
+	case G_SET_CONFIGSTRING_RESTRICTIONS:
+		return 0;
+	case G_GET_USERINFO:
+		Q_strncpyz(VMA(1), (args[0] >= 0 && args[0] < MAX_CLIENTS) ?
+			   clients[args[0]].userinfo : "", args[2]);
+		return 0;
+	case G_SET_USERINFO:
+		if (args[0] >= 0 && args[0] < MAX_CLIENTS)
+			Q_strncpyz(clients[args[0]].userinfo, VMA(1),
+				   sizeof(clients[0].userinfo));
+		return 0;
+	case G_GET_SERVERINFO:
+		GH_Serverinfo(VMA(0), args[1]);
+		return 0;
+	case G_SET_BRUSH_MODEL:
+		// there are no inline models, so brush entities have no size
+		((sharedEntity_t *) VMA(0))->r.bmodel = qtrue;
+		return 0;
+	case G_TRACE:
+	case G_TRACECAPSULE:
+		GH_Trace(VMA(0), VMA(1), VMA(2), VMA(3), VMA(4), args[5],
+			 args[6]);
+		return 0;
+	case G_POINT_CONTENTS:
+		return GH_PointContents(VMA(0), args[1]);
+	case G_IN_PVS:
+	case G_IN_PVS_IGNORE_PORTALS:
+	case G_AREAS_CONNECTED:
+		return qtrue;
+	case G_ADJUST_AREA_PORTAL_STATE:
+		return 0;
+	case G_LINKENTITY:
+		GH_LinkEntity(VMA(0));
+		return 0;
+	case G_UNLINKENTITY:
+		((sharedEntity_t *) VMA(0))->r.linked = qfalse;
+		return 0;
+	case G_ENTITIES_IN_BOX:
+		return GH_EntitiesInBox(VMA(0), VMA(1), VMA(2), args[3]);
+	case G_ENTITY_CONTACT:
+	case G_ENTITY_CONTACTCAPSULE:
+		return GH_BoxesOverlap(VMA(0), VMA(1),
+				       ((sharedEntity_t *) VMA(2))->r.absmin,
+				       ((sharedEntity_t *) VMA(2))->r.absmax);
+	case G_GET_USERCMD:
+		if (args[0] >= 0 && args[0] < MAX_CLIENTS)
+			*(usercmd_t *) VMA(1) = clients[args[0]].cmd;
+		return 0;
+	case G_GET_ENTITY_TOKEN:
+		{
+			const char *s = COM_Parse(&entityParsePoint);
+
+			Q_strncpyz(VMA(0), s, args[1]);
+			return entityParsePoint || s[0];
+		}
+	case G_REAL_TIME:
+		now = time(NULL);
+		if (VMA(0)) {
+			local = localtime(&now);
+			memset(VMA(0), 0, sizeof(qtime_t));
+			((qtime_t *) VMA(0))->tm_sec = local->tm_sec;
+			((qtime_t *) VMA(0))->tm_min = local->tm_min;
+			((qtime_t *) VMA(0))->tm_hour = local->tm_hour;
+			((qtime_t *) VMA(0))->tm_mday = local->tm_mday;
+			((qtime_t *) VMA(0))->tm_mon = local->tm_mon;
+			((qtime_t *) VMA(0))->tm_year = local->tm_year;
+			((qtime_t *) VMA(0))->tm_wday = local->tm_wday;
+			((qtime_t *) VMA(0))->tm_yday = local->tm_yday;
+			((qtime_t *) VMA(0))->tm_isdst = local->tm_isdst;
+		}
+		return now;
+	case G_SNAPVECTOR:
+		for (i = 0; i < 3; i++)
+			((float *)VMA(0))[i] = rint(((float *)VMA(0))[i]);
+		return 0;
+	case G_PARSE_ADD_GLOBAL_DEFINE:
+	case G_PARSE_LOAD_SOURCE:
+	case G_PARSE_FREE_SOURCE:
+	case G_PARSE_READ_TOKEN:
+	case G_PARSE_SOURCE_FILE_AND_LINE:
+	case G_SEND_GAMESTAT:
+	case G_ADDCOMMAND:
+	case G_REMOVECOMMAND:
+		return 0;
+	}
+
+#undef VMA
+
+	Com_Error(ERR_DROP, "bad game system trap: %d", (int)command);
+	return 0;
+}
+
+/*
+=============================================================================
+
+CLIENTS
+
+=============================================================================
+*/
+
+/*
+================
+GH_PlayerState
+================
+*/
+static playerState_t *GH_PlayerState(int clientNum)
+{
+	return (playerState_t *) (gameClients + clientNum * sizeofGameClient);
+}
+
+/*
+================
+GH_TeamClass
+
+What a client picks from the class menu
+================
+*/
+static const char *GH_TeamClass(int clientNum)
+{
+	if (clientNum & 1)
+		return clients[clientNum].builder ? "ckit" : "rifle";
+
+	return clients[clientNum].builder ? "builder" : "level0";
+}
+
+/*
+================
+GH_ConnectClient
+================
+*/
+static void GH_ConnectClient(int clientNum, int builders)
+{
+	ghClient_t *client = &clients[clientNum];
+	const char *reason;
+	char *info = client->userinfo;
+
+	memset(client, 0, sizeof(*client));
+	client->seed = clientNum * 7919 + seed;
+	client->builder = (clientNum / 2) < builders;
+
+	Info_SetValueForKey(info, "name", va("gamehost%d", clientNum));
+	Info_SetValueForKey(info, "ip", va("10.%d.%d.%d:27960",
+					   clientNum / 65536 % 256,
+					   clientNum / 256 % 256,
+					   clientNum % 256 + 1));
+	Info_SetValueForKey(info, "cl_guid",
+			    va("%08X%08X%08X%08X", 0x6A6E6F73, clientNum,
+			       0x686F7374, clientNum));
+	Info_SetValueForKey(info, "rate", "25000");
+	Info_SetValueForKey(info, "snaps", "20");
+
+	reason = (const char *)gameMain(GAME_CLIENT_CONNECT, clientNum, qtrue,
+					0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	if (reason) {
+		printf("gamehost: client %d refused: %s\n", clientNum, reason);
+		return;
+	}
+
+	client->active = qtrue;
+	gameMain(GAME_CLIENT_BEGIN, clientNum, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
+/*
+================
+GH_NextCommand
+
+Step a client's usercmd on to serverTime.  Movement keys change every
+quarter to one second of play and the view keeps turning.  Builders look
+down at the floor and keep attack held while they are placing something.
+================
+*/
+static void GH_NextCommand(ghClient_t * client, int serverTime)
+{
+	static const signed char moves[3] = { -127, 0, 127 };
+	usercmd_t *cmd = &client->cmd;
+
+	cmd->serverTime = serverTime;
+
+	if (serverTime >= client->nextChange) {
+		client->nextChange = serverTime + 250 +
+		    GH_Random(&client->seed, 750);
+
+		cmd->forwardmove = moves[GH_Random(&client->seed, 3)];
+		cmd->rightmove = moves[GH_Random(&client->seed, 3)];
+
+		switch (GH_Random(&client->seed, 4)) {
+		case 0:
+			cmd->upmove = 127;
+			break;
+		case 1:
+			cmd->upmove = -127;
+			break;
+		default:
+			cmd->upmove = 0;
+			break;
+		}
+
+		cmd->buttons = 0;
+		if (!client->builder && !GH_Random(&client->seed, 2))
+			cmd->buttons |= BUTTON_ATTACK;
+
+		client->turn = GH_Random(&client->seed, 1024) - 512;
+		cmd->angles[PITCH] = ANGLE2SHORT(client->builder ? 30 :
+						 GH_Random(&client->seed,
+							   60) - 30);
+	}
+
+	if (client->builder) {
+		if (serverTime < client->attackUntil) {
+			cmd->buttons |= BUTTON_ATTACK;
+			cmd->forwardmove = cmd->rightmove = cmd->upmove = 0;
+		} else
+			cmd->buttons &= ~BUTTON_ATTACK;
+	}
+
+	cmd->angles[YAW] = (cmd->angles[YAW] + client->turn) & 65535;
+}
+
+/*
+================
+GH_ScenarioCommands
+
+Once a second, get clients onto their team and back into the game when they
+die.  Keep the builders building.
+================
+*/
+static void GH_ScenarioCommands(int clientNum, int frame, int fps,
+				int levelTime)
+{
+	ghClient_t *client = &clients[clientNum];
+	playerState_t *ps = GH_PlayerState(clientNum);
+	const char *name;
+
+	if ((frame + clientNum) % fps == 0) {
+		if (ps->pm_type == PM_DEAD)
+			client->cmd.buttons |= BUTTON_ATTACK;
+		else if (ps->stats[STAT_PTEAM] == PTE_NONE)
+			GH_ClientCommand(clientNum, (clientNum & 1) ?
+					 "team humans" : "team aliens");
+		else if (ps->stats[STAT_PCLASS] == PCL_NONE &&
+			 !(ps->pm_flags & PMF_QUEUED))
+			GH_ClientCommand(clientNum,
+					 va("class %s",
+					    GH_TeamClass(clientNum)));
+	}
+
+	if (!client->builder || levelTime < client->nextBuild ||
+	    ps->pm_type != PM_NORMAL)
+		return;
+
+	client->nextBuild = levelTime + 1000 + GH_Random(&client->seed, 2000);
+
+	if (clientNum & 1)
+		name = humanBuildables[GH_Random(&client->seed,
+						 sizeof(humanBuildables) /
+						 sizeof(humanBuildables[0]))];
+	else
+		name = alienBuildables[GH_Random(&client->seed,
+						 sizeof(alienBuildables) /
+						 sizeof(alienBuildables[0]))];
+
+	GH_ClientCommand(clientNum, va("build %s", name));
+	client->attackUntil = levelTime + 500;
+}
+
+/*
+=============================================================================
+
+SCRIPT
+
+=============================================================================
+*/
+
+/*
+================
+GH_LoadScript
+
+Each line is a frame number, who runs the command, and the command.  Who is
+a client number, "all", "aliens", "humans" or "server".
+================
+*/
+static void GH_LoadScript(const char *path)
+{
+	FILE *f;
+	char line[MAX_STRING_CHARS * 2];
+	char *s, *token;
+	ghScriptLine_t *entry;
+
+	if (!(f = fopen(path, "r")))
+		Com_Error(ERR_FATAL, "couldn't open script %s", path);
+
+	while (fgets(line, sizeof(line), f) && numScript < GH_MAX_SCRIPT) {
+		s = line;
+		token = COM_Parse(&s);
+		if (!token[0] || token[0] == '#')
+			continue;
+
+		entry = &script[numScript];
+		entry->frame = atoi(token);
+		Q_strncpyz(entry->target, COM_Parse(&s),
+			   sizeof(entry->target));
+
+		if (!s)
+			continue;
+		while (*s == ' ' || *s == '\t')
+			s++;
+		Q_strncpyz(entry->text, s, sizeof(entry->text));
+		s = entry->text + strlen(entry->text);
+		while (s > entry->text && (s[-1] == '\n' || s[-1] == '\r'))
+			*--s = '\0';
+
+		if (entry->target[0] && entry->text[0])
+			numScript++;
+	}
+
+	fclose(f);
+}
+
+/*
+================
+GH_RunScript
+================
+*/
+static void GH_RunScript(int frame)
+{
+	ghScriptLine_t *entry;
+	int i, j;
+
+	for (i = 0, entry = script; i < numScript; i++, entry++) {
+		if (entry->frame != frame)
+			continue;
+
+		if (!Q_stricmp(entry->target, "server")) {
+			GH_ServerCommand(entry->text);
+			continue;
+		}
+
+		for (j = 0; j < maxClients; j++) {
+			if (!Q_stricmp(entry->target, "all") ||
+			    (!Q_stricmp(entry->target, "aliens") && !(j & 1)) ||
+			    (!Q_stricmp(entry->target, "humans") && (j & 1)) ||
+			    (isdigit((unsigned char)entry->target[0]) &&
+			     atoi(entry->target) == j))
+				GH_ClientCommand(j, entry->text);
+		}
+	}
+}
+
+/*
+=============================================================================
+
+MAIN
+
+=============================================================================
+*/
+
+/*
+================
+GH_StartGame
+
+What SV_SpawnServer does: init the game and let it settle
+================
+*/
+static void GH_StartGame(float size, int levelTime, int randomSeed,
+			 int restart)
+{
+	int i;
+
+	GH_CvarSet("sv_maxclients", va("%d", maxClients));
+	GH_CvarSet("mapname", "gamehost");
+	GH_CvarSet("dedicated", "2");
+	GH_CvarRegister(NULL, "sv_maxclients", "", CVAR_SERVERINFO);
+	GH_CvarRegister(NULL, "mapname", "", CVAR_SERVERINFO);
+
+	GH_BuildWorld(size);
+	GH_BuildEntityString(size);
+
+	gameMain(GAME_INIT, levelTime, randomSeed, restart, 0, 0, 0, 0, 0, 0, 0,
+		 0, 0);
+
+	// a recording already has the frames that followed
+	if (replaying)
+		return;
+
+	for (i = 0; i < 3; i++) {
+		levelTime += 100;
+		gameMain(GAME_RUN_FRAME, levelTime, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			 0, 0);
+		GH_ExecuteConsoleBuffer();
+	}
+}
+
+/*
+================
+GH_RunScenario
+
+Connect numClients fake clients and run frames frames of them playing.
+Returns the level time at the end.
+================
+*/
+static int GH_RunScenario(float size, int numClients, int builders,
+			  int frames, int fps, int cmdMsec)
+{
+	double start;
+	int i, j, levelTime, frameMsec = 1000 / fps;
+
+	maxClients = MAX(numClients, 1);
+	GH_StartGame(size, 0, 0, qfalse);
+	levelTime = 300;
+
+	for (i = 0; i < numClients; i++) {
+		GH_ConnectClient(i, builders);
+		clients[i].cmdTime = levelTime;
+	}
+
+	frameTimes = malloc(frames * sizeof(*frameTimes));
+	traces = pointContents = entitiesInBox = 0;
+	for (i = 0; i < maxClients; i++)
+		clients[i].commands = clients[i].commandBytes = 0;
+
+	for (i = 0; i < frames; i++) {
+		start = GH_Microseconds();
+		levelTime += frameMsec;
+
+		for (j = 0; j < maxClients; j++) {
+			if (!clients[j].active)
+				continue;
+
+			while (clients[j].cmdTime + cmdMsec <= levelTime) {
+				clients[j].cmdTime += cmdMsec;
+				GH_NextCommand(&clients[j], clients[j].cmdTime);
+				gameMain(GAME_CLIENT_THINK, j, 0, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0);
+			}
+
+			if (clients[j].active)
+				GH_ScenarioCommands(j, i, fps, levelTime);
+		}
+
+		GH_RunScript(i);
+
+		gameMain(GAME_RUN_FRAME, levelTime, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			 0, 0);
+		GH_ExecuteConsoleBuffer();
+
+		frameTimes[i] = GH_Microseconds() - start;
+	}
+
+	return levelTime;
+}
+
+/*
+=============================================================================
+
+REPLAY
+
+=============================================================================
+*/
+
+/*
+================
+GH_ReplayArgs
+
+Set up the arguments trap_Argc and trap_Argv return
+================
+*/
+static void GH_ReplayArgs(void)
+{
+	char *out = cmdTokenized;
+	int i, argc = GH_ReplayVarint();
+
+	cmdArgc = 0;
+
+	for (i = 0; i < argc; i++) {
+		if (i >= GH_MAX_ARGS || out >= cmdTokenized +
+		    sizeof(cmdTokenized) - 1) {
+			GH_ReplayString(NULL, 0);
+			continue;
+		}
+
+		cmdArgv[cmdArgc++] = out;
+		GH_ReplayString(out, cmdTokenized + sizeof(cmdTokenized) - out);
+		out += strlen(out) + 1;
+	}
+}
+
+/*
+================
+GH_Replay
+
+Feed a g_cmdRecord recording back through vmMain in the order it was
+recorded.  Console commands the game sends itself are dropped, since the
+ones that reached the game were recorded along with everything else.
+Returns the number of frames run.
+================
+*/
+static int GH_Replay(const char *path, float size)
+{
+	char map[MAX_QPATH];
+	const char *reason;
+	double start;
+	int type, clientNum, firstTime, levelTime, randomSeed, restart;
+	int frames = 0, maxFrames = 0;
+	qboolean done = qfalse;
+
+	GH_LoadReplay(path);
+	GH_ReplayByte();	// CR_INIT
+
+	levelTime = GH_ReplayVarint();
+	randomSeed = GH_ReplayVarint();
+	restart = GH_ReplayVarint();
+	maxClients = GH_ReplayVarint();
+	if (maxClients < 1 || maxClients > MAX_CLIENTS)
+		Com_Error(ERR_FATAL, "%s has %d client slots", path, maxClients);
+	GH_ReplayString(map, sizeof(map));
+
+	printf("gamehost: replaying %s, recorded on %s with %d slots\n", path,
+	       map, maxClients);
+
+	replaying = qtrue;
+	GH_StartGame(size, levelTime, randomSeed, restart);
+	replayStartTime = replayEndTime = levelTime;
+	traces = pointContents = entitiesInBox = 0;
+
+	start = GH_Microseconds();
+
+	while (!done && replayOffset < replayLength) {
+		type = GH_ReplayByte();
+
+		switch (type) {
+		case CR_FRAME:
+			levelTime += GH_ReplayVarint();
+			gameMain(GAME_RUN_FRAME, levelTime, 0, 0, 0, 0, 0, 0, 0,
+				 0, 0, 0, 0);
+			GH_ExecuteConsoleBuffer();
+
+			if (frames == maxFrames) {
+				maxFrames = maxFrames ? maxFrames * 2 : 1024;
+				frameTimes = realloc(frameTimes, maxFrames *
+						     sizeof(*frameTimes));
+			}
+			frameTimes[frames++] = GH_Microseconds() - start;
+			start = GH_Microseconds();
+			replayEndTime = levelTime;
+			break;
+
+		case CR_CONNECT:
+			clientNum = GH_ReplayClient();
+			firstTime = GH_ReplayVarint();
+			GH_ReplayString(clients[clientNum].userinfo,
+					sizeof(clients[0].userinfo));
+			memset(&clients[clientNum].cmd, 0,
+			       sizeof(clients[0].cmd));
+
+			reason = (const char *)gameMain(GAME_CLIENT_CONNECT,
+							clientNum, firstTime, 0,
+							0, 0, 0, 0, 0, 0, 0, 0,
+							0);
+			clients[clientNum].active = !reason;
+			break;
+
+		case CR_BEGIN:
+			clientNum = GH_ReplayClient();
+			if (clients[clientNum].active)
+				gameMain(GAME_CLIENT_BEGIN, clientNum, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0);
+			break;
+
+		case CR_USERINFO:
+			clientNum = GH_ReplayClient();
+			GH_ReplayString(clients[clientNum].userinfo,
+					sizeof(clients[0].userinfo));
+			if (clients[clientNum].active)
+				gameMain(GAME_CLIENT_USERINFO_CHANGED,
+					 clientNum, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+					 0, 0);
+			break;
+
+		case CR_DISCONNECT:
+			// already gone if the game dropped it during replay
+			clientNum = GH_ReplayClient();
+			if (clients[clientNum].active)
+				GH_DropClient(clientNum, "disconnected");
+			break;
+
+		case CR_THINK:
+			clientNum = GH_ReplayClient();
+			GH_ReplayThink(&clients[clientNum].cmd);
+			if (clients[clientNum].active)
+				gameMain(GAME_CLIENT_THINK, clientNum, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0);
+			break;
+
+		case CR_COMMAND:
+			clientNum = GH_ReplayClient();
+			GH_ReplayArgs();
+			if (clients[clientNum].active && cmdArgc)
+				gameMain(GAME_CLIENT_COMMAND, clientNum, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0, 0);
+			break;
+
+		case CR_CONSOLE:
+			GH_ReplayArgs();
+			if (cmdArgc)
+				gameMain(GAME_CONSOLE_COMMAND, 0, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0);
+			break;
+
+		case CR_SHUTDOWN:
+			done = qtrue;
+			break;
+
+		default:
+			Com_Error(ERR_FATAL, "bad record type %d at offset %d",
+				  type, replayOffset - 1);
+		}
+	}
+
+	free(replayData);
+
+	return frames;
+}
+
+/*
+================
+GH_CompareTimes
+================
+*/
+static int GH_CompareTimes(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+================
+GH_Report
+================
+*/
+static void GH_Report(int frames, int playMsec)
+{
+	playerState_t *ps;
+	double total;
+	int i, slowest, connected, alive, entities, commands, commandBytes;
+
+	connected = alive = commands = commandBytes = 0;
+	for (i = 0; i < maxClients; i++) {
+		if (!clients[i].active)
+			continue;
+
+		connected++;
+		ps = GH_PlayerState(i);
+		if (ps->pm_type == PM_NORMAL || ps->pm_type == PM_JETPACK ||
+		    ps->pm_type == PM_GRABBED)
+			alive++;
+
+		commands += clients[i].commands;
+		commandBytes += clients[i].commandBytes;
+	}
+
+	entities = 0;
+	for (i = 0; i < numGameEntities; i++) {
+		if (GH_Entity(i)->r.linked)
+			entities++;
+	}
+
+	total = 0.0;
+	for (i = 0; i < frames; i++)
+		total += frameTimes[i];
+
+	printf("gamehost: %d clients, %d frames (%.1f seconds of play) in "
+	       "%.2f seconds\n", connected, frames, playMsec / 1000.0,
+	       total / 1000000.0);
+
+	if (!frames)
+		return;
+
+	slowest = 0;
+	for (i = 1; i < frames; i++) {
+		if (frameTimes[i] > frameTimes[slowest])
+			slowest = i;
+	}
+	printf("gamehost: slowest frame %d took %.3f msec\n", slowest,
+	       frameTimes[slowest] / 1000.0);
+
+	qsort(frameTimes, frames, sizeof(*frameTimes), GH_CompareTimes);
+	printf("gamehost: frame msec: mean %.3f, p50 %.3f, p90 %.3f, "
+	       "p99 %.3f, p99.9 %.3f\n", total / frames / 1000.0,
+	       frameTimes[frames / 2] / 1000.0,
+	       frameTimes[frames * 90 / 100] / 1000.0,
+	       frameTimes[frames * 99 / 100] / 1000.0,
+	       frameTimes[frames * 999 / 1000] / 1000.0);
+	printf("gamehost: per frame: %.1f traces, %.1f pointcontents, "
+	       "%.1f entities in box, %.1f server commands (%.0f bytes)\n",
+	       (double)traces / frames, (double)pointContents / frames,
+	       (double)entitiesInBox / frames, (double)commands / frames,
+	       (double)commandBytes / frames);
+	printf("gamehost: %d clients alive at the end, %d linked entities\n",
+	       alive, entities);
+}
+
+/*
+================
+GH_Usage
+================
+*/
+static void GH_Usage(void)
+{
+	printf("usage: gamehost [options] <game.so>\n"
+	       "  -clients <n>    fake clients, alternating aliens and humans "
+	       "(16)\n"
+	       "  -frames <n>     server frames to run (1200)\n"
+	       "  -fps <n>        server frames per second (20)\n"
+	       "  -cmdmsec <n>    msec between each client's usercmds (8)\n"
+	       "  -builders <n>   builders on each team (0)\n"
+	       "  -seed <n>       seed for the usercmd streams (1)\n"
+	       "  -size <n>       half the width of the room (1024)\n"
+	       "  -fs <dir>       read files from dir\n"
+	       "  -save <dir>     save the files the game writes to dir\n"
+	       "  -script <file>  lines of <frame> <client|all|aliens|humans|"
+	       "server> <command>\n"
+	       "  -replay <file>  play back a g_cmdRecord recording instead\n"
+	       "  -set <cvar> <value>\n"
+	       "  -quiet          hide game output\n");
+	exit(1);
+}
+
+/*
+================
+main
+================
+*/
+int main(int argc, char **argv)
+{
+	void *library;
+	dllEntry_t dllEntry;
+	int i, numClients = 16, frames = 1200, fps = 20, cmdMsec = 8;
+	int builders = 0, size = 1024, playMsec;
+	const char *gamePath = NULL, *replayPath = NULL;
+
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	GH_CvarSet("g_warmup", "0");
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-quiet"))
+			quiet = qtrue;
+		else if (!strcmp(argv[i], "-set") && i + 2 < argc) {
+			GH_CvarSet(argv[i + 1], argv[i + 2]);
+			i += 2;
+		} else if (argv[i][0] == '-' && i + 1 < argc) {
+			if (!strcmp(argv[i], "-clients"))
+				numClients = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-frames"))
+				frames = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-fps"))
+				fps = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-cmdmsec"))
+				cmdMsec = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-builders"))
+				builders = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-seed"))
+				seed = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-size"))
+				size = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "-fs"))
+				fsBasePath = argv[++i];
+			else if (!strcmp(argv[i], "-save"))
+				fsSavePath = argv[++i];
+			else if (!strcmp(argv[i], "-script"))
+				GH_LoadScript(argv[++i]);
+			else if (!strcmp(argv[i], "-replay"))
+				replayPath = argv[++i];
+			else
+				GH_Usage();
+		} else if (argv[i][0] != '-' && !gamePath)
+			gamePath = argv[i];
+		else
+			GH_Usage();
+	}
+
+	if (!gamePath || numClients < 0 || numClients > MAX_CLIENTS ||
+	    frames < 1 || fps < 1 || fps > 1000 || cmdMsec < 1 ||
+	    size < 256 || size > 32768)
+		GH_Usage();
+
+	if (!(library = dlopen(gamePath, RTLD_NOW | RTLD_LOCAL)))
+		Com_Error(ERR_FATAL, "%s", dlerror());
+
+	dllEntry = (dllEntry_t) dlsym(library, "dllEntry");
+	gameMain = (vmMain_t) dlsym(library, "vmMain");
+	if (!dllEntry || !gameMain)
+		Com_Error(ERR_FATAL, "%s is not a game module", gamePath);
+
+	dllEntry(GH_Syscall);
+	GH_CvarSet("sv_fps", va("%d", fps));
+
+	if (replayPath) {
+		frames = GH_Replay(replayPath, size);
+		playMsec = replayEndTime - replayStartTime;
+	} else
+		playMsec = GH_RunScenario(size, numClients, builders, frames,
+					  fps, cmdMsec) - 300;
+
+	GH_Report(frames, playMsec);
+
+	gameMain(GAME_SHUTDOWN, qfalse, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	free(frameTimes);
+
+	return 0;
+}
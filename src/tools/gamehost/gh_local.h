@@ -0,0 +1,67 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// gh_local.h -- the parts shared by gamehost and pmovebench
+
+#define GH_MAX_BRUSHES        32
+#define GH_MAX_BRUSH_PLANES   8
+#define GH_SURFACE_CLIP_EPSILON 0.125f
+
+// a convex brush, with the axial planes of its bounds always among its
+// planes so that box traces against it stop where the engine's would
+typedef struct {
+	cplane_t planes[GH_MAX_BRUSH_PLANES];
+	int numPlanes;
+	int contents;
+	int surfaceFlags;
+} ghBrush_t;
+
+//
+// gh_world.c
+//
+extern ghBrush_t worldBrushes[GH_MAX_BRUSHES];
+extern int numWorldBrushes;
+
+void GH_BoxBrush(ghBrush_t * brush, const vec3_t mins, const vec3_t maxs,
+		 int contents, int surfaceFlags);
+void GH_BuildWorld(float size);
+void GH_ClipToBrush(trace_t * trace, const vec3_t start, const vec3_t end,
+		    const vec3_t mins, const vec3_t maxs,
+		    const ghBrush_t * brush, int entityNum);
+void GH_WorldTrace(trace_t * trace, const vec3_t start, const vec3_t mins,
+		   const vec3_t maxs, const vec3_t end, int contentMask);
+int GH_WorldContents(const vec3_t point);
+
+//
+// gh_replay.c
+//
+extern byte *replayData;
+extern int replayLength, replayOffset;
+
+void GH_LoadReplay(const char *path);
+int GH_ReplayByte(void);
+unsigned int GH_ReplayVarint(void);
+int GH_ReplaySigned(void);
+void GH_ReplayString(char *buffer, int size);
+void GH_ReplayThink(usercmd_t * cmd);
+int GH_ReplayClient(void);
@@ -0,0 +1,184 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// gh_replay.c -- reading g_cmdRecord recordings, see g_public.h
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "q_shared.h"
+#include "g_public.h"
+#include "gh_local.h"
+
+byte *replayData;
+int replayLength, replayOffset;
+
+/*
+================
+GH_LoadReplay
+
+Read a whole recording and check its header, leaving replayOffset at its
+CR_INIT
+================
+*/
+void GH_LoadReplay(const char *path)
+{
+	FILE *f;
+
+	if (!(f = fopen(path, "rb")))
+		Com_Error(ERR_FATAL, "couldn't open recording %s", path);
+
+	fseek(f, 0, SEEK_END);
+	replayLength = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	replayData = malloc(replayLength);
+	replayLength = fread(replayData, 1, replayLength, f);
+	fclose(f);
+
+	if (replayLength < 5 || replayData[0] != (CMDRECORD_IDENT & 0xFF) ||
+	    replayData[1] != ((CMDRECORD_IDENT >> 8) & 0xFF) ||
+	    replayData[2] != ((CMDRECORD_IDENT >> 16) & 0xFF) ||
+	    replayData[3] != ((CMDRECORD_IDENT >> 24) & 0xFF))
+		Com_Error(ERR_FATAL, "%s is not a usercmd recording", path);
+
+	replayOffset = 4;
+	if (GH_ReplayVarint() != CMDRECORD_VERSION)
+		Com_Error(ERR_FATAL, "%s is a different version", path);
+
+	if (replayOffset >= replayLength || replayData[replayOffset] != CR_INIT)
+		Com_Error(ERR_FATAL, "%s doesn't start with CR_INIT", path);
+}
+
+/*
+================
+GH_ReplayByte
+================
+*/
+int GH_ReplayByte(void)
+{
+	if (replayOffset >= replayLength)
+		Com_Error(ERR_FATAL, "recording is truncated");
+
+	return replayData[replayOffset++];
+}
+
+/*
+================
+GH_ReplayVarint
+================
+*/
+unsigned int GH_ReplayVarint(void)
+{
+	unsigned int value = 0;
+	int shift = 0, b;
+
+	do {
+		b = GH_ReplayByte();
+		if (shift < 32)
+			value |= (unsigned int)(b & 0x7F) << shift;
+		shift += 7;
+	} while (b & 0x80);
+
+	return value;
+}
+
+/*
+================
+GH_ReplaySigned
+================
+*/
+int GH_ReplaySigned(void)
+{
+	unsigned int value = GH_ReplayVarint();
+
+	if (value & 1)
+		return ~(int)(value >> 1);
+
+	return (int)(value >> 1);
+}
+
+/*
+================
+GH_ReplayString
+================
+*/
+void GH_ReplayString(char *buffer, int size)
+{
+	int i, length = GH_ReplayVarint();
+
+	for (i = 0; i < length; i++) {
+		if (i < size - 1)
+			buffer[i] = GH_ReplayByte();
+		else
+			GH_ReplayByte();
+	}
+
+	if (size > 0)
+		buffer[MIN(length, size - 1)] = '\0';
+}
+
+/*
+================
+GH_ReplayThink
+
+Apply the changes in a CR_THINK to the client's last usercmd
+================
+*/
+void GH_ReplayThink(usercmd_t * cmd)
+{
+	int flags = GH_ReplayVarint();
+
+	if (flags & CRF_SERVERTIME)
+		cmd->serverTime += GH_ReplaySigned();
+	if (flags & CRF_ANGLE0)
+		cmd->angles[0] += GH_ReplaySigned();
+	if (flags & CRF_ANGLE1)
+		cmd->angles[1] += GH_ReplaySigned();
+	if (flags & CRF_ANGLE2)
+		cmd->angles[2] += GH_ReplaySigned();
+	if (flags & CRF_BUTTONS)
+		cmd->buttons += GH_ReplaySigned();
+	if (flags & CRF_WEAPON)
+		cmd->weapon += GH_ReplaySigned();
+	if (flags & CRF_FORWARDMOVE)
+		cmd->forwardmove += GH_ReplaySigned();
+	if (flags & CRF_RIGHTMOVE)
+		cmd->rightmove += GH_ReplaySigned();
+	if (flags & CRF_UPMOVE)
+		cmd->upmove += GH_ReplaySigned();
+}
+
+/*
+================
+GH_ReplayClient
+================
+*/
+int GH_ReplayClient(void)
+{
+	int clientNum = GH_ReplayVarint();
+
+	if (clientNum >= MAX_CLIENTS)
+		Com_Error(ERR_FATAL, "bad client %d in recording", clientNum);
+
+	return clientNum;
+}
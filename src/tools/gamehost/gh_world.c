@@ -0,0 +1,313 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// gh_world.c -- the synthetic collision world gamehost and pmovebench use
+//
+// The world is a closed room of convex brushes: crates of step and wall
+// height, a walkable ramp and one too steep to walk up, and a ladder.  Box
+// traces are clipped against the brushes the same way the engine clips
+// them, so Pmove sees the same fractions, planes and surface flags it
+// would on a map built of the same brushes.
+
+#include <string.h>
+#include <math.h>
+
+#include "q_shared.h"
+#include "bg_public.h"
+#include "gh_local.h"
+
+ghBrush_t worldBrushes[GH_MAX_BRUSHES];
+int numWorldBrushes;
+
+/*
+================
+GH_SetPlane
+================
+*/
+static void GH_SetPlane(cplane_t * plane, float x, float y, float z,
+			float dist)
+{
+	VectorSet(plane->normal, x, y, z);
+	plane->dist = dist;
+
+	if (fabs(x) == 1.0f)
+		plane->type = PLANE_X;
+	else if (fabs(y) == 1.0f)
+		plane->type = PLANE_Y;
+	else if (fabs(z) == 1.0f)
+		plane->type = PLANE_Z;
+	else
+		plane->type = PLANE_NON_AXIAL;
+
+	SetPlaneSignbits(plane);
+}
+
+/*
+================
+GH_BoxBrush
+================
+*/
+void GH_BoxBrush(ghBrush_t * brush, const vec3_t mins, const vec3_t maxs,
+		 int contents, int surfaceFlags)
+{
+	vec3_t normal;
+	int i;
+
+	brush->numPlanes = 0;
+	for (i = 0; i < 3; i++) {
+		VectorClear(normal);
+		normal[i] = 1.0f;
+		GH_SetPlane(&brush->planes[brush->numPlanes++], normal[0],
+			    normal[1], normal[2], maxs[i]);
+		normal[i] = -1.0f;
+		GH_SetPlane(&brush->planes[brush->numPlanes++], normal[0],
+			    normal[1], normal[2], -mins[i]);
+	}
+
+	brush->contents = contents;
+	brush->surfaceFlags = surfaceFlags;
+}
+
+/*
+================
+GH_AddWorldBox
+================
+*/
+static ghBrush_t *GH_AddWorldBox(float x0, float y0, float z0, float x1,
+				 float y1, float z1, int surfaceFlags)
+{
+	ghBrush_t *brush;
+	vec3_t mins, maxs;
+
+	if (numWorldBrushes == GH_MAX_BRUSHES)
+		return NULL;
+
+	brush = &worldBrushes[numWorldBrushes++];
+	VectorSet(mins, x0, y0, z0);
+	VectorSet(maxs, x1, y1, z1);
+	GH_BoxBrush(brush, mins, maxs, CONTENTS_SOLID, surfaceFlags);
+
+	return brush;
+}
+
+/*
+================
+GH_AddWorldRamp
+
+A wedge filling the box from x0 to x1, rising from z0 at x0 to z1 at x1
+================
+*/
+static void GH_AddWorldRamp(float x0, float y0, float z0, float x1, float y1,
+			    float z1)
+{
+	ghBrush_t *brush;
+	vec3_t normal;
+
+	if (!(brush = GH_AddWorldBox(x0, y0, z0, x1, y1, z1, 0)))
+		return;
+
+	VectorSet(normal, -(z1 - z0), 0.0f, x1 - x0);
+	VectorNormalize(normal);
+	GH_SetPlane(&brush->planes[brush->numPlanes++], normal[0], normal[1],
+		    normal[2], normal[0] * x0 + normal[2] * z0);
+}
+
+/*
+================
+GH_BuildWorld
+
+A closed room size units either side of the origin and size high, with a
+ring of crates alternating between step height and wall height, two ramps
+against the +y wall and a ladder up the -y wall
+================
+*/
+void GH_BuildWorld(float size)
+{
+	float s = size + 64.0f;
+	float x, y, angle;
+	int i;
+
+	numWorldBrushes = 0;
+
+	GH_AddWorldBox(-s, -s, -64.0f, s, s, 0.0f, 0);
+	GH_AddWorldBox(-s, -s, size, s, s, size + 64.0f, 0);
+	GH_AddWorldBox(-s, -s, 0.0f, -size, s, size, 0);
+	GH_AddWorldBox(size, -s, 0.0f, s, s, size, 0);
+	GH_AddWorldBox(-size, -s, 0.0f, size, -size, size, 0);
+	GH_AddWorldBox(-size, size, 0.0f, size, s, size, 0);
+
+	for (i = 0; i < 8; i++) {
+		angle = i * M_PI / 4.0f;
+		x = cos(angle) * size * 0.4f;
+		y = sin(angle) * size * 0.4f;
+		GH_AddWorldBox(x - 64.0f, y - 64.0f, 0.0f, x + 64.0f, y + 64.0f,
+			       (i & 1) ? 96.0f : 16.0f, 0);
+	}
+
+	// about 27 degrees, then about 56, steeper than MIN_WALK_NORMAL
+	GH_AddWorldRamp(-448.0f, size - 256.0f, 0.0f, -192.0f, size, 128.0f);
+	GH_AddWorldRamp(192.0f, size - 256.0f, 0.0f, 320.0f, size, 192.0f);
+
+	GH_AddWorldBox(-64.0f, -size, 0.0f, 64.0f, 16.0f - size, size - 64.0f,
+		       SURF_LADDER);
+}
+
+/*
+================
+GH_ClipToBrush
+
+Clip a swept box against a brush the same way the engine's
+CM_TraceThroughBrush does, so that traces stop the same epsilon short
+================
+*/
+void GH_ClipToBrush(trace_t * trace, const vec3_t start, const vec3_t end,
+		    const vec3_t mins, const vec3_t maxs,
+		    const ghBrush_t * brush, int entityNum)
+{
+	const cplane_t *plane, *clipPlane = NULL;
+	float enterFrac = -1.0f, leaveFrac = 1.0f;
+	float d1, d2, f, dist;
+	qboolean startOut = qfalse, getOut = qfalse;
+	vec3_t offset;
+	int i, j;
+
+	for (i = 0; i < brush->numPlanes; i++) {
+		plane = &brush->planes[i];
+
+		// push the plane out by the corner of the box nearest it
+		for (j = 0; j < 3; j++)
+			offset[j] = (plane->signbits & (1 << j)) ? maxs[j] :
+			    mins[j];
+		dist = plane->dist - DotProduct(offset, plane->normal);
+
+		d1 = DotProduct(start, plane->normal) - dist;
+		d2 = DotProduct(end, plane->normal) - dist;
+
+		if (d2 > 0.0f)
+			getOut = qtrue;
+		if (d1 > 0.0f)
+			startOut = qtrue;
+
+		// completely in front of this face
+		if (d1 > 0.0f && (d2 >= GH_SURFACE_CLIP_EPSILON || d2 >= d1))
+			return;
+
+		if (d1 <= 0.0f && d2 <= 0.0f)
+			continue;
+
+		if (d1 > d2) {
+			f = (d1 - GH_SURFACE_CLIP_EPSILON) / (d1 - d2);
+			if (f < 0.0f)
+				f = 0.0f;
+			if (f > enterFrac) {
+				enterFrac = f;
+				clipPlane = plane;
+			}
+		} else {
+			f = (d1 + GH_SURFACE_CLIP_EPSILON) / (d1 - d2);
+			if (f > 1.0f)
+				f = 1.0f;
+			if (f < leaveFrac)
+				leaveFrac = f;
+		}
+	}
+
+	if (!startOut) {
+		trace->startsolid = qtrue;
+		if (!getOut) {
+			trace->allsolid = qtrue;
+			trace->fraction = 0.0f;
+			trace->contents = brush->contents;
+			trace->entityNum = entityNum;
+		}
+		return;
+	}
+
+	if (enterFrac < leaveFrac && enterFrac > -1.0f &&
+	    enterFrac < trace->fraction && clipPlane) {
+		trace->fraction = enterFrac;
+		trace->plane = *clipPlane;
+		trace->surfaceFlags = brush->surfaceFlags;
+		trace->contents = brush->contents;
+		trace->entityNum = entityNum;
+	}
+}
+
+/*
+================
+GH_WorldTrace
+
+Trace against the world alone, endpos included
+================
+*/
+void GH_WorldTrace(trace_t * trace, const vec3_t start, const vec3_t mins,
+		   const vec3_t maxs, const vec3_t end, int contentMask)
+{
+	int i;
+
+	if (!mins)
+		mins = vec3_origin;
+	if (!maxs)
+		maxs = vec3_origin;
+
+	memset(trace, 0, sizeof(*trace));
+	trace->fraction = 1.0f;
+	trace->entityNum = ENTITYNUM_NONE;
+
+	if (contentMask & CONTENTS_SOLID) {
+		for (i = 0; i < numWorldBrushes; i++) {
+			GH_ClipToBrush(trace, start, end, mins, maxs,
+				       &worldBrushes[i], ENTITYNUM_WORLD);
+		}
+	}
+
+	for (i = 0; i < 3; i++)
+		trace->endpos[i] = start[i] + trace->fraction *
+		    (end[i] - start[i]);
+}
+
+/*
+================
+GH_WorldContents
+================
+*/
+int GH_WorldContents(const vec3_t point)
+{
+	const ghBrush_t *brush;
+	int i, j, contents = 0;
+
+	for (i = 0; i < numWorldBrushes; i++) {
+		brush = &worldBrushes[i];
+
+		for (j = 0; j < brush->numPlanes; j++) {
+			if (DotProduct(point, brush->planes[j].normal) >
+			    brush->planes[j].dist)
+				break;
+		}
+
+		if (j == brush->numPlanes)
+			contents |= brush->contents;
+	}
+
+	return contents;
+}
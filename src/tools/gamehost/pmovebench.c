@@ -0,0 +1,774 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// pmovebench.c -- timing and determinism harness for Pmove
+//
+// pmovebench is linked with the bg_pmove, bg_slidemove and bg_misc objects
+// built for game.so, and runs Pmove with gamehost's brush world (gh_world.c)
+// answering its traces and pointcontents.  Every class replays the same
+// usercmd streams: each client's from a g_cmdRecord recording, or streams
+// generated from a seed.  Each stream starts a freshly spawned player at
+// one of a few points in the room: the middle, the foot of each ramp and
+// the ladder.
+//
+// It reports ns per Pmove and traces per move for each class, and hashes
+// the playerState after every move.  -write saves the hash of every class
+// and stream as a reference, and -check fails if a build moves any of them
+// differently from the reference.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <math.h>
+
+#include "q_shared.h"
+#include "bg_public.h"
+#include "g_public.h"
+#include "gh_local.h"
+
+#define PB_DEFAULT_MOVES   10000
+#define PB_DEFAULT_STREAMS 4
+#define PB_GRAVITY         800
+#define PB_SPEED           320
+#define PB_PMOVE_MSEC      8
+#define PB_NUM_STARTS      4
+
+typedef struct {
+	usercmd_t *cmds;
+	int numCmds;
+	int maxCmds;
+} pbStream_t;
+
+static pbStream_t *streams;
+static int numStreams, maxStreams;
+
+static vec3_t starts[PB_NUM_STARTS];
+
+static int traces, pointContents, cacheHits;
+static unsigned int seed = 1;
+static struct timespec startTime;
+
+/*
+================
+Com_Error
+
+For q_shared.c and bg_misc.c
+================
+*/
+void QDECL Com_Error(int level, const char *error, ...)
+{
+	va_list argptr;
+
+	va_start(argptr, error);
+	fprintf(stderr, "pmovebench: error: ");
+	vfprintf(stderr, error, argptr);
+	fprintf(stderr, "\n");
+	va_end(argptr);
+
+	exit(1);
+}
+
+/*
+================
+Com_Printf
+
+For q_shared.c and bg_misc.c
+================
+*/
+void QDECL Com_Printf(const char *msg, ...)
+{
+	va_list argptr;
+
+	va_start(argptr, msg);
+	vprintf(msg, argptr);
+	va_end(argptr);
+}
+
+/*
+=============================================================================
+
+SYSCALLS
+
+bg_misc.c only touches the filesystem for overrides, which pmovebench
+doesn't load, so every class moves with its built in attributes
+
+=============================================================================
+*/
+
+int trap_FS_FOpenFile(const char *qpath, fileHandle_t * f, fsMode_t mode)
+{
+	*f = 0;
+	return -1;
+}
+
+void trap_FS_Read(void *buffer, int len, fileHandle_t f)
+{
+}
+
+void trap_FS_Write(const void *buffer, int len, fileHandle_t f)
+{
+}
+
+void trap_FS_FCloseFile(fileHandle_t f)
+{
+}
+
+int trap_FS_GetFileList(const char *path, const char *extension,
+			char *listbuf, int bufsize)
+{
+	return 0;
+}
+
+void trap_Cvar_VariableStringBuffer(const char *var_name, char *buffer,
+				    int bufsize)
+{
+	if (bufsize > 0)
+		buffer[0] = '\0';
+}
+
+void trap_SnapVector(float *v)
+{
+	int i;
+
+	for (i = 0; i < 3; i++)
+		v[i] = rint(v[i]);
+}
+
+/*
+================
+PB_Microseconds
+================
+*/
+static double PB_Microseconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - startTime.tv_sec) * 1000000.0 +
+	    (now.tv_nsec - startTime.tv_nsec) / 1000.0;
+}
+
+/*
+================
+PB_Random
+
+Same sequence on every platform, unlike rand()
+================
+*/
+static int PB_Random(int range)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return (int)((seed >> 16) % (unsigned int)range);
+}
+
+/*
+================
+PB_Hash
+================
+*/
+static unsigned int PB_Hash(unsigned int hash, const void *data, int length)
+{
+	const byte *p = (const byte *)data;
+	int i;
+
+	for (i = 0; i < length; i++)
+		hash = (hash ^ p[i]) * 16777619U;
+
+	return hash;
+}
+
+/*
+================
+PB_Trace
+================
+*/
+static void PB_Trace(trace_t * results, const vec3_t start,
+		     const vec3_t mins, const vec3_t maxs, const vec3_t end,
+		     int passEntityNum, int contentMask)
+{
+	traces++;
+	GH_WorldTrace(results, start, mins, maxs, end, contentMask);
+}
+
+/*
+================
+PB_PointContents
+================
+*/
+static int PB_PointContents(const vec3_t point, int passEntityNum)
+{
+	pointContents++;
+	return GH_WorldContents(point);
+}
+
+/*
+=============================================================================
+
+USERCMD STREAMS
+
+=============================================================================
+*/
+
+/*
+================
+PB_NewStream
+================
+*/
+static pbStream_t *PB_NewStream(void)
+{
+	if (numStreams == maxStreams) {
+		maxStreams = maxStreams ? maxStreams * 2 : 64;
+		streams = realloc(streams, maxStreams * sizeof(*streams));
+	}
+
+	memset(&streams[numStreams], 0, sizeof(streams[0]));
+
+	return &streams[numStreams++];
+}
+
+/*
+================
+PB_AddCmd
+================
+*/
+static void PB_AddCmd(pbStream_t * stream, const usercmd_t * cmd)
+{
+	if (stream->numCmds == stream->maxCmds) {
+		stream->maxCmds = stream->maxCmds ? stream->maxCmds * 2 : 1024;
+		stream->cmds = realloc(stream->cmds, stream->maxCmds *
+				       sizeof(*stream->cmds));
+	}
+
+	stream->cmds[stream->numCmds++] = *cmd;
+}
+
+/*
+================
+PB_GenerateStream
+
+Movement keys, jumping, crouching and attacks change every quarter to one
+second of play, while the view keeps turning so the player ends up
+running into walls and up slopes
+================
+*/
+static void PB_GenerateStream(int moves)
+{
+	static const signed char keys[3] = { -127, 0, 127 };
+	pbStream_t *stream = PB_NewStream();
+	usercmd_t cmd;
+	int i, nextChange = 0, turn = 0;
+
+	memset(&cmd, 0, sizeof(cmd));
+
+	for (i = 0; i < moves; i++) {
+		cmd.serverTime += 8 + PB_Random(9);
+
+		if (cmd.serverTime >= nextChange) {
+			nextChange = cmd.serverTime + 250 + PB_Random(750);
+
+			cmd.forwardmove = keys[PB_Random(3)];
+			cmd.rightmove = keys[PB_Random(3)];
+
+			switch (PB_Random(4)) {
+			case 0:
+				cmd.upmove = 127;
+				break;
+			case 1:
+				cmd.upmove = -127;
+				break;
+			default:
+				cmd.upmove = 0;
+				break;
+			}
+
+			cmd.buttons = 0;
+			if (!PB_Random(3))
+				cmd.buttons |= BUTTON_ATTACK;
+			if (!PB_Random(6))
+				cmd.buttons |= BUTTON_ATTACK2;
+
+			turn = PB_Random(1024) - 512;
+			cmd.angles[PITCH] = ANGLE2SHORT(PB_Random(120) - 60);
+		}
+
+		cmd.angles[YAW] = (cmd.angles[YAW] + turn) & 65535;
+		PB_AddCmd(stream, &cmd);
+	}
+}
+
+/*
+================
+PB_SkipArgs
+================
+*/
+static void PB_SkipArgs(void)
+{
+	int i, argc = GH_ReplayVarint();
+
+	for (i = 0; i < argc; i++)
+		GH_ReplayString(NULL, 0);
+}
+
+/*
+================
+PB_LoadStreams
+
+Make a stream of each client's usercmds in a recording, starting a new one
+whenever a client connects
+================
+*/
+static void PB_LoadStreams(const char *path)
+{
+	usercmd_t cmds[MAX_CLIENTS];
+	int current[MAX_CLIENTS];
+	char map[MAX_QPATH];
+	int i, type, clientNum;
+	qboolean done = qfalse;
+
+	GH_LoadReplay(path);
+	GH_ReplayByte();	// CR_INIT
+	GH_ReplayVarint();
+	GH_ReplayVarint();
+	GH_ReplayVarint();
+	GH_ReplayVarint();
+	GH_ReplayString(map, sizeof(map));
+
+	memset(cmds, 0, sizeof(cmds));
+	for (i = 0; i < MAX_CLIENTS; i++)
+		current[i] = -1;
+
+	while (!done && replayOffset < replayLength) {
+		type = GH_ReplayByte();
+
+		switch (type) {
+		case CR_FRAME:
+			GH_ReplayVarint();
+			break;
+
+		case CR_CONNECT:
+			clientNum = GH_ReplayClient();
+			GH_ReplayVarint();
+			GH_ReplayString(NULL, 0);
+			memset(&cmds[clientNum], 0, sizeof(cmds[0]));
+			current[clientNum] = -1;
+			break;
+
+		case CR_BEGIN:
+			GH_ReplayClient();
+			break;
+
+		case CR_USERINFO:
+			GH_ReplayClient();
+			GH_ReplayString(NULL, 0);
+			break;
+
+		case CR_DISCONNECT:
+			current[GH_ReplayClient()] = -1;
+			break;
+
+		case CR_THINK:
+			clientNum = GH_ReplayClient();
+			GH_ReplayThink(&cmds[clientNum]);
+			if (current[clientNum] < 0) {
+				PB_NewStream();
+				current[clientNum] = numStreams - 1;
+			}
+			PB_AddCmd(&streams[current[clientNum]], &cmds[clientNum]);
+			break;
+
+		case CR_COMMAND:
+			GH_ReplayClient();
+			PB_SkipArgs();
+			break;
+
+		case CR_CONSOLE:
+			PB_SkipArgs();
+			break;
+
+		case CR_SHUTDOWN:
+			done = qtrue;
+			break;
+
+		default:
+			Com_Error(ERR_FATAL, "bad record type %d at offset %d",
+				  type, replayOffset - 1);
+		}
+	}
+
+	free(replayData);
+
+	printf("pmovebench: %d usercmd streams from %s, recorded on %s\n",
+	       numStreams, path, map);
+}
+
+/*
+=============================================================================
+
+PMOVE
+
+=============================================================================
+*/
+
+/*
+================
+PB_SpawnPlayer
+
+A freshly spawned player of pclass, attached to no entity, standing on the
+floor at origin
+================
+*/
+static void PB_SpawnPlayer(playerState_t * ps, int pclass,
+			   const vec3_t origin)
+{
+	vec3_t mins;
+	int maxAmmo, maxClips;
+	weapon_t weapon;
+
+	memset(ps, 0, sizeof(*ps));
+
+	ps->clientNum = ENTITYNUM_NONE;
+	ps->pm_type = PM_NORMAL;
+	ps->gravity = PB_GRAVITY;
+	ps->speed = PB_SPEED * BG_FindSpeedForClass(pclass);
+	ps->stats[STAT_PCLASS] = pclass;
+	ps->stats[STAT_PTEAM] = (pclass == PCL_HUMAN ||
+				 pclass == PCL_HUMAN_BSUIT) ? PTE_HUMANS :
+	    PTE_ALIENS;
+	ps->stats[STAT_HEALTH] = ps->stats[STAT_MAX_HEALTH] =
+	    BG_FindHealthForClass(pclass);
+	ps->stats[STAT_STAMINA] = MAX_STAMINA;
+	ps->stats[STAT_BUILDABLE] = BA_NONE;
+	VectorSet(ps->grapplePoint, 0.0f, 0.0f, 1.0f);
+	BG_FindViewheightForClass(pclass, &ps->viewheight, NULL);
+
+	BG_FindBBoxForClass(pclass, mins, NULL, NULL, NULL, NULL);
+	VectorCopy(origin, ps->origin);
+	ps->origin[2] = 1.0f - mins[2];
+
+	weapon = BG_FindStartWeaponForClass(pclass);
+	if (ps->stats[STAT_PTEAM] == PTE_HUMANS)
+		weapon = WP_MACHINEGUN;
+	BG_AddWeaponToInventory(weapon, ps->stats);
+	BG_FindAmmoForWeapon(weapon, &maxAmmo, &maxClips);
+	ps->weapon = weapon;
+	ps->ammo = maxAmmo;
+	ps->clips = maxClips;
+}
+
+/*
+================
+PB_Run
+
+Replay stream with a player of pclass.  The playerState after every move
+is hashed into the return value if hash is set.  The recorded weapon
+belongs to whatever the player was at the time, so the class's own weapon
+is used instead.
+================
+*/
+static unsigned int PB_Run(int pclass, int streamNum, qboolean hash)
+{
+	const pbStream_t *stream = &streams[streamNum];
+	playerState_t ps;
+	pmoveExt_t pmext;
+	pmove_t pm;
+	unsigned int h = 2166136261U;
+	int i;
+
+	PB_SpawnPlayer(&ps, pclass, starts[streamNum % PB_NUM_STARTS]);
+	memset(&pmext, 0, sizeof(pmext));
+	ps.commandTime = stream->cmds[0].serverTime - PB_PMOVE_MSEC;
+
+	for (i = 0; i < stream->numCmds; i++) {
+		memset(&pm, 0, sizeof(pm));
+		pm.ps = &ps;
+		pm.pmext = &pmext;
+		pm.cmd = stream->cmds[i];
+		pm.cmd.weapon = ps.weapon;
+		pm.tracemask = MASK_PLAYERSOLID;
+		pm.trace = PB_Trace;
+		pm.pointcontents = PB_PointContents;
+		pm.pmove_msec = PB_PMOVE_MSEC;
+
+		Pmove(&pm);
+		cacheHits += pm.traceCacheHits;
+
+		if (hash)
+			h = PB_Hash(h, &ps, sizeof(ps));
+	}
+
+	return h;
+}
+
+/*
+=============================================================================
+
+REFERENCE
+
+=============================================================================
+*/
+
+/*
+================
+PB_InputHash
+
+So that a reference is only compared against runs of the same usercmds
+================
+*/
+static unsigned int PB_InputHash(void)
+{
+	unsigned int h = 2166136261U;
+	int i;
+
+	for (i = 0; i < numStreams; i++) {
+		h = PB_Hash(h, &streams[i].numCmds, sizeof(int));
+		h = PB_Hash(h, streams[i].cmds, streams[i].numCmds *
+			    sizeof(usercmd_t));
+	}
+
+	return h;
+}
+
+/*
+================
+PB_FindReference
+
+The hash the reference has for pclass and stream, if it has one
+================
+*/
+static qboolean PB_FindReference(const char *reference, const char *class,
+				  int stream, unsigned int *hash)
+{
+	char name[MAX_QPATH];
+	const char *line;
+	int n;
+
+	for (line = reference; line; line = strchr(line, '\n')) {
+		if (*line == '\n')
+			line++;
+
+		if (sscanf(line, "%63s %d %x", name, &n, hash) == 3 &&
+		    n == stream && !Q_stricmp(name, class))
+			return qtrue;
+	}
+
+	return qfalse;
+}
+
+/*
+================
+PB_LoadReference
+================
+*/
+static char *PB_LoadReference(const char *path)
+{
+	FILE *f;
+	char *text;
+	int length;
+
+	if (!(f = fopen(path, "rb")))
+		Com_Error(ERR_FATAL, "couldn't open reference %s", path);
+
+	fseek(f, 0, SEEK_END);
+	length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	text = malloc(length + 1);
+	length = fread(text, 1, length, f);
+	text[length] = '\0';
+	fclose(f);
+
+	return text;
+}
+
+/*
+================
+PB_Usage
+================
+*/
+static void PB_Usage(void)
+{
+	printf("usage: pmovebench [options]\n"
+	       "  -replay <file>  replay each client's usercmds from a "
+	       "g_cmdRecord recording\n"
+	       "  -streams <n>    generated usercmd streams (%d)\n"
+	       "  -moves <n>      usercmds in each generated stream (%d)\n"
+	       "  -seed <n>       seed for the generated streams (1)\n"
+	       "  -class <name>   only this class\n"
+	       "  -size <n>       half the width of the room (1024)\n"
+	       "  -write <file>   save the playerState hashes as a "
+	       "reference\n"
+	       "  -check <file>   fail unless the hashes match a reference\n",
+	       PB_DEFAULT_STREAMS, PB_DEFAULT_MOVES);
+	exit(1);
+}
+
+/*
+================
+main
+================
+*/
+int main(int argc, char **argv)
+{
+	FILE *out = NULL;
+	char *reference = NULL;
+	const char *replayPath = NULL, *writePath = NULL, *checkPath = NULL;
+	const char *className = NULL, *name;
+	double start, usec;
+	unsigned int hash, expected, inputHash;
+	int i, pclass, stream, moves, runTraces, mismatches = 0;
+	int numGenerated = PB_DEFAULT_STREAMS, genMoves = PB_DEFAULT_MOVES;
+	int size = 1024;
+
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] != '-' || i + 1 >= argc)
+			PB_Usage();
+
+		if (!strcmp(argv[i], "-replay"))
+			replayPath = argv[++i];
+		else if (!strcmp(argv[i], "-streams"))
+			numGenerated = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-moves"))
+			genMoves = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-seed"))
+			seed = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-class"))
+			className = argv[++i];
+		else if (!strcmp(argv[i], "-size"))
+			size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-write"))
+			writePath = argv[++i];
+		else if (!strcmp(argv[i], "-check"))
+			checkPath = argv[++i];
+		else
+			PB_Usage();
+	}
+
+	// small enough rooms leave no space for the start points
+	if (numGenerated < 1 || genMoves < 1 || size < 768 || size > 32768)
+		PB_Usage();
+
+	if (className &&
+	    BG_FindClassNumForName((char *)className) == PCL_NONE)
+		Com_Error(ERR_FATAL, "unknown class %s", className);
+
+	GH_BuildWorld(size);
+	VectorSet(starts[0], 0.0f, 0.0f, 0.0f);
+	VectorSet(starts[1], -512.0f, size - 128.0f, 0.0f);
+	VectorSet(starts[2], 128.0f, size - 128.0f, 0.0f);
+	VectorSet(starts[3], 0.0f, 64.0f - size, 0.0f);
+
+	if (replayPath)
+		PB_LoadStreams(replayPath);
+	else {
+		for (i = 0; i < numGenerated; i++)
+			PB_GenerateStream(genMoves);
+	}
+
+	if (!numStreams)
+		Com_Error(ERR_FATAL, "no usercmds to replay");
+
+	inputHash = PB_InputHash();
+
+	if (checkPath) {
+		reference = PB_LoadReference(checkPath);
+		if (sscanf(reference, "input %x", &expected) != 1 ||
+		    expected != inputHash)
+			Com_Error(ERR_FATAL, "%s was made from different "
+				  "usercmds", checkPath);
+	}
+
+	if (writePath) {
+		if (!(out = fopen(writePath, "w")))
+			Com_Error(ERR_FATAL, "couldn't write %s", writePath);
+		fprintf(out, "input %08x\n", inputHash);
+	}
+
+	for (pclass = PCL_NONE + 1; pclass < PCL_NUM_CLASSES; pclass++) {
+		name = BG_FindNameForClassNum(pclass);
+		if (!name || (className && Q_stricmp(name, className)))
+			continue;
+
+		// time a run without hashing, then check it with a second one
+		traces = pointContents = cacheHits = 0;
+		moves = 0;
+		start = PB_Microseconds();
+		for (stream = 0; stream < numStreams; stream++) {
+			PB_Run(pclass, stream, qfalse);
+			moves += streams[stream].numCmds;
+		}
+		usec = PB_Microseconds() - start;
+
+		printf("pmovebench: %-12s %7.0f ns/move, %.2f traces/move "
+		       "(%.2f more cached), %.2f pointcontents/move\n", name,
+		       usec * 1000.0 / moves, (double)traces / moves,
+		       (double)cacheHits / moves,
+		       (double)pointContents / moves);
+
+		runTraces = traces;
+		for (stream = 0; stream < numStreams; stream++) {
+			hash = PB_Run(pclass, stream, qtrue);
+
+			if (out)
+				fprintf(out, "%s %d %08x\n", name, stream, hash);
+
+			if (!reference)
+				continue;
+
+			if (!PB_FindReference(reference, name, stream,
+					      &expected)) {
+				printf("pmovebench: %s stream %d isn't in the "
+				       "reference\n", name, stream);
+				mismatches++;
+			} else if (hash != expected) {
+				printf("pmovebench: %s stream %d moved "
+				       "differently (%08x, reference %08x)\n",
+				       name, stream, hash, expected);
+				mismatches++;
+			}
+		}
+
+		if (traces != 2 * runTraces)
+			printf("pmovebench: WARNING: %s made different numbers "
+			       "of traces on the two runs\n", name);
+	}
+
+	if (out)
+		fclose(out);
+
+	if (reference) {
+		free(reference);
+		if (mismatches) {
+			printf("pmovebench: %d streams differ from %s\n",
+			       mismatches, checkPath);
+			return 1;
+		}
+		printf("pmovebench: every stream matches %s\n", checkPath);
+	}
+
+	return 0;
+}